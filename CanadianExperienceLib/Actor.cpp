@@ -36,6 +36,17 @@ void Actor::SetRoot(std::shared_ptr<Drawable> root)
  * @param graphics The Graphics object we are drawing on
  */
 void Actor::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+{
+    RenderList list;
+    Record(list);
+    list.Replay(graphics);
+}
+
+/**
+ * Record drawing this actor into a render list
+ * @param list Render list to record into
+ */
+void Actor::Record(RenderList &list)
 {
     // Don't draw if not enabled
     if (!mEnabled)
@@ -49,7 +60,7 @@ void Actor::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 
     for (auto drawable : mDrawablesInOrder)
     {
-        drawable->Draw(graphics);
+        drawable->Record(list);
     }
 }
 
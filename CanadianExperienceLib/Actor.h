@@ -11,6 +11,7 @@
 #include "AnimChannelPoint.h"
 
 class Drawable;
+class RenderList;
 class Picture;
 
 /**
@@ -60,6 +61,7 @@ public:
 
     void SetRoot(std::shared_ptr<Drawable> root);
     void Draw(std::shared_ptr<wxGraphicsContext> graphics);
+    void Record(RenderList &list);
     std::shared_ptr<Drawable> HitTest(wxPoint pos);
     void AddDrawable(std::shared_ptr<Drawable> drawable);
 
@@ -173,6 +173,35 @@ void AnimChannel::ClearKeyframe()
         mKeyframe2--;
 }
 
+/**
+ * Get the frames a keyframe at a given frame influences.
+ *
+ * Changing a keyframe at frame changes the tween from the
+ * keyframe before it to the keyframe after it. With no
+ * keyframe on a side, the span runs to that end of the
+ * animation.
+ * @param frame Frame the keyframe is at
+ * @param first Receives the first frame influenced
+ * @param last Receives the last frame influenced, or -1 for the end of the animation
+ */
+void AnimChannel::GetKeyframeSpan(int frame, int &first, int &last) const
+{
+    first = 0;
+    last = -1;
+    for (auto keyframe : mKeyframes)
+    {
+        if (keyframe->GetFrame() < frame)
+        {
+            first = keyframe->GetFrame();
+        }
+        else if (keyframe->GetFrame() > frame)
+        {
+            last = keyframe->GetFrame();
+            break;
+        }
+    }
+}
+
 
 /** Save this item to an XML node
  * @param node The node we are going to be a child of
@@ -121,6 +121,7 @@ public:
      */
     bool IsValid() { return mKeyframe1 >= 0 || mKeyframe2 >= 0; }
     void ClearKeyframe();
+    void GetKeyframeSpan(int frame, int &first, int &last) const;
 
     virtual void Clear();
     virtual wxXmlNode* XmlSave(wxXmlNode* node);
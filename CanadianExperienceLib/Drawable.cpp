@@ -60,6 +60,34 @@ void Drawable::GetKeyframe()
 }
 
 
+/**
+ * Draw this drawable
+ *
+ * Drawables that record their drawing are recorded into a
+ * render list that is replayed right away. A drawable must
+ * override this or Record.
+ * @param graphics Graphics object to draw on
+ */
+void Drawable::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+{
+    RenderList list;
+    Record(list);
+    list.Replay(graphics);
+}
+
+/**
+ * Record drawing this drawable into a render list
+ *
+ * Drawables that draw directly are recorded as a callback
+ * to Draw.
+ * @param list Render list to record into
+ */
+void Drawable::Record(RenderList &list)
+{
+    list.AddCallback([this](std::shared_ptr<wxGraphicsContext> graphics) { Draw(graphics); });
+}
+
+
 /**
  * Place this drawable relative to its parent
  *
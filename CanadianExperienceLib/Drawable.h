@@ -9,6 +9,7 @@
 #define CANADIANEXPERIENCE_DRAWABLE_H
 
 #include "AnimChannelAngle.h"
+#include <render-list.h>
 
 class Actor;
 class Timeline;
@@ -66,10 +67,13 @@ public:
     virtual void SetActor(Actor *actor);
 
     /**
-     * Draw this drawable
-     * @param graphics Graphics object to draw on
+     * Get the actor using this drawable
+     * @return Actor pointer or nullptr if none
      */
-    virtual void Draw(std::shared_ptr<wxGraphicsContext> graphics) = 0;
+    Actor *GetActor() { return mActor; }
+
+    virtual void Draw(std::shared_ptr<wxGraphicsContext> graphics);
+    virtual void Record(RenderList &list);
 
     void Place(wxPoint offset, double rotate);
 
@@ -0,0 +1,158 @@
+/**
+ * @file FrameCache.cpp
+ * @author Thomas Toaz
+ */
+
+#include "pch.h"
+#include "FrameCache.h"
+
+/**
+ * Get the memory an image takes
+ * @param image Image to measure
+ * @return Bytes of pixel data
+ */
+static size_t ImageBytes(const wxImage &image)
+{
+    size_t pixels = (size_t)image.GetWidth() * image.GetHeight();
+    return pixels * (image.HasAlpha() ? 4 : 3);
+}
+
+/**
+ * Constructor
+ * @param budget Memory budget in bytes
+ */
+FrameCache::FrameCache(size_t budget) : mBudget(budget)
+{
+}
+
+/**
+ * Find a cached frame
+ *
+ * A found frame becomes the most recently used.
+ * @param frame Frame number
+ * @return The frame image, or an invalid image if not cached
+ */
+wxImage FrameCache::Find(int frame)
+{
+    auto found = mFrames.find(frame);
+    if (found == mFrames.end())
+    {
+        return wxImage();
+    }
+
+    mOrder.splice(mOrder.begin(), mOrder, found->second.mOrder);
+    return found->second.mImage;
+}
+
+/**
+ * Add a rendered frame to the cache
+ *
+ * The image is downscaled to the cache scale. Frames too
+ * large for the budget are not cached.
+ * @param frame Frame number
+ * @param image Full size frame image
+ */
+void FrameCache::Add(int frame, const wxImage &image)
+{
+    Remove(frame);
+
+    wxImage stored = image;
+    if (mScale < 1)
+    {
+        int width = std::max(1, (int)(image.GetWidth() * mScale));
+        int height = std::max(1, (int)(image.GetHeight() * mScale));
+        stored = image.Scale(width, height, wxIMAGE_QUALITY_BILINEAR);
+    }
+
+    auto bytes = ImageBytes(stored);
+    if (bytes > mBudget)
+    {
+        return;
+    }
+
+    mOrder.push_front(frame);
+    mFrames[frame] = Entry{stored, mOrder.begin()};
+    mMemoryUsed += bytes;
+
+    Evict();
+}
+
+/**
+ * Discard the cached frames in a range
+ * @param first First frame to discard
+ * @param last Last frame to discard
+ */
+void FrameCache::Invalidate(int first, int last)
+{
+    for (auto i = mOrder.begin(); i != mOrder.end(); )
+    {
+        int frame = *i++;
+        if (frame >= first && frame <= last)
+        {
+            Remove(frame);
+        }
+    }
+}
+
+/**
+ * Discard all cached frames
+ */
+void FrameCache::Clear()
+{
+    mFrames.clear();
+    mOrder.clear();
+    mMemoryUsed = 0;
+}
+
+/**
+ * Set the memory budget, evicting frames if needed
+ * @param budget Budget in bytes
+ */
+void FrameCache::SetBudget(size_t budget)
+{
+    mBudget = budget;
+    Evict();
+}
+
+/**
+ * Set the scale frames are stored at
+ *
+ * Frames already cached at another scale are discarded.
+ * @param scale Scale greater than 0 and at most 1
+ */
+void FrameCache::SetScale(double scale)
+{
+    if (scale != mScale)
+    {
+        mScale = scale;
+        Clear();
+    }
+}
+
+/**
+ * Remove a frame from the cache if it is there
+ * @param frame Frame number
+ */
+void FrameCache::Remove(int frame)
+{
+    auto found = mFrames.find(frame);
+    if (found == mFrames.end())
+    {
+        return;
+    }
+
+    mMemoryUsed -= ImageBytes(found->second.mImage);
+    mOrder.erase(found->second.mOrder);
+    mFrames.erase(found);
+}
+
+/**
+ * Evict least recently used frames until within the budget
+ */
+void FrameCache::Evict()
+{
+    while (mMemoryUsed > mBudget && !mOrder.empty())
+    {
+        Remove(mOrder.back());
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file FrameCache.h
+ * @author Thomas Toaz
+ *
+ * Memory-limited cache of rendered animation frames.
+ */
+
+#ifndef CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_FRAMECACHE_H
+#define CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_FRAMECACHE_H
+
+#include <list>
+#include <unordered_map>
+
+/**
+ * Memory-limited cache of rendered animation frames.
+ *
+ * Frames are stored downscaled by a configurable factor. When
+ * the memory budget is exceeded the least recently used frames
+ * are evicted. While previewing, the edit view shows frames from
+ * here instead of drawing the picture again.
+ */
+class FrameCache
+{
+public:
+    /// Default memory budget in bytes
+    static const size_t DefaultBudget = 256 * 1024 * 1024;
+
+    /// Default scale frames are stored at
+    static constexpr double DefaultScale = 0.5;
+
+private:
+    /// A cached frame
+    struct Entry
+    {
+        /// The downscaled frame image
+        wxImage mImage;
+
+        /// Position of this frame in mOrder
+        std::list<int>::iterator mOrder;
+    };
+
+    /// Cached frames by frame number
+    std::unordered_map<int, Entry> mFrames;
+
+    /// Frame numbers, most recently used first
+    std::list<int> mOrder;
+
+    /// Memory budget in bytes
+    size_t mBudget;
+
+    /// Memory used by the cached images in bytes
+    size_t mMemoryUsed = 0;
+
+    /// Scale frames are stored at
+    double mScale = DefaultScale;
+
+    /// Are frames being shown from the cache?
+    bool mPreviewing = false;
+
+    void Remove(int frame);
+    void Evict();
+
+public:
+    explicit FrameCache(size_t budget = DefaultBudget);
+
+    /// Copy constructor (disabled)
+    FrameCache(const FrameCache &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const FrameCache &) = delete;
+
+    wxImage Find(int frame);
+    void Add(int frame, const wxImage &image);
+    void Invalidate(int first, int last);
+    void Clear();
+    void SetBudget(size_t budget);
+    void SetScale(double scale);
+
+    /**
+     * Get the memory budget
+     * @return Budget in bytes
+     */
+    size_t GetBudget() const { return mBudget; }
+
+    /**
+     * Get the memory used by the cached frames
+     * @return Memory used in bytes
+     */
+    size_t GetMemoryUsed() const { return mMemoryUsed; }
+
+    /**
+     * Get the scale frames are stored at
+     * @return Scale from 0 to 1
+     */
+    double GetScale() const { return mScale; }
+
+    /**
+     * Get the number of cached frames
+     * @return Number of frames
+     */
+    int GetNumFrames() const { return (int)mFrames.size(); }
+
+    /**
+     * Set whether frames are being shown from the cache
+     * @param previewing true while previewing
+     */
+    void SetPreviewing(bool previewing) { mPreviewing = previewing; }
+
+    /**
+     * Are frames being shown from the cache?
+     * @return true while previewing
+     */
+    bool IsPreviewing() const { return mPreviewing; }
+};
+
+#endif //CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_FRAMECACHE_H
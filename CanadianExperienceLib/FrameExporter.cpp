@@ -0,0 +1,155 @@
+/**
+ * @file FrameExporter.cpp
+ * @author Thomas Toaz
+ */
+
+#include "pch.h"
+
+#include <wx/filename.h>
+#include <algorithm>
+
+#include "FrameExporter.h"
+#include "Picture.h"
+
+#include <render-list.h>
+#include <renderer.h>
+#include <render-image.h>
+#include <mipmap-kernel.h>
+
+/// Colour frames are cleared to before drawing, as RGBA
+const unsigned int BackgroundColour = 0xffffffff;
+
+/**
+ * Constructor
+ * @param picture The picture to export
+ */
+FrameExporter::FrameExporter(Picture *picture) : mPicture(picture)
+{
+}
+
+/**
+ * Set the size of the exported frames relative to the picture
+ * @param scale Scale, greater than 0
+ */
+void FrameExporter::SetScale(double scale)
+{
+    if (scale > 0)
+    {
+        mScale = scale;
+    }
+}
+
+/**
+ * Set how many pixels are drawn across and down each exported pixel
+ * @param supersample Supersampling factor, 1 for none
+ */
+void FrameExporter::SetSupersample(int supersample)
+{
+    mSupersample = std::clamp(supersample, 1, MipmapKernel::MaxBoxFactor);
+}
+
+/**
+ * Get the size of the exported frames
+ * @return Size in pixels
+ */
+wxSize FrameExporter::GetFrameSize()
+{
+    auto size = mPicture->GetSize();
+    return wxSize(std::max(1, int(std::lround(size.GetWidth() * mScale))),
+            std::max(1, int(std::lround(size.GetHeight() * mScale))));
+}
+
+/**
+ * Render one frame of the animation.
+ *
+ * The picture is recorded once and drawn a strip at a time,
+ * scaled by the export scale and the supersampling factor. Each
+ * strip is reduced into the frame before the next is drawn.
+ * This moves the picture to the frame's time.
+ * @param frame Frame number
+ * @return The frame image
+ */
+wxImage FrameExporter::Render(int frame)
+{
+    auto timeline = mPicture->GetTimeline();
+    mPicture->SetAnimationTime(double(frame) / timeline->GetFrameRate());
+
+    RenderList list;
+    mPicture->Record(list);
+    if (list.CountUnrenderable() > 0)
+    {
+        mIncompleteFrames++;
+    }
+
+    auto size = GetFrameSize();
+    int width = size.GetWidth();
+    int height = size.GetHeight();
+    int factor = mSupersample;
+    double scale = mScale * factor;
+
+    wxImage frameImage(width, height);
+    for (int top = 0; top < height; top += StripRows)
+    {
+        int rows = std::min(StripRows, height - top);
+
+        RenderImage strip(width * factor, rows * factor);
+        strip.Fill(BackgroundColour);
+        mTiles.Render(strip, [&list, top, factor, scale](Renderer &renderer) {
+            renderer.Translate(0, -top * factor);
+            renderer.Scale(scale, scale);
+            list.Replay(renderer);
+        });
+
+        auto rgb = frameImage.GetData() + size_t(top) * width * 3;
+        if (factor == 1)
+        {
+            strip.GetPlanes(rgb, nullptr);
+            continue;
+        }
+
+        RenderImage reduced(width, rows);
+        MipmapKernel::DownsampleBox(strip.GetRow(0), strip.GetWidth(), strip.GetHeight(), 4, factor,
+                reduced.GetRow(0));
+        reduced.GetPlanes(rgb, nullptr);
+    }
+
+    return frameImage;
+}
+
+/**
+ * Export every frame of the animation as a PNG file.
+ *
+ * The files are named frame0000.png, frame0001.png and so on.
+ * The picture is returned to the time it was at. Frames missing
+ * drawing the renderer cannot do are counted in GetIncompleteFrames.
+ * @param directory Directory to write the files to
+ * @param progress Function told about each frame, or nullptr
+ * @return true if every frame was written
+ */
+bool FrameExporter::Export(const wxString &directory, Progress progress)
+{
+    auto timeline = mPicture->GetTimeline();
+    auto numFrames = timeline->GetNumFrames();
+    auto time = mPicture->GetAnimationTime();
+
+    mIncompleteFrames = 0;
+    bool written = true;
+    for (int frame = 0; frame < numFrames; frame++)
+    {
+        if (progress != nullptr && !progress(frame, numFrames))
+        {
+            written = false;
+            break;
+        }
+
+        wxFileName filename(directory, wxString::Format(L"frame%04d.png", frame));
+        if (!Render(frame).SaveFile(filename.GetFullPath(), wxBITMAP_TYPE_PNG))
+        {
+            written = false;
+            break;
+        }
+    }
+
+    mPicture->SetAnimationTime(time);
+    return written;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file FrameExporter.h
+ * @author Thomas Toaz
+ *
+ * Renders the frames of an animation to image files.
+ */
+
+#ifndef CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_FRAMEEXPORTER_H
+#define CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_FRAMEEXPORTER_H
+
+#include <functional>
+
+#include <tile-renderer.h>
+
+class Picture;
+
+/**
+ * Renders the frames of an animation to image files.
+ *
+ * Each frame is recorded into a render list and replayed into
+ * software renderers a tile at a time, so drawing the frames
+ * needs no window or graphics context and uses every core.
+ *
+ * Exporting is not fully free of wxWidgets. Recording still uses
+ * wxFont, wxPen and wxImage, so the application has to initialize
+ * wxWidgets first, and the files are written with wxImage. The
+ * software renderer draws all text in its built-in 5x8 font
+ * scaled to the recorded font height, whatever the font. Drawing
+ * recorded as a callback, such as the machine stand-in, is left
+ * out, and the frames it is left out of are counted so the
+ * caller can report them.
+ *
+ * Frames can be exported larger than the picture, and can be
+ * supersampled: drawn a whole factor larger again and reduced
+ * with a box filter. The larger frame is drawn a strip of rows at
+ * a time and each strip is reduced before the next is drawn, so
+ * only one strip of it is ever in memory.
+ */
+class FrameExporter
+{
+public:
+    /**
+     * Function told about each frame as it is exported.
+     *
+     * It is given the frame number and the number of frames and
+     * returns false to stop exporting.
+     */
+    typedef std::function<bool(int frame, int numFrames)> Progress;
+
+    /// Rows of the exported frame drawn at a time
+    static const int StripRows = 64;
+
+private:
+    /// The picture exported
+    Picture *mPicture;
+
+    /// Draws the frames
+    TileRenderer mTiles;
+
+    /// Size of the exported frames relative to the picture
+    double mScale = 1;
+
+    /// Pixels drawn across and down each exported pixel
+    int mSupersample = 1;
+
+    /// Frames rendered since the last Export began that left out some drawing
+    int mIncompleteFrames = 0;
+
+public:
+    explicit FrameExporter(Picture *picture);
+
+    /// Copy constructor (disabled)
+    FrameExporter(const FrameExporter &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const FrameExporter &) = delete;
+
+    void SetScale(double scale);
+    void SetSupersample(int supersample);
+
+    /**
+     * Get the size of the exported frames relative to the picture
+     * @return Scale
+     */
+    double GetScale() const { return mScale; }
+
+    /**
+     * Get the pixels drawn across and down each exported pixel
+     * @return Supersampling factor, 1 for none
+     */
+    int GetSupersample() const { return mSupersample; }
+
+    /**
+     * Get the number of frames that left out some drawing.
+     *
+     * This counts the frames rendered since the last Export began
+     * that had drawing only a graphics context can do, such as
+     * the machine stand-in. Those frames are missing that content.
+     * @return Number of incomplete frames
+     */
+    int GetIncompleteFrames() const { return mIncompleteFrames; }
+
+    wxSize GetFrameSize();
+    wxImage Render(int frame);
+    bool Export(const wxString &directory, Progress progress = nullptr);
+};
+
+#endif //CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_FRAMEEXPORTER_H
@@ -0,0 +1,129 @@
+/**
+ * @file FrameRing.h
+ * @author Thomas Toaz
+ *
+ * Lock-free single-producer/single-consumer ring buffer.
+ */
+
+#ifndef CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_FRAMERING_H
+#define CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_FRAMERING_H
+
+#include <atomic>
+#include <vector>
+
+/**
+ * Lock-free single-producer/single-consumer ring buffer.
+ *
+ * Exactly one thread may call Push and exactly one other
+ * thread may call Peek and Pop. The capacity is rounded up
+ * to a power of two.
+ * @tparam T Type of the items in the ring
+ */
+template <class T>
+class FrameRing
+{
+private:
+    /// Storage for the items
+    std::vector<T> mItems;
+
+    /// Capacity - 1, used to wrap the indices
+    size_t mMask;
+
+    /// Index of the next item to read, written by the consumer
+    std::atomic<size_t> mHead{0};
+
+    /// Index of the next item to write, written by the producer
+    std::atomic<size_t> mTail{0};
+
+public:
+    /**
+     * Constructor
+     * @param capacity Minimum number of items the ring can hold
+     */
+    explicit FrameRing(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        mItems.resize(size);
+        mMask = size - 1;
+    }
+
+    /// Copy constructor (disabled)
+    FrameRing(const FrameRing &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const FrameRing &) = delete;
+
+    /**
+     * Add an item to the ring. Producer only.
+     * @param item Item to add
+     * @return false if the ring is full
+     */
+    bool Push(T item)
+    {
+        auto tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) > mMask)
+        {
+            return false;
+        }
+
+        mItems[tail & mMask] = std::move(item);
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Is the ring full? Producer only.
+     * @return true if Push would fail
+     */
+    bool IsFull() const
+    {
+        return mTail.load(std::memory_order_relaxed) - mHead.load(std::memory_order_acquire) > mMask;
+    }
+
+    /**
+     * Get the oldest item without removing it. Consumer only.
+     * @param item Where to put the item
+     * @return false if the ring is empty
+     */
+    bool Peek(T &item) const
+    {
+        auto head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        item = mItems[head & mMask];
+        return true;
+    }
+
+    /**
+     * Remove the oldest item. Consumer only, and only
+     * after Peek has returned true.
+     */
+    void Pop()
+    {
+        auto head = mHead.load(std::memory_order_relaxed);
+        mItems[head & mMask] = T();
+        mHead.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * Remove all items. Only safe when the producer is not running.
+     */
+    void Clear()
+    {
+        T item;
+        while (Peek(item))
+        {
+            Pop();
+        }
+    }
+};
+
+#endif //CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_FRAMERING_H
@@ -75,12 +75,12 @@ void HeadTop::GetKeyframe()
 
 
 /**
- * Draw the head top
- * @param graphics
+ * Record drawing the head top
+ * @param list Render list to record into
  */
-void HeadTop::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void HeadTop::Record(RenderList &list)
 {
-    ImageDrawable::Draw(graphics);
+    ImageDrawable::Record(list);
 
 //    wxPoint eb1 = TransformPoint(wxPoint(32, 63));
 //    wxPoint eb2 = TransformPoint(wxPoint(46, 61));
@@ -117,19 +117,19 @@ void HeadTop::Draw(std::shared_ptr<wxGraphicsContext> graphics)
         // Determine the point on the screen were we will draw the left eye
         wxPoint leye = TransformPoint(wxPoint(leftX, eyeY));
         // And draw the bitmap there
-        mLeftEye.DrawImage(graphics, leye, mPlacedR);
+        mLeftEye.RecordImage(list, leye, mPlacedR);
 
         // Repeat the process for the right eye.
         wxPoint reye = TransformPoint(wxPoint(rightX, eyeY));
-        mRightEye.DrawImage(graphics, reye, mPlacedR);
+        mRightEye.RecordImage(list, reye, mPlacedR);
     }
     else
     {
-        DrawEyebrow(graphics, wxPoint(rightX - 10, eyeY - 16), wxPoint(rightX + 4, eyeY - 18));
-        DrawEyebrow(graphics, wxPoint(leftX - 4, eyeY - 20), wxPoint(leftX + 9, eyeY - 18));
+        DrawEyebrow(list, wxPoint(rightX - 10, eyeY - 16), wxPoint(rightX + 4, eyeY - 18));
+        DrawEyebrow(list, wxPoint(leftX - 4, eyeY - 20), wxPoint(leftX + 9, eyeY - 18));
 
-        DrawEye(graphics, wxPoint(leftX, eyeY));
-        DrawEye(graphics, wxPoint(rightX, eyeY));
+        DrawEye(list, wxPoint(leftX, eyeY));
+        DrawEye(list, wxPoint(rightX, eyeY));
     }
 
 }
@@ -140,41 +140,41 @@ void HeadTop::Draw(std::shared_ptr<wxGraphicsContext> graphics)
  *
  * Draw a line from (x1, y1) to (x2, y2) after transformation
  * to the local coordinate system.
- * @param graphics Graphics context to draw on
+ * @param list Render list to record into
  * @param p1 First point
  * @param p2 Second point
  */
-void HeadTop::DrawEyebrow(std::shared_ptr<wxGraphicsContext> graphics,
+void HeadTop::DrawEyebrow(RenderList &list,
         wxPoint p1, wxPoint p2)
 {
     auto eb1 = TransformPoint(p1);
     auto eb2 = TransformPoint(p2);
 
     wxPen eyebrowPen(*wxBLACK, 2);
-    graphics->SetPen(eyebrowPen);
-    graphics->StrokeLine(eb1.x, eb1.y, eb2.x, eb2.y);
+    list.SetPen(eyebrowPen);
+    list.StrokeLine(eb1.x, eb1.y, eb2.x, eb2.y);
 }
 
 
 /**
  * Draw an eye using an Ellipse
- * @param graphics The graphics context to draw on
+ * @param list Render list to record into
  * @param p1 Where to draw before transformation */
-void HeadTop::DrawEye(std::shared_ptr<wxGraphicsContext> graphics, wxPoint p1)
+void HeadTop::DrawEye(RenderList &list, wxPoint p1)
 {
-    graphics->SetBrush(*wxBLACK_BRUSH);
-    graphics->SetPen(*wxTRANSPARENT_PEN);
+    list.SetBrush(*wxBLACK_BRUSH);
+    list.SetPen(*wxTRANSPARENT_PEN);
 
     auto e1 = TransformPoint(p1);
 
     float wid = 15.0f;
     float hit = 20.0f;
 
-    graphics->PushState();
-    graphics->Translate(e1.x, e1.y);
-    graphics->Rotate(-mPlacedR);
-    graphics->DrawEllipse(-wid/2, -hit/2, wid, hit);
-    graphics->PopState();
+    list.PushState();
+    list.Translate(e1.x, e1.y);
+    list.Rotate(-mPlacedR);
+    list.DrawEllipse(-wid/2, -hit/2, wid, hit);
+    list.PopState();
 }
 
 
@@ -38,13 +38,13 @@ public:
      */
     bool IsMovable() override { return true; }
 
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void Record(RenderList &list) override;
 
     wxPoint TransformPoint(wxPoint p);
 
-    void DrawEyebrow(std::shared_ptr<wxGraphicsContext> graphics, wxPoint p1, wxPoint p2);
+    void DrawEyebrow(RenderList &list, wxPoint p1, wxPoint p2);
 
-    void DrawEye(std::shared_ptr<wxGraphicsContext> graphics, wxPoint p1);
+    void DrawEye(RenderList &list, wxPoint p1);
 
     /**
      * Set the location for the center of the eyes
@@ -5,36 +5,153 @@
 
 #include "pch.h"
 #include "ImageDrawable.h"
+#include <image-atlas.h>
+#include <image-memory.h>
+#include <render-image.h>
 
 
 /** Constructor
  * @param name The drawable name
  * @param filename The filename for the image */
 ImageDrawable::ImageDrawable(const std::wstring &name, const std::wstring &filename) :
-        Drawable(name)
+        Drawable(name), mFilename(filename)
 {
-    mImage = std::make_unique<wxImage>(filename, wxBITMAP_TYPE_ANY);
+    // Small images come from the shared atlas without decoding
+    auto image = ImageAtlas::Shared().GetImage(filename);
+    if(image.IsOk())
+    {
+        mImage = std::make_unique<wxImage>(image);
+    }
+    else
+    {
+        mImage = std::make_unique<wxImage>(filename, wxBITMAP_TYPE_ANY);
+    }
+
+    mSize = mImage->GetSize();
+
+    // A mask colour counts as transparent, as in wxImage::IsTransparent
+    wxImage alpha = *mImage;
+    if(alpha.HasMask() && !alpha.HasAlpha())
+    {
+        alpha = alpha.Copy();
+        alpha.InitAlpha();
+    }
+
+    mMask = AlphaMask(mSize.GetWidth(), mSize.GetHeight(), alpha.HasAlpha() ? alpha.GetAlpha() : nullptr);
+    RecordMemory();
 }
 
+/**
+ * Destructor
+ */
+ImageDrawable::~ImageDrawable()
+{
+    ImageMemory::Shared().Forget(this);
+}
 
 /**
- * Draw the image drawable
- * @param graphics Graphics context to draw on
+ * Record the pixels this drawable holds in the shared ImageMemory
  */
-void ImageDrawable::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void ImageDrawable::RecordMemory()
+{
+    size_t bytes = mMask.GetBytes();
+    if(mImage != nullptr)
+    {
+        bytes += ImageMemory::ImageBytes(mSize.GetWidth(), mSize.GetHeight(), mImage->HasAlpha());
+    }
+
+    if(mPixels != nullptr)
+    {
+        bytes += mPixels->GetBytes();
+    }
+
+    ImageMemory::Shared().Record(this, mFilename, bytes);
+}
+
+
+/**
+ * Record drawing the image drawable
+ * @param list Render list to record into
+ */
+void ImageDrawable::Record(RenderList &list)
+{
+    list.PushState();
+    list.Translate(mPlacedPosition.x, mPlacedPosition.y);
+    list.Rotate(-mPlacedR);
+    list.DrawBitmap(mFilename, [this](std::shared_ptr<wxGraphicsContext> graphics) { return GetBitmap(graphics); },
+            [this](double) { return GetPixels(); },
+            -mCenter.x, -mCenter.y, mSize.GetWidth(), mSize.GetHeight());
+
+    list.PopState();
+}
+
+/**
+ * Get the bitmap to draw the image with, creating it if needed
+ * @param graphics Graphics context the bitmap is for
+ * @return Graphics bitmap
+ */
+wxGraphicsBitmap ImageDrawable::GetBitmap(std::shared_ptr<wxGraphicsContext> graphics)
 {
     if(mBitmap.IsNull())
     {
-        mBitmap = graphics->CreateBitmapFromImage(*mImage);
+        // An image in the atlas shares the bitmap of its page
+        mBitmap = ImageAtlas::Shared().GetBitmap(graphics, mFilename);
+        if(mBitmap.IsNull())
+        {
+            mBitmap = graphics->CreateBitmapFromImage(*mImage);
+        }
     }
 
-    graphics->PushState();
-    graphics->Translate(mPlacedPosition.x, mPlacedPosition.y);
-    graphics->Rotate(-mPlacedR);
-    graphics->DrawBitmap(mBitmap, -mCenter.x, -mCenter.y,
-            mImage->GetWidth(), mImage->GetHeight());
+    if(mImage != nullptr && ImageMemory::Shared().IsReleasePixels())
+    {
+        // Hit testing only needs the mask
+        mImage = nullptr;
+        RecordMemory();
+    }
+
+    return mBitmap;
+}
+
+
+/**
+ * Get the pixels to draw the image with in a Renderer, making them if needed.
+ *
+ * If the decoded image was released it is decoded again. The
+ * pixels are kept like the bitmap, so when pixels are being
+ * released only the decoded image is released.
+ * @return Pixels with premultiplied alpha
+ */
+std::shared_ptr<const RenderImage> ImageDrawable::GetPixels()
+{
+    bool changed = false;
+    if(mPixels == nullptr)
+    {
+        if(mImage != nullptr)
+        {
+            mPixels = RenderList::MakeImage(*mImage);
+        }
+        else
+        {
+            auto image = ImageAtlas::Shared().GetImage(mFilename);
+            mPixels = RenderList::MakeImage(image.IsOk() ? image : wxImage(mFilename, wxBITMAP_TYPE_ANY));
+        }
+
+        changed = true;
+    }
+
+    if(mImage != nullptr && ImageMemory::Shared().IsReleasePixels())
+    {
+        // Hit testing only needs the mask
+        mImage = nullptr;
+        changed = true;
+    }
+
+    if(changed)
+    {
+        RecordMemory();
+    }
 
-    graphics->PopState();
+    return mPixels;
 }
 
 
@@ -73,8 +190,8 @@ bool ImageDrawable::HitTest(wxPoint pos)
 //    wxDouble y = pos.y;
 //    mat.TransformPoint(&x, &y);
 
-    double wid = mImage->GetWidth();
-    double hit = mImage->GetHeight();
+    double wid = mSize.GetWidth();
+    double hit = mSize.GetHeight();
 
     // Test to see if x, y are in the image
     if (x < 0 || y < 0 || x >= wid || y >= hit)
@@ -86,5 +203,5 @@ bool ImageDrawable::HitTest(wxPoint pos)
     // Test to see if x, y are in the drawn part of the image
     // If the location is transparent, we are not in the drawn
     // part of the image
-    return !mImage->IsTransparent((int)x, (int)y);
+    return mMask.IsOpaque((int)x, (int)y);
 }
\ No newline at end of file
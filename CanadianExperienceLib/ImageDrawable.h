@@ -9,24 +9,45 @@
 #define CANADIANEXPERIENCE_IMAGEDRAWABLE_H
 
 #include "Drawable.h"
+#include <alpha-mask.h>
 
 /**
  * A drawable that displays an image
  */
 class ImageDrawable : public Drawable {
 private:
-    /// The underlying image we are drawing
+    /// The underlying image we are drawing, released after the
+    /// bitmap is created if ImageMemory says so
     std::unique_ptr<wxImage> mImage;
 
+    /// Size of the image in pixels
+    wxSize mSize;
+
+    /// Opaque pixels of the image for hit testing
+    AlphaMask mMask;
+
     /// The graphics bitmap we will use
     wxGraphicsBitmap mBitmap;
 
+    /// Pixels for drawing with a Renderer, made when first needed
+    /// and kept as mBitmap is
+    std::shared_ptr<const RenderImage> mPixels;
+
+    /// The file the image was loaded from
+    std::wstring mFilename;
+
     /// The center of the image
     wxPoint mCenter = wxPoint(0, 0);
 
+    void RecordMemory();
+    wxGraphicsBitmap GetBitmap(std::shared_ptr<wxGraphicsContext> graphics);
+    std::shared_ptr<const RenderImage> GetPixels();
+
 public:
     ImageDrawable(const std::wstring& name, const std::wstring& filename);
 
+    virtual ~ImageDrawable();
+
     /**
      * Set the center to rotate around
      * @param center New center
@@ -39,7 +60,7 @@ public:
      */
     wxPoint GetCenter() const { return mCenter; }
 
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void Record(RenderList &list) override;
 
     bool HitTest(wxPoint pos) override;
 };
@@ -8,6 +8,8 @@
 #include "Drawable.h"
 #include "Timeline.h"
 #include "MachineStartTimeDlg.h"
+#include "Actor.h"
+#include "ThreadPool.h"
 
 /**
  * Constructor for machine adapter object
@@ -15,7 +17,7 @@
  * @param resourceDir
  */
 MachineAdapter::MachineAdapter(const std::wstring& name,std::wstring resourceDir):
-    Drawable(name)
+    Drawable(name), mResourcesDir(resourceDir), mAdvancedFrame(UnknownFrame)
 {
     MachineSystemFactory systemFactory(resourceDir);
     mMachineSystem = systemFactory.CreateMachineSystem();
@@ -23,18 +25,28 @@ MachineAdapter::MachineAdapter(const std::wstring& name,std::wstring resourceDir
 }
 
 /**
- * Draw the machine adapter object
- * @param graphics
+ * Record drawing the machine adapter object
+ * @param list Render list to record into
  */
-void MachineAdapter::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void MachineAdapter::Record(RenderList &list)
 {
     double scale = 0.60f;
 
-    graphics->PushState();
-    graphics->Scale(scale, scale);
-    graphics->Translate(GetPosition().x,GetPosition().y);
-    mMachineSystem->DrawMachine(graphics);
-    graphics->PopState();
+    WaitForActivation();
+
+    list.PushState();
+    list.Scale(scale, scale);
+    list.Translate(GetPosition().x,GetPosition().y);
+    if (auto actual = GetActual())
+    {
+        actual->RecordMachine(list);
+    }
+    else
+    {
+        auto system = mMachineSystem;
+        list.AddCallback([system](std::shared_ptr<wxGraphicsContext> graphics) { system->DrawMachine(graphics); });
+    }
+    list.PopState();
 }
 
 /**
@@ -55,6 +67,8 @@ bool MachineAdapter::HitTest(wxPoint pos)
  */
 void MachineAdapter::ShowDialogBox(wxWindow* parent)
 {
+    WaitForActivation();
+
     MachineDialog dlg(parent, mMachineSystem);
     if (dlg.ShowModal() == wxID_OK)
     {
@@ -68,6 +82,10 @@ void MachineAdapter::ShowDialogBox(wxWindow* parent)
         // A machine has been selected
         parent->Refresh();
     }
+
+    // The dialog may have replaced the machine
+    mAdvancedFrame = UnknownFrame;
+    mActivation = std::future<void>();
 }
 
 /**
@@ -75,27 +93,187 @@ void MachineAdapter::ShowDialogBox(wxWindow* parent)
  */
 void MachineAdapter::GetKeyframe()
 {
+    AdvanceMachine();
+}
+
+/**
+ * Bring the machine to the current frame of the timeline.
+ *
+ * This only touches this adapter's machine system, so
+ * different adapters may be advanced on different threads.
+ * Machines that do not need it (see NeedsAdvance) are left
+ * alone and catch up the next time they do.
+ */
+void MachineAdapter::AdvanceMachine()
+{
+    WaitForActivation();
+
+    if (mExternallyDriven)
+    {
+        // The playback engine has already simulated this frame
+        auto actual = GetActual();
+        if (mPendingState != nullptr && actual != nullptr)
+        {
+            actual->SetMachineState(*mPendingState);
+            mPendingState = nullptr;
+        }
+
+        return;
+    }
+
+    if (!NeedsAdvance())
+    {
+        return;
+    }
+
+    auto timeline = GetAngleChannel()->GetTimeline();
+    mAdvancedFrame = GetTargetFrame();
+    mAdvancedFrameRate = timeline->GetFrameRate();
+
+    mMachineSystem->SetFrameRate(mAdvancedFrameRate);
+    mMachineSystem->SetMachineFrame(mAdvancedFrame);
+}
+
+/**
+ * Does the machine need simulating to reach the current frame?
+ *
+ * A machine is left alone while its actor is not shown, or
+ * when it is already at the frame it should be at. That
+ * includes a machine waiting for its start frame, which
+ * stays at frame -1 without being reset every frame.
+ * @return true if AdvanceMachine would simulate
+ */
+bool MachineAdapter::NeedsAdvance()
+{
+    if (mExternallyDriven || GetAngleChannel()->GetTimeline() == nullptr || !IsVisible())
+    {
+        return false;
+    }
+
     auto timeline = GetAngleChannel()->GetTimeline();
-    mMachineSystem->SetFrameRate(timeline->GetFrameRate());
+    return GetTargetFrame() != mAdvancedFrame || timeline->GetFrameRate() != mAdvancedFrameRate;
+}
 
-    // Calculate what the current frame of the machine should be base on it's starting frame offset
-    double machineFrame = timeline->GetCurrentFrame()-mFrameOffset;
+/**
+ * Start building the machine if its start frame is near.
+ *
+ * The machine system builds the machine the first time it is
+ * drawn or simulated past its start. This moves that work to
+ * a background thread once the timeline is within frames of
+ * the machine's start, so it is usually done before it is
+ * needed. Every use of the machine system waits for it.
+ * @param pool Thread pool to build on
+ * @param frames How many frames ahead of the start to build
+ */
+void MachineAdapter::Prefetch(ThreadPool *pool, int frames)
+{
+    auto timeline = GetAngleChannel()->GetTimeline();
+    if (mActivation.valid() || mExternallyDriven || timeline == nullptr || !IsVisible())
+    {
+        return;
+    }
 
-    if(machineFrame >= 0)
+    if (timeline->GetCurrentFrame() + frames < mFrameOffset)
     {
-        mMachineSystem->SetMachineFrame(machineFrame);
+        return;
     }
-    else
+
+    auto actual = GetActual();
+    if (actual == nullptr)
+    {
+        return;
+    }
+
+    mActivation = pool->Submit([actual] { actual->Activate(); });
+}
+
+/**
+ * Wait for a background build of the machine to finish
+ */
+void MachineAdapter::WaitForActivation()
+{
+    if (mActivation.valid())
     {
-        mMachineSystem->SetMachineFrame(-1);
+        mActivation.wait();
     }
 }
 
+/**
+ * Get the machine system as a MachineSystemActual.
+ *
+ * Machine states, deferred building and recorded drawing are
+ * not part of IMachineSystem, so a stand-in machine system
+ * has none of them.
+ * @return The machine system or nullptr if it is not a MachineSystemActual
+ */
+std::shared_ptr<MachineSystemActual> MachineAdapter::GetActual()
+{
+    return std::dynamic_pointer_cast<MachineSystemActual>(mMachineSystem);
+}
+
+/**
+ * Is the machine shown in the picture?
+ * @return true if the actor holding the machine is enabled
+ */
+bool MachineAdapter::IsVisible()
+{
+    return GetActor() == nullptr || GetActor()->IsEnabled();
+}
+
+/**
+ * Get the machine frame for the current timeline frame
+ * @return Machine frame, or -1 before the machine starts
+ */
+int MachineAdapter::GetTargetFrame()
+{
+    auto timeline = GetAngleChannel()->GetTimeline();
+
+    // Calculate what the current frame of the machine should be base on it's starting frame offset
+    double machineFrame = timeline->GetCurrentFrame() - mFrameOffset;
+    return machineFrame >= 0 ? (int)machineFrame : -1;
+}
+
 /**
  * Set the machine number for the machine you want to use
  * @param num the machine number
  */
 void MachineAdapter::SetMachineNumber(int num)
 {
+    WaitForActivation();
     mMachineSystem->SetMachineNumber(num);
+    mAdvancedFrame = UnknownFrame;
+    mActivation = std::future<void>();
+}
+
+/**
+ * Create a separate machine system matching this one, for
+ * simulating away from the UI thread
+ * @return New machine system set to the same machine number, or
+ * nullptr if the factory does not create machine systems that
+ * can save their state
+ */
+std::shared_ptr<MachineSystemActual> MachineAdapter::CreateSimulation()
+{
+    MachineSystemFactory systemFactory(mResourcesDir);
+    auto simulation = std::dynamic_pointer_cast<MachineSystemActual>(systemFactory.CreateMachineSystem());
+    if (simulation != nullptr)
+    {
+        simulation->SetMachineNumber(mMachineSystem->GetMachineNumber());
+    }
+
+    return simulation;
+}
+
+/**
+ * Set whether a PlaybackEngine supplies the machine state.
+ *
+ * While externally driven, GetKeyframe shows the supplied
+ * state instead of simulating.
+ * @param driven true if externally driven
+ */
+void MachineAdapter::SetExternallyDriven(bool driven)
+{
+    mExternallyDriven = driven;
+    mPendingState = nullptr;
+    mAdvancedFrame = UnknownFrame;
 }
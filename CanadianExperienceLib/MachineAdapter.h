@@ -8,8 +8,13 @@
 #ifndef CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_MACHINEADAPTER_H
 #define CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_MACHINEADAPTER_H
 
+#include <future>
+
 #include "Drawable.h"
 #include <machine-api.h>
+#include <machine-system-actual.h>
+
+class ThreadPool;
 
 /**
  * Adapter class to make machine work with Canadian Experience
@@ -23,13 +28,51 @@ private:
     /// Offset frame value for when you want the machine to start running
     double mFrameOffset = 0;
 
+    /// Directory containing the machine resources
+    std::wstring mResourcesDir;
+
+    /// True while a PlaybackEngine supplies the machine state
+    bool mExternallyDriven = false;
+
+    /// State supplied for the next GetKeyframe while externally driven
+    std::shared_ptr<const MachineState> mPendingState;
+
+    /// Machine frame the machine was last advanced to, or UnknownFrame
+    int mAdvancedFrame;
+
+    /// Frame rate the machine was last advanced at
+    double mAdvancedFrameRate = 0;
+
+    /// Building the machine ahead of its start frame, if started
+    std::future<void> mActivation;
+
+    int GetTargetFrame();
+    void WaitForActivation();
+    std::shared_ptr<MachineSystemActual> GetActual();
+
 public:
+    /// Value of mAdvancedFrame when the machine's frame is not known
+    static const int UnknownFrame = -2;
+
     MachineAdapter(const std::wstring& name,std::wstring resourceDir);
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void Record(RenderList &list) override;
     bool HitTest(wxPoint pos) override;
     void ShowDialogBox(wxWindow* parent) override;
     void GetKeyframe()override;
+    void AdvanceMachine();
+    bool NeedsAdvance();
+    void Prefetch(ThreadPool *pool, int frames);
+    bool IsVisible();
     void SetMachineNumber(int num);
+    std::shared_ptr<MachineSystemActual> CreateSimulation();
+    void SetExternallyDriven(bool driven);
+
+    /**
+     * Supply the machine state to show at the next GetKeyframe
+     * while externally driven
+     * @param state The machine state
+     */
+    void SetMachineState(std::shared_ptr<const MachineState> state) {mPendingState = state;}
 
     /**
      * Get the machine number of the machine in the adapter
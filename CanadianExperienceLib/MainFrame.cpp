@@ -6,6 +6,8 @@
 
 #include <wx/xrc/xmlres.h>
 #include <wx/stdpaths.h>
+#include <wx/filename.h>
+#include <sstream>
 
 #include "MainFrame.h"
 
@@ -14,9 +16,15 @@
 #include "Picture.h"
 #include "PictureFactory.h"
 
+#include <image-atlas.h>
+#include <image-memory.h>
+
 /// Directory within resources that contains the images.
 const std::wstring ImagesDirectory = L"/images";
 
+/// Directory within the user data directory the image atlas is cached in
+const std::wstring AtlasDirectory = L"/atlas";
+
 
 /**
  * Constructor
@@ -44,6 +52,11 @@ void MainFrame::Initialize()
 
     auto imagesDir = mResourcesDir + ImagesDirectory;
 
+    // Pack the small images into the shared atlas before anything
+    // loads them. The atlas is cached between runs.
+    auto cacheDir = wxStandardPaths::Get().GetUserLocalDataDir().ToStdWstring() + AtlasDirectory;
+    ImageAtlas::Shared().Build(imagesDir, cacheDir);
+
     mViewEdit = new ViewEdit(this);
     mViewTimeline = new ViewTimeline(this, imagesDir);
 
@@ -56,6 +69,9 @@ void MainFrame::Initialize()
     Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnExit, this, wxID_EXIT);
     Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnAbout, this, wxID_ABOUT);
     Bind(wxEVT_CLOSE_WINDOW, &MainFrame::OnClose, this);
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnReleasePixels, this, XRCID("HelpReleasePixels"));
+    Bind(wxEVT_UPDATE_UI, &MainFrame::OnUpdateReleasePixels, this, XRCID("HelpReleasePixels"));
+    Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnImageMemory, this, XRCID("HelpImageMemory"));
 
     //
     // Create the picture
@@ -90,6 +106,49 @@ void MainFrame::OnAbout(wxCommandEvent& event)
     aboutDlg.ShowModal();
 }
 
+/**
+ * Help>Release Image Pixels menu handler
+ *
+ * Images release their decoded pixels the next time they are drawn.
+ * @param event The menu command event
+ */
+void MainFrame::OnReleasePixels(wxCommandEvent& event)
+{
+    auto &memory = ImageMemory::Shared();
+    memory.SetReleasePixels(!memory.IsReleasePixels());
+    Refresh();
+}
+
+/**
+ * Update handler for Help>Release Image Pixels
+ * @param event Update event
+ */
+void MainFrame::OnUpdateReleasePixels(wxUpdateUIEvent& event)
+{
+    event.Check(ImageMemory::Shared().IsReleasePixels());
+}
+
+/**
+ * Help>Image Memory menu handler
+ *
+ * Shows the decoded image bytes held for each asset, largest first.
+ * @param event The menu command event
+ */
+void MainFrame::OnImageMemory(wxCommandEvent& event)
+{
+    auto &memory = ImageMemory::Shared();
+
+    std::wstringstream str;
+    str << L"Total: " << memory.GetTotalBytes() / 1024 << L" KB" << std::endl << std::endl;
+    for(auto &entry : memory.GetReport())
+    {
+        str << wxFileName(entry.mAsset).GetFullName().ToStdWstring() << L": "
+            << entry.mBytes / 1024 << L" KB" << std::endl;
+    }
+
+    wxMessageBox(str.str(), L"Image Memory", wxOK, this);
+}
+
 
 /**
  * Handle a close event. Stop the animation and destroy this window.
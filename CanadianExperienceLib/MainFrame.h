@@ -26,6 +26,9 @@ private:
     void OnExit(wxCommandEvent& event);
     void OnAbout(wxCommandEvent&);
     void OnClose(wxCloseEvent &event);
+    void OnReleasePixels(wxCommandEvent& event);
+    void OnUpdateReleasePixels(wxUpdateUIEvent& event);
+    void OnImageMemory(wxCommandEvent& event);
 
     /// The resources directory to use
     std::wstring mResourcesDir;
@@ -9,6 +9,7 @@
 #include "PictureObserver.h"
 #include "Actor.h"
 #include "MachineAdapter.h"
+#include "Drawable.h"
 
 
 /**
@@ -29,12 +30,98 @@ Picture::Picture()
 void Picture::SetAnimationTime(double time)
 {
     mTimeline.SetCurrentTime(time);
-    UpdateObservers();
+    AdvanceMachines();
 
     for (auto actor : mActors)
     {
         actor->GetKeyframe();
     }
+
+    UpdateObservers(PictureObserver::Time);
+}
+
+/**
+ * Load the machine settings from an animation file.
+ *
+ * Each machine element applies to the machine at the same
+ * position in the picture. Files written before machine
+ * elements existed store two machines as root attributes.
+ * @param root Root node of the animation file
+ */
+void Picture::XmlMachines(wxXmlNode* root)
+{
+    size_t index = 0;
+    for (auto child = root->GetChildren(); child; child = child->GetNext())
+    {
+        if (child->GetName() == L"machine" && index < mMachines.size())
+        {
+            auto machine = mMachines[index++];
+            machine->SetMachineNumber(wxAtoi(child->GetAttribute(L"number", L"1")));
+
+            double start = 0;
+            child->GetAttribute(L"start", L"0").ToDouble(&start);
+            machine->SetFrameOffset(start);
+        }
+    }
+
+    if (index > 0 || !root->HasAttribute(L"MachineStart1"))
+    {
+        return;
+    }
+
+    const wchar_t *legacyStarts[] = {L"MachineStart1", L"MachineStart2"};
+    const wchar_t *legacyNumbers[] = {L"MachineOneNumber", L"MachineTwoNumber"};
+    for (index = 0; index < 2 && index < mMachines.size(); index++)
+    {
+        mMachines[index]->SetFrameOffset(wxAtoi(root->GetAttribute(legacyStarts[index], L"0")));
+        mMachines[index]->SetMachineNumber(wxAtoi(root->GetAttribute(legacyNumbers[index], L"0")));
+    }
+}
+
+/**
+ * Advance the machines to the current frame.
+ *
+ * Machines whose start frame is near are first built in the
+ * background (see MachineAdapter::Prefetch). Only machines that
+ * need it are simulated: a machine that is hidden, is waiting
+ * for its start frame or is already at the frame is skipped
+ * (see MachineAdapter::NeedsAdvance). Each
+ * machine has its own physics world, so the rest are simulated
+ * in parallel and a long seek costs about as much as the slowest
+ * machine rather than the sum of them. This returns once all of
+ * them are done, so the actors that hold the machines then find
+ * them already at the frame.
+ *
+ * Box2D 2.4.1 also keeps a few global statistics counters that
+ * every world updates while stepping (b2_gjkCalls, b2_gjkIters,
+ * b2_gjkMaxIters, b2_toiCalls, b2_toiIters, b2_toiMaxIters,
+ * b2_toiRootIters, b2_toiMaxRootIters, b2_toiTime and
+ * b2_toiMaxTime). Stepping worlds on several threads races on
+ * those counters. The race is benign: Box2D only writes them and
+ * never reads them back to make a decision, and nothing here
+ * reads them, so a lost count cannot change a simulation. They
+ * would be wrong if they were ever used for profiling. A thread
+ * sanitizer build reports them and should suppress them.
+ */
+void Picture::AdvanceMachines()
+{
+    std::vector<std::function<void()>> tasks;
+    for (auto machine : mMachines)
+    {
+        machine->Prefetch(&mPrefetchPool, mMachinePrefetch);
+        if (machine->NeedsAdvance())
+        {
+            tasks.push_back([machine] { machine->AdvanceMachine(); });
+        }
+    }
+
+    if (tasks.size() == 1)
+    {
+        tasks[0]();
+        return;
+    }
+
+    mMachinePool.RunAll(tasks);
 }
 
 /**
@@ -70,24 +157,60 @@ void Picture::RemoveObserver(PictureObserver* observer)
 
 /**
  * Update all observers to indicate the picture has changed.
+ * @param changes What changed, a bitwise or of PictureObserver::Changes values
  */
-void Picture::UpdateObservers()
+void Picture::UpdateObservers(int changes)
 {
+    // A scene edit may change frames that have no keyframes
+    // and a timeline change moves every frame, so neither can
+    // be narrowed to a range of cached frames
+    if (changes & (PictureObserver::Scene | PictureObserver::TimelineProperties))
+    {
+        mFrameCache.Clear();
+    }
+
     for (auto observer : mObservers)
     {
-        observer->UpdateObserver();
+        observer->UpdateObserverChanges(changes);
     }
 }
 
+/**
+ * Discard the cached frames a keyframe change can affect
+ * @param frame Frame the keyframe was set or deleted at
+ */
+void Picture::InvalidateKeyframe(int frame)
+{
+    int first, last;
+    mTimeline.GetKeyframeSpan(frame, first, last);
+    mFrameCache.Invalidate(first, last);
+}
+
 /**
  * Draw this picture on a device context
  * @param graphics The device context to draw on
  */
 void Picture::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+{
+    RenderList list;
+    Record(list);
+    list.Replay(graphics);
+}
+
+/**
+ * Record drawing this picture into a render list.
+ *
+ * The list can be replayed into any number of graphics
+ * contexts, and recording needs no graphics context, so a
+ * frame can be recorded on a worker thread. The picture must
+ * not change between recording and replaying.
+ * @param list Render list to record into
+ */
+void Picture::Record(RenderList &list)
 {
     for (auto actor : mActors)
     {
-        actor->Draw(graphics);
+        actor->Record(list);
     }
 }
 
@@ -102,6 +225,18 @@ void Picture::AddActor(std::shared_ptr<Actor> actor)
 }
 
 
+/**
+ * Add a machine to this picture.
+ *
+ * The machine's drawable must also be added to an actor
+ * for it to be drawn.
+ * @param machine Machine adapter to add
+ */
+void Picture::AddMachine(std::shared_ptr<MachineAdapter> machine)
+{
+    mMachines.push_back(machine);
+}
+
 /**
 * Save the picture animation to a file
 * @param filename File to save to.
@@ -116,13 +251,15 @@ void Picture::Save(const wxString& filename)
     // Save the timeline animation into the XML
     mTimeline.Save(root);
 
-    //
-    // It is possible to add attributes to the root node here
-    //
-    root->AddAttribute(L"MachineStart1",wxString::Format(wxT("%f"), mMachine1->GetFrameOffset()));
-    root->AddAttribute(L"MachineStart2", wxString::Format(wxT("%f"), mMachine2->GetFrameOffset()));
-    root->AddAttribute(L"MachineOneNumber", wxString::Format(wxT("%i"), mMachine1->GetMachineNumber()));
-    root->AddAttribute(L"MachineTwoNumber", wxString::Format(wxT("%i"), mMachine1->GetMachineNumber()));
+    // One machine element per machine, in picture order
+    for (auto machine : mMachines)
+    {
+        auto node = new wxXmlNode(wxXML_ELEMENT_NODE, L"machine");
+        root->AddChild(node);
+
+        node->AddAttribute(L"number", wxString::Format(wxT("%i"), machine->GetMachineNumber()));
+        node->AddAttribute(L"start", wxString::Format(wxT("%f"), machine->GetFrameOffset()));
+    }
 
     if(!xmlDoc.Save(filename, wxXML_NO_INDENTATION))
     {
@@ -152,17 +289,8 @@ void Picture::Load(const wxString& filename)
     // Load the animation from the XML
     mTimeline.Load(root);
 
-    //
-    // It is possible to load attributes from the root node here
-    //
-    // mSomething = root->GetAttribute(L"something", L"default");
-    mMachine1->SetFrameOffset(wxAtoi(root->GetAttribute(L"MachineStart1", L"0")));
-    mMachine2->SetFrameOffset(wxAtoi(root->GetAttribute(L"MachineStart2", L"0")));
-
-    mMachine1->SetMachineNumber(wxAtoi(root->GetAttribute(L"MachineOneNumber", L"0")));
-    mMachine2->SetMachineNumber(wxAtoi(root->GetAttribute(L"MachineTwoNumber", L"0")));
+    XmlMachines(root);
 
     SetAnimationTime(0);
     UpdateObservers();
 }
-
@@ -9,10 +9,13 @@
 #pragma once
 
 #include "Timeline.h"
+#include "PictureObserver.h"
+#include "FrameCache.h"
+#include "ThreadPool.h"
 
-class PictureObserver;
 class Actor;
 class MachineAdapter;
+class RenderList;
 
 /**
  *  Class that represents our animation picture
@@ -32,13 +35,28 @@ private:
     /// The animation timeline
     Timeline mTimeline;
 
-    /// Pointer to the first machine in the system
-    std::shared_ptr<MachineAdapter> mMachine1;
+    /// The machines in the picture, in the order they are saved
+    std::vector<std::shared_ptr<MachineAdapter>> mMachines;
 
-    /// Pointer to the second machine in the system
-    std::shared_ptr<MachineAdapter> mMachine2;
+    /// Rendered frames for previewing
+    FrameCache mFrameCache;
+
+    /// Threads that advance the machines in parallel
+    ThreadPool mMachinePool;
+
+    /// Thread that builds machines ahead of their start frames
+    ThreadPool mPrefetchPool{1};
+
+    /// How many frames before its start a machine is built
+    int mMachinePrefetch = DefaultMachinePrefetch;
+
+    void AdvanceMachines();
+    void XmlMachines(wxXmlNode* root);
 
 public:
+    /// Default number of frames before its start a machine is built
+    static const int DefaultMachinePrefetch = 30;
+
     Picture();
 
     /// Copy Constructor (Disabled)
@@ -61,7 +79,7 @@ public:
      * Set the picture size
      * @param size Picture size in pixels
      */
-    void SetSize(wxSize size) {mSize = size;}
+    void SetSize(wxSize size) {mSize = size; mFrameCache.Clear();}
 
     /**
      * Get a pointer to the Timeline object
@@ -69,10 +87,19 @@ public:
      */
     Timeline *GetTimeline() {return &mTimeline;}
 
+    /**
+     * Get the cache of rendered frames
+     * @return Pointer to the FrameCache object
+     */
+    FrameCache *GetFrameCache() {return &mFrameCache;}
+
+    void InvalidateKeyframe(int frame);
+
     void AddObserver(PictureObserver *observer);
     void RemoveObserver(PictureObserver *observer);
-    void UpdateObservers();
+    void UpdateObservers(int changes = PictureObserver::AllChanges);
     void Draw(std::shared_ptr<wxGraphicsContext> graphics);
+    void Record(RenderList &list);
 
     void AddActor(std::shared_ptr<Actor> actor);
 
@@ -137,16 +164,24 @@ public:
 
     void Save(const wxString& filename);
 
+    void AddMachine(std::shared_ptr<MachineAdapter> machine);
+
+    /**
+     * Set how many frames before its start a machine is built
+     * @param frames Number of frames
+     */
+    void SetMachinePrefetch(int frames) {mMachinePrefetch = frames;}
+
     /**
-     * Set the pointer to the first machine
-     * @param machine pointer to the machine
+     * Get how many frames before its start a machine is built
+     * @return Number of frames
      */
-    void SetMachineOne (std::shared_ptr<MachineAdapter> machine) {mMachine1 = machine;}
+    int GetMachinePrefetch() const {return mMachinePrefetch;}
 
     /**
-     * Set the pointer to the first machine
-     * @param machine pointer to the machine
+     * Get the machines in this picture
+     * @return The machine adapters in the order they were added
      */
-    void SetMachineTwo (std::shared_ptr<MachineAdapter> machine) {mMachine2 = machine;}
+    const std::vector<std::shared_ptr<MachineAdapter>> &GetMachines() const {return mMachines;}
 };
 
@@ -43,7 +43,7 @@ std::shared_ptr<Picture> PictureFactory::Create(std::wstring resourcesDir)
     auto machineDrawable1 = std::make_shared<MachineAdapter>(L"Machine",resourcesDir);
     machineDrawable1->SetPosition(wxPoint(200, 250));
     machineDrawable1->SetFrameOffset(40);
-    picture->SetMachineOne(machineDrawable1);
+    picture->AddMachine(machineDrawable1);
     machineAdapterActor1->AddDrawable(machineDrawable1);
     machineAdapterActor1->SetPosition(wxPoint(200, 250));
     picture->AddActor(machineAdapterActor1);
@@ -53,7 +53,7 @@ std::shared_ptr<Picture> PictureFactory::Create(std::wstring resourcesDir)
     machineDrawable2->SetMachineNumber(2);
     machineDrawable2->SetPosition(wxPoint(1200, 400));
     machineDrawable2->SetFrameOffset(90);
-    picture->SetMachineTwo(machineDrawable2);
+    picture->AddMachine(machineDrawable2);
     machineAdapterActor2->AddDrawable(machineDrawable2);
     machineAdapterActor2->SetPosition(wxPoint(200, 250));
     picture->AddActor(machineAdapterActor2);
@@ -33,9 +33,30 @@ public:
     /// Assignment operator
     void operator=(const PictureObserver &) = delete;
 
+    /// The kinds of picture change an observer can be told about.
+    /// These are bits, so several can be combined in one notification.
+    enum Changes {
+        Scene = 1,              ///< Something in the scene moved or rotated
+        Time = 2,               ///< The current animation time changed
+        TimelineProperties = 4, ///< Number of frames or frame rate changed
+        AllChanges = Scene | Time | TimelineProperties ///< Everything may have changed
+    };
+
     /// This function is called to update any observers
     virtual void UpdateObserver() = 0;
 
+    /**
+     * This function is called to update any observers
+     * about a specific set of changes.
+     *
+     * Observers that can ignore some kinds of change
+     * override this. The default treats every change the same.
+     * It has its own name so overriding it does not hide
+     * UpdateObserver() in the observer.
+     * @param changes Bitwise or of Changes values
+     */
+    virtual void UpdateObserverChanges([[maybe_unused]] int changes) { UpdateObserver(); }
+
     virtual void SetPicture(std::shared_ptr<Picture> picture);
 
     /**
@@ -0,0 +1,176 @@
+/**
+ * @file PlaybackEngine.cpp
+ * @author Thomas Toaz
+ */
+
+#include "pch.h"
+#include "PlaybackEngine.h"
+#include "Picture.h"
+#include "MachineAdapter.h"
+
+/// How many frames the worker may get ahead of the display
+const int FramesAhead = 16;
+
+/// How long the worker waits when the ring is full
+const auto WorkerWait = std::chrono::milliseconds(2);
+
+/**
+ * Constructor
+ */
+PlaybackEngine::PlaybackEngine() : mRing(FramesAhead)
+{
+}
+
+/**
+ * Destructor
+ */
+PlaybackEngine::~PlaybackEngine()
+{
+    Stop();
+}
+
+/**
+ * Start preparing frames
+ *
+ * Each machine gets a private copy for the worker to
+ * simulate, and the picture's adapters stop simulating
+ * on their own until Stop is called.
+ * @param picture The picture we are playing
+ * @param startFrame The first frame that will be shown
+ */
+void PlaybackEngine::Start(Picture *picture, int startFrame)
+{
+    Stop();
+
+    auto timeline = picture->GetTimeline();
+
+    mMachines.clear();
+    mSimulations.clear();
+    mOffsets.clear();
+    for (auto machine : picture->GetMachines())
+    {
+        auto simulation = machine->CreateSimulation();
+        if (simulation == nullptr)
+        {
+            // This machine system cannot snapshot its state,
+            // so it keeps simulating on its own
+            continue;
+        }
+
+        simulation->SetFrameRate(timeline->GetFrameRate());
+
+        mMachines.push_back(machine);
+        mSimulations.push_back(simulation);
+        mOffsets.push_back(machine->GetFrameOffset());
+        machine->SetExternallyDriven(true);
+    }
+
+    mNextFrame = startFrame;
+    mLastFrame = timeline->GetNumFrames();
+    mStatistics = Statistics();
+
+    mRunning = true;
+    mThread = std::thread(&PlaybackEngine::Run, this);
+}
+
+/**
+ * Stop preparing frames
+ *
+ * The machine adapters go back to simulating on their own.
+ * The state they were last shown is only a snapshot of the
+ * bodies, so they simulate again from the start rather than
+ * step on from it and drift from what playback showed.
+ */
+void PlaybackEngine::Stop()
+{
+    if (!mThread.joinable())
+    {
+        return;
+    }
+
+    mRunning = false;
+    mThread.join();
+    mRing.Clear();
+
+    for (auto machine : mMachines)
+    {
+        machine->SetExternallyDriven(false);
+    }
+
+    mMachines.clear();
+    mSimulations.clear();
+}
+
+/**
+ * The worker thread.
+ *
+ * Steps the worker's machines one frame at a time and
+ * queues their states until the ring is full.
+ */
+void PlaybackEngine::Run()
+{
+    while (mRunning && mNextFrame <= mLastFrame)
+    {
+        if (mRing.IsFull())
+        {
+            std::this_thread::sleep_for(WorkerWait);
+            continue;
+        }
+
+        std::vector<std::shared_ptr<const MachineState>> states;
+        for (size_t i = 0; i < mSimulations.size(); i++)
+        {
+            // Same frame computation as MachineAdapter::GetKeyframe
+            double machineFrame = mNextFrame - mOffsets[i];
+            mSimulations[i]->SetMachineFrame(machineFrame >= 0 ? (int)machineFrame : -1);
+            states.push_back(mSimulations[i]->GetMachineState());
+        }
+
+        mRing.Push(std::make_shared<const Frame>(mNextFrame, std::move(states)));
+        mNextFrame++;
+    }
+}
+
+/**
+ * Give the machines their state for the frame about to be drawn.
+ *
+ * Prepared frames older than this one are skipped. If the
+ * frame is not ready yet, the newest older frame is used
+ * instead and the tick is counted as late.
+ * @param frame The animation frame about to be drawn
+ */
+void PlaybackEngine::Present(int frame)
+{
+    std::shared_ptr<const Frame> best;
+    std::shared_ptr<const Frame> next;
+    while (mRing.Peek(next) && next->GetFrame() <= frame)
+    {
+        mRing.Pop();
+        if (best != nullptr)
+        {
+            mStatistics.mDropped++;
+        }
+
+        best = next;
+    }
+
+    if (best == nullptr || best->GetFrame() != frame)
+    {
+        mStatistics.mLate++;
+    }
+    else
+    {
+        mStatistics.mShown++;
+    }
+
+    if (best == nullptr)
+    {
+        return;
+    }
+
+    auto &states = best->GetMachineStates();
+    for (size_t i = 0; i < states.size() && i < mMachines.size(); i++)
+    {
+        mMachines[i]->SetMachineState(states[i]);
+    }
+}
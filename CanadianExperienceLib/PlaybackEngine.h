@@ -0,0 +1,137 @@
+/**
+ * @file PlaybackEngine.h
+ * @author Thomas Toaz
+ *
+ * Prepares upcoming playback frames on a worker thread.
+ */
+
+#ifndef CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_PLAYBACKENGINE_H
+#define CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_PLAYBACKENGINE_H
+
+#include <atomic>
+#include <thread>
+
+#include "FrameRing.h"
+
+class Picture;
+class MachineAdapter;
+class MachineSystemActual;
+class MachineState;
+
+/**
+ * Prepares upcoming playback frames on a worker thread.
+ *
+ * Stepping the machine physics is the expensive part of
+ * playback. While playing, the worker thread runs its own copy
+ * of each machine ahead of the display and puts an immutable
+ * machine state for each frame into a single-producer/
+ * single-consumer ring. The UI thread takes the state for the
+ * frame it is about to draw and hands it to the machine
+ * adapters, which show it instead of simulating.
+ *
+ * Timeline channels are still evaluated on the UI thread.
+ * They are not thread safe and cost very little.
+ */
+class PlaybackEngine
+{
+public:
+    /**
+     * One prepared frame. Never modified once created.
+     */
+    class Frame
+    {
+    private:
+        /// The animation frame this is for
+        int mFrame;
+
+        /// State of each machine at this frame, in machine order
+        std::vector<std::shared_ptr<const MachineState>> mMachineStates;
+
+    public:
+        /**
+         * Constructor
+         * @param frame The animation frame this is for
+         * @param states State of each machine at this frame
+         */
+        Frame(int frame, std::vector<std::shared_ptr<const MachineState>> states) :
+            mFrame(frame), mMachineStates(std::move(states)) {}
+
+        /**
+         * Get the animation frame this is for
+         * @return Frame number
+         */
+        int GetFrame() const { return mFrame; }
+
+        /**
+         * Get the state of each machine at this frame
+         * @return Machine states in machine order
+         */
+        const std::vector<std::shared_ptr<const MachineState>> &GetMachineStates() const { return mMachineStates; }
+    };
+
+    /// Playback statistics since the last Start
+    struct Statistics
+    {
+        int mShown = 0;     ///< Frames shown on time
+        int mDropped = 0;   ///< Prepared frames skipped because the display had moved past them
+        int mLate = 0;      ///< Display ticks where the needed frame was not ready yet
+    };
+
+private:
+    void Run();
+
+    /// Frames prepared by the worker, waiting to be shown
+    FrameRing<std::shared_ptr<const Frame>> mRing;
+
+    /// The worker thread
+    std::thread mThread;
+
+    /// Set while the worker should keep running
+    std::atomic<bool> mRunning{false};
+
+    /// The machines in the picture we are playing
+    std::vector<std::shared_ptr<MachineAdapter>> mMachines;
+
+    /// The worker's own copy of each machine
+    std::vector<std::shared_ptr<MachineSystemActual>> mSimulations;
+
+    /// Frame offset of each machine
+    std::vector<double> mOffsets;
+
+    /// Next frame the worker will prepare
+    int mNextFrame = 0;
+
+    /// Last frame of the animation
+    int mLastFrame = 0;
+
+    /// Statistics since the last Start
+    Statistics mStatistics;
+
+public:
+    PlaybackEngine();
+    virtual ~PlaybackEngine();
+
+    /// Copy constructor (disabled)
+    PlaybackEngine(const PlaybackEngine &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const PlaybackEngine &) = delete;
+
+    void Start(Picture *picture, int startFrame);
+    void Stop();
+    void Present(int frame);
+
+    /**
+     * Is the engine running?
+     * @return true if frames are being prepared
+     */
+    bool IsRunning() const { return mThread.joinable(); }
+
+    /**
+     * Get the playback statistics since the last Start
+     * @return Statistics
+     */
+    const Statistics &GetStatistics() const { return mStatistics; }
+};
+
+#endif //CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_PLAYBACKENGINE_H
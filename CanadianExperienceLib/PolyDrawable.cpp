@@ -15,24 +15,24 @@ PolyDrawable::PolyDrawable(const std::wstring &name) : Drawable(name)
 }
 
 /**
- * Draw our polygon.
- * @param  graphics The graphics context to draw on
+ * Record drawing our polygon.
+ * @param list Render list to record into
  */
-void PolyDrawable::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void PolyDrawable::Record(RenderList &list)
 {
     if(!mPoints.empty()) {
 
-        mPath = graphics->CreatePath();
-        mPath.MoveToPoint(RotatePoint(mPoints[0], mPlacedR) + mPlacedPosition);
+        mPath = std::make_shared<RenderList::Path>();
+        mPath->MoveToPoint(RotatePoint(mPoints[0], mPlacedR) + mPlacedPosition);
         for (auto i = 1; i<mPoints.size(); i++)
         {
-            mPath.AddLineToPoint(RotatePoint(mPoints[i], mPlacedR) + mPlacedPosition);
+            mPath->AddLineToPoint(RotatePoint(mPoints[i], mPlacedR) + mPlacedPosition);
         }
-        mPath.CloseSubpath();
+        mPath->CloseSubpath();
 
         wxBrush brush(mColor);
-        graphics->SetBrush(brush);
-        graphics->FillPath(mPath);
+        list.SetBrush(brush);
+        list.FillPath(mPath);
     }
 
 
@@ -57,7 +57,7 @@ void PolyDrawable::Draw(std::shared_ptr<wxGraphicsContext> graphics)
  */
 bool PolyDrawable::HitTest(wxPoint pos)
 {
-    return mPath.Contains(pos.x, pos.y);
+    return mPath != nullptr && mPath->Contains(pos.x, pos.y);
 }
 
 
@@ -25,9 +25,9 @@ private:
     /// The array of point objects
     std::vector<wxPoint> mPoints;
 
-    /// The transformed graphics path used
+    /// The transformed path used
     /// to draw this polygon
-    wxGraphicsPath mPath;
+    std::shared_ptr<RenderList::Path> mPath;
 
 public:
     PolyDrawable(const std::wstring& name);
@@ -41,7 +41,7 @@ public:
     /// Assignment operator
     void operator=(const PolyDrawable &) = delete;
 
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void Record(RenderList &list) override;
     bool HitTest(wxPoint pos) override;
 
     void AddPoint(wxPoint point);
@@ -5,8 +5,18 @@
 
 #include "pch.h"
 #include "RotatedBitmap.h"
+#include <image-atlas.h>
+#include <image-memory.h>
+#include <render-image.h>
 
 
+/**
+ * Destructor
+ */
+RotatedBitmap::~RotatedBitmap()
+{
+    ImageMemory::Shared().Forget(this);
+}
 
 /**
  * Load the image from a file.
@@ -14,29 +24,128 @@
  */
 void RotatedBitmap::LoadImage(const std::wstring &filename)
 {
-    mImage = std::make_unique<wxImage>(filename, wxBITMAP_TYPE_ANY);
+    // Small images come from the shared atlas without decoding
+    auto image = ImageAtlas::Shared().GetImage(filename);
+    if(image.IsOk())
+    {
+        mImage = std::make_unique<wxImage>(image);
+    }
+    else
+    {
+        mImage = std::make_unique<wxImage>(filename, wxBITMAP_TYPE_ANY);
+    }
+
+    mFilename = filename;
+    mSize = mImage->GetSize();
+    mBitmapCreated = false;
+    mPixels = nullptr;
     mLoaded = true;
+
+    RecordMemory();
+}
+
+/**
+ * Record the pixels this bitmap holds in the shared ImageMemory
+ */
+void RotatedBitmap::RecordMemory()
+{
+    size_t bytes = 0;
+    if(mImage != nullptr)
+    {
+        bytes += ImageMemory::ImageBytes(mSize.GetWidth(), mSize.GetHeight(), mImage->HasAlpha());
+    }
+
+    if(mPixels != nullptr)
+    {
+        bytes += mPixels->GetBytes();
+    }
+
+    ImageMemory::Shared().Record(this, mFilename, bytes);
 }
 
 
 /**
- * Draw the bitmap
- * @param graphics The graphics context to draw on
+ * Record drawing the bitmap
+ * @param list Render list to record into
  * @param position The position to draw at
  * @param angle The rotation angle
  */
-void RotatedBitmap::DrawImage(std::shared_ptr<wxGraphicsContext> graphics, wxPoint position, double angle)
+void RotatedBitmap::RecordImage(RenderList &list, wxPoint position, double angle)
+{
+    list.PushState();
+    list.Translate(position.x, position.y);
+    list.Rotate(-angle);
+    list.DrawBitmap(mFilename, [this](std::shared_ptr<wxGraphicsContext> graphics) { return GetBitmap(graphics); },
+            [this](double) { return GetPixels(); },
+            -mCenter.x, -mCenter.y, mSize.GetWidth(), mSize.GetHeight());
+
+    list.PopState();
+}
+
+/**
+ * Get the bitmap to draw, creating it if needed
+ * @param graphics Graphics context the bitmap is for
+ * @return Graphics bitmap
+ */
+wxGraphicsBitmap RotatedBitmap::GetBitmap(std::shared_ptr<wxGraphicsContext> graphics)
 {
     if(!mBitmapCreated)
     {
-        mBitmap = graphics->CreateBitmapFromImage(*mImage);
+        // An image in the atlas shares the bitmap of its page
+        mBitmap = ImageAtlas::Shared().GetBitmap(graphics, mFilename);
+        if(mBitmap.IsNull())
+        {
+            mBitmap = graphics->CreateBitmapFromImage(*mImage);
+        }
+
+        mBitmapCreated = true;
+    }
+
+    if(mImage != nullptr && ImageMemory::Shared().IsReleasePixels())
+    {
+        mImage = nullptr;
+        RecordMemory();
     }
 
-    graphics->PushState();
-    graphics->Translate(position.x, position.y);
-    graphics->Rotate(-angle);
-    graphics->DrawBitmap(mBitmap, -mCenter.x, -mCenter.y,
-            mImage->GetWidth(), mImage->GetHeight());
+    return mBitmap;
+}
 
-    graphics->PopState();
-}
\ No newline at end of file
+/**
+ * Get the pixels to draw with a Renderer, making them if needed.
+ *
+ * If the decoded image was released it is decoded again. The
+ * pixels are kept like the bitmap, so when pixels are being
+ * released only the decoded image is released.
+ * @return Pixels with premultiplied alpha
+ */
+std::shared_ptr<const RenderImage> RotatedBitmap::GetPixels()
+{
+    bool changed = false;
+    if(mPixels == nullptr)
+    {
+        if(mImage != nullptr)
+        {
+            mPixels = RenderList::MakeImage(*mImage);
+        }
+        else
+        {
+            auto image = ImageAtlas::Shared().GetImage(mFilename);
+            mPixels = RenderList::MakeImage(image.IsOk() ? image : wxImage(mFilename, wxBITMAP_TYPE_ANY));
+        }
+
+        changed = true;
+    }
+
+    if(mImage != nullptr && ImageMemory::Shared().IsReleasePixels())
+    {
+        mImage = nullptr;
+        changed = true;
+    }
+
+    if(changed)
+    {
+        RecordMemory();
+    }
+
+    return mPixels;
+}
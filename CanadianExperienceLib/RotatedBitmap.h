@@ -8,30 +8,49 @@
 #ifndef CANADIANEXPERIENCE_ROTATEDBITMAP_H
 #define CANADIANEXPERIENCE_ROTATEDBITMAP_H
 
+#include <render-list.h>
+
 /**
  * Basic class for displaying a rotated bitmap
  */
 class RotatedBitmap {
 private:
-    /// The image for this drawable
+    /// The image for this drawable, released after the bitmap
+    /// is created if ImageMemory says so
     std::unique_ptr<wxImage> mImage;
 
+    /// Size of the image in pixels
+    wxSize mSize;
+
     /// The graphics bitmap we will use
     wxGraphicsBitmap mBitmap;
 
     /// Has mBitmap been created?
     bool mBitmapCreated = false;
 
+    /// Pixels for drawing with a Renderer, made when first needed
+    /// and kept as mBitmap is
+    std::shared_ptr<const RenderImage> mPixels;
+
+    /// The file the image was loaded from
+    std::wstring mFilename;
+
     /// The center of the image
     wxPoint mCenter = wxPoint(0, 0);
 
     /// Has an image been loaded?
     bool mLoaded = false;
 
+    wxGraphicsBitmap GetBitmap(std::shared_ptr<wxGraphicsContext> graphics);
+    std::shared_ptr<const RenderImage> GetPixels();
+    void RecordMemory();
+
 public:
     /// Constructor
     RotatedBitmap() {}
 
+    ~RotatedBitmap();
+
     /** Copy constructor disabled */
     RotatedBitmap(const RotatedBitmap&) = delete;
 
@@ -40,7 +59,7 @@ public:
 
     void LoadImage(const std::wstring& filename);
 
-    void DrawImage(std::shared_ptr<wxGraphicsContext> graphics, wxPoint position, double angle);
+    void RecordImage(RenderList &list, wxPoint position, double angle);
 
     /**
      * Set the center to rotate around
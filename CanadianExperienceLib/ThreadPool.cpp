@@ -0,0 +1,113 @@
+/**
+ * @file ThreadPool.cpp
+ * @author Thomas Toaz
+ */
+
+#include "pch.h"
+#include "ThreadPool.h"
+
+/**
+ * Constructor
+ * @param numThreads Number of worker threads, at least one is used
+ */
+ThreadPool::ThreadPool(unsigned numThreads) : mNumThreads(std::max(1u, numThreads))
+{
+}
+
+/**
+ * Destructor
+ *
+ * Waiting tasks are still run before the workers exit.
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+
+    mCondition.notify_all();
+    for (auto &thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * Submit a task to be run on a worker thread
+ * @param task Task to run
+ * @return Future that becomes ready when the task has run
+ */
+std::future<void> ThreadPool::Submit(std::function<void()> task)
+{
+    std::packaged_task<void()> packaged(std::move(task));
+    auto future = packaged.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mThreads.empty())
+        {
+            for (unsigned i = 0; i < mNumThreads; i++)
+            {
+                mThreads.emplace_back(&ThreadPool::Work, this);
+            }
+        }
+
+        mTasks.push_back(std::move(packaged));
+    }
+
+    mCondition.notify_one();
+    return future;
+}
+
+/**
+ * Run a set of tasks and wait for all of them to finish.
+ *
+ * The calling thread runs the first task itself. Any
+ * exception thrown by a task is rethrown here.
+ * @param tasks Tasks to run
+ */
+void ThreadPool::RunAll(const std::vector<std::function<void()>> &tasks)
+{
+    if (tasks.empty())
+    {
+        return;
+    }
+
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < tasks.size(); i++)
+    {
+        futures.push_back(Submit(tasks[i]));
+    }
+
+    tasks[0]();
+
+    for (auto &future : futures)
+    {
+        future.get();
+    }
+}
+
+/**
+ * Worker thread loop
+ */
+void ThreadPool::Work()
+{
+    while (true)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+            if (mTasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(mTasks.front());
+            mTasks.pop_front();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * @file ThreadPool.h
+ * @author Thomas Toaz
+ *
+ * Fixed set of worker threads that run submitted tasks.
+ */
+
+#ifndef CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_THREADPOOL_H
+#define CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+/**
+ * Fixed set of worker threads that run submitted tasks.
+ *
+ * Workers are started on the first Submit, so a pool
+ * that is never used costs nothing.
+ */
+class ThreadPool
+{
+private:
+    void Work();
+
+    /// Number of worker threads to start
+    unsigned mNumThreads;
+
+    /// The worker threads
+    std::vector<std::thread> mThreads;
+
+    /// Tasks waiting for a worker
+    std::deque<std::packaged_task<void()>> mTasks;
+
+    /// Protects mTasks and mStopping
+    std::mutex mMutex;
+
+    /// Signals workers that a task is waiting or the pool is stopping
+    std::condition_variable mCondition;
+
+    /// Set when the workers should exit
+    bool mStopping = false;
+
+public:
+    explicit ThreadPool(unsigned numThreads = std::thread::hardware_concurrency());
+    virtual ~ThreadPool();
+
+    /// Copy constructor (disabled)
+    ThreadPool(const ThreadPool &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ThreadPool &) = delete;
+
+    std::future<void> Submit(std::function<void()> task);
+    void RunAll(const std::vector<std::function<void()>> &tasks);
+};
+
+#endif //CANADIANEXPERIENCE_CANADIANEXPERIENCELIB_THREADPOOL_H
@@ -17,12 +17,116 @@ Timeline::Timeline()
 
 /**
  * Add an animation channel to the timeline
+ *
+ * Channel names must be unique, since that is how they are
+ * found when an animation is loaded. If a channel with the same
+ * name already exists, the new channel is renamed with an
+ * occurrence suffix (see DuplicateName).
  * @param channel Channel to add
+ * @return Id for the channel, stable until the channel is removed
  */
-void Timeline::AddChannel(AnimChannel *channel)
+int Timeline::AddChannel(AnimChannel *channel)
 {
+    auto name = channel->GetName();
+    auto existing = mChannelIndex.find(name);
+    if (existing != mChannelIndex.end())
+    {
+        if (mChannels[existing->second] == channel)
+        {
+            // Already in this timeline
+            return existing->second;
+        }
+
+        int occurrence = 2;
+        while (mChannelIndex.find(DuplicateName(name, occurrence)) != mChannelIndex.end())
+        {
+            occurrence++;
+        }
+
+        name = DuplicateName(name, occurrence);
+        channel->SetName(name);
+    }
+
+    int id = (int)mChannels.size();
     mChannels.push_back(channel);
+    mChannelIndex[name] = id;
     channel->SetTimeline(this);
+
+    return id;
+}
+
+
+/**
+ * Remove an animation channel from the timeline
+ *
+ * The ids of the other channels are not affected.
+ * @param channel Channel to remove
+ */
+void Timeline::RemoveChannel(AnimChannel *channel)
+{
+    auto loc = mChannelIndex.find(channel->GetName());
+    if (loc == mChannelIndex.end() || mChannels[loc->second] != channel)
+    {
+        return;
+    }
+
+    mChannels[loc->second] = nullptr;
+    mChannelIndex.erase(loc);
+    channel->SetTimeline(nullptr);
+}
+
+
+/**
+ * Get the id of a channel by name
+ * @param name Channel name
+ * @return Channel id or -1 if there is no such channel
+ */
+int Timeline::GetChannelId(const std::wstring &name) const
+{
+    auto loc = mChannelIndex.find(name);
+    return loc != mChannelIndex.end() ? loc->second : -1;
+}
+
+
+/**
+ * Get a channel by id
+ * @param id Channel id
+ * @return Channel or nullptr if the id is not valid
+ */
+AnimChannel *Timeline::GetChannel(int id) const
+{
+    if (id < 0 || id >= (int)mChannels.size())
+    {
+        return nullptr;
+    }
+
+    return mChannels[id];
+}
+
+
+/**
+ * Get a channel by name
+ * @param name Channel name
+ * @return Channel or nullptr if there is no such channel
+ */
+AnimChannel *Timeline::GetChannel(const std::wstring &name) const
+{
+    return GetChannel(GetChannelId(name));
+}
+
+
+/**
+ * Name given to a channel that duplicates an existing name.
+ *
+ * Both machine actors are named "Machine", for example, so the
+ * second one's channels become "Machine:position#2" and so on.
+ * @param name The original channel name
+ * @param occurrence Which occurrence of the name this is (2 or more)
+ * @return Unique channel name
+ */
+std::wstring Timeline::DuplicateName(const std::wstring &name, int occurrence)
+{
+    return name + L"#" + std::to_wstring(occurrence);
 }
 
 
@@ -39,7 +143,10 @@ void Timeline::SetCurrentTime(double t)
 
     for (auto channel : mChannels)
     {
-        channel->SetFrame(GetCurrentFrame());
+        if (channel != nullptr)
+        {
+            channel->SetFrame(GetCurrentFrame());
+        }
     }
 }
 
@@ -51,7 +158,34 @@ void Timeline::ClearKeyframe()
 {
     for (auto channel : mChannels)
     {
-        channel->ClearKeyframe();
+        if (channel != nullptr)
+        {
+            channel->ClearKeyframe();
+        }
+    }
+}
+
+/**
+ * Get the frames a keyframe change at a given frame can affect.
+ *
+ * This is the union of the spans for every channel.
+ * @param frame Frame the keyframe change is at
+ * @param first Receives the first frame affected
+ * @param last Receives the last frame affected
+ */
+void Timeline::GetKeyframeSpan(int frame, int &first, int &last) const
+{
+    first = frame;
+    last = frame;
+    for (auto channel : mChannels)
+    {
+        if (channel != nullptr)
+        {
+            int channelFirst, channelLast;
+            channel->GetKeyframeSpan(frame, channelFirst, channelLast);
+            first = std::min(first, channelFirst);
+            last = channelLast < 0 ? mNumFrames : std::max(last, channelLast);
+        }
     }
 }
 
@@ -67,7 +201,10 @@ void Timeline::Save(wxXmlNode* root)
 
     for (auto channel : mChannels)
     {
-       channel->XmlSave(root);
+        if (channel != nullptr)
+        {
+            channel->XmlSave(root);
+        }
     }
 }
 
@@ -86,6 +223,9 @@ void Timeline::Load(wxXmlNode* root)
     mNumFrames = wxAtoi(root->GetAttribute(L"numframes", L"300"));
     mFrameRate = wxAtoi(root->GetAttribute(L"framerate", L"30"));
 
+    // How many times each channel name has appeared in the file
+    std::unordered_map<std::wstring, int> occurrences;
+
     //
     // Traverse the children of the root
     // node of the XML document in memory!!!!
@@ -96,7 +236,7 @@ void Timeline::Load(wxXmlNode* root)
         auto name = child->GetName();
         if(name == L"channel")
         {
-            XmlChannel(child);
+            XmlChannel(child, occurrences);
         }
     }
 
@@ -105,22 +245,29 @@ void Timeline::Load(wxXmlNode* root)
 
 /**
  * Handle the "channel" XML tag.
+ *
+ * Files saved before channel names were made unique can contain
+ * the same name more than once. The second and later occurrences
+ * are matched to the renamed duplicate channels.
  * @param node Node that is the channel tag.
+ * @param occurrences Count of the channel names seen so far in this file
  */
-void Timeline::XmlChannel(wxXmlNode* node)
+void Timeline::XmlChannel(wxXmlNode* node, std::unordered_map<std::wstring, int> &occurrences)
 {
     // Get the channel name
-    auto name = node->GetAttribute(L"name", L"");
+    std::wstring name = node->GetAttribute(L"name", L"").ToStdWstring();
 
-    // Find the channel
-    for (auto channel : mChannels)
+    int occurrence = ++occurrences[name];
+    if (occurrence > 1)
     {
-        if (channel->GetName() == name)
-        {
-            // We found it, let it handle it
-            channel->XmlLoad(node);
-            break;
-        }
+        name = DuplicateName(name, occurrence);
+    }
+
+    // Find the channel and let it handle it
+    auto channel = GetChannel(name);
+    if (channel != nullptr)
+    {
+        channel->XmlLoad(node);
     }
 }
 
@@ -138,6 +285,9 @@ void Timeline::Clear()
 
     for (auto channel : mChannels)
     {
-        channel->Clear();
+        if (channel != nullptr)
+        {
+            channel->Clear();
+        }
     }
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #ifndef CANADIANEXPERIENCE_TIMELINE_H
 #define CANADIANEXPERIENCE_TIMELINE_H
 
+#include <unordered_map>
+
 class AnimChannel;
 
 /**
@@ -19,15 +21,20 @@ class AnimChannel;
  */
 class Timeline {
 private:
-    void XmlChannel(wxXmlNode* node);
+    void XmlChannel(wxXmlNode* node, std::unordered_map<std::wstring, int> &occurrences);
+    static std::wstring DuplicateName(const std::wstring &name, int occurrence);
 
     int mNumFrames = 300;       ///< Number of frames in the animation
     int mFrameRate = 30;        ///< Animation frame rate in frames per second
     double mCurrentTime = 0;    ///< The current animation time
 
-    /// List of all animation channels
+    /// List of all animation channels, indexed by channel id.
+    /// Removed channels leave a nullptr so the remaining ids stay stable.
     std::vector<AnimChannel *> mChannels;
 
+    /// Index from channel name to channel id
+    std::unordered_map<std::wstring, int> mChannelIndex;
+
 public:
     Timeline();
 
@@ -86,7 +93,26 @@ public:
 
     void ClearKeyframe();
 
-    void AddChannel(AnimChannel* channel);
+    void GetKeyframeSpan(int frame, int &first, int &last) const;
+
+    int AddChannel(AnimChannel* channel);
+
+    void RemoveChannel(AnimChannel* channel);
+
+    int GetChannelId(const std::wstring &name) const;
+
+    AnimChannel *GetChannel(int id) const;
+
+    AnimChannel *GetChannel(const std::wstring &name) const;
+
+    /**
+     * Get the number of channel ids that have been issued.
+     *
+     * Ids run from 0 to this value - 1. Ids of removed
+     * channels are not reused and map to nullptr.
+     * @return Number of channel ids
+     */
+    int GetNumChannelIds() const { return (int)mChannels.size(); }
 
     void Save(wxXmlNode* root);
 
@@ -43,7 +43,23 @@ ViewEdit::ViewEdit(wxFrame* parent) :wxScrolledCanvas(parent, wxID_ANY)
  */
 void ViewEdit::UpdateObserver()
 {
-    Refresh();
+    UpdateObserverChanges(PictureObserver::AllChanges);
+}
+
+/**
+ * Update this window when the picture changes.
+ *
+ * Refresh only invalidates the window, so any number of
+ * changes before the next paint cost a single repaint.
+ * Timeline property changes do not alter the scene.
+ * @param changes What changed in the picture
+ */
+void ViewEdit::UpdateObserverChanges(int changes)
+{
+    if (changes & (PictureObserver::Scene | PictureObserver::Time))
+    {
+        Refresh();
+    }
 }
 
 
@@ -65,10 +81,56 @@ void ViewEdit::OnPaint(wxPaintEvent& event)
     dc.SetBackground(background);
     dc.Clear();
 
+    auto picture = GetPicture();
+    auto cache = picture->GetFrameCache();
+    if (cache->IsPreviewing())
+    {
+        PaintPreview(&dc, background);
+        return;
+    }
+
     // Create a graphics context
     auto graphics = std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create( dc ));
 
-    GetPicture()->Draw(graphics);
+    picture->Draw(graphics);
+}
+
+/**
+ * Paint the current frame while previewing.
+ *
+ * A frame already in the picture's frame cache is shown from
+ * there. Otherwise the picture is drawn into a bitmap, which is
+ * shown and added to the cache.
+ * @param dc Device context to paint on
+ * @param background Background brush for the picture
+ */
+void ViewEdit::PaintPreview(wxDC *dc, const wxBrush &background)
+{
+    auto picture = GetPicture();
+    auto cache = picture->GetFrameCache();
+    auto size = picture->GetSize();
+    int frame = picture->GetTimeline()->GetCurrentFrame();
+
+    auto image = cache->Find(frame);
+    if (image.IsOk())
+    {
+        auto graphics = std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create(*dc));
+        graphics->DrawBitmap(wxBitmap(image), 0, 0, size.GetWidth(), size.GetHeight());
+        return;
+    }
+
+    wxBitmap bitmap(size.GetWidth(), size.GetHeight());
+    wxMemoryDC memoryDC(bitmap);
+    memoryDC.SetBackground(background);
+    memoryDC.Clear();
+
+    auto graphics = std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create(memoryDC));
+    picture->Draw(graphics);
+    graphics = nullptr;
+    memoryDC.SelectObject(wxNullBitmap);
+
+    dc->DrawBitmap(bitmap, 0, 0);
+    cache->Add(frame, bitmap.ConvertToImage());
 }
 
 /**
@@ -144,7 +206,7 @@ void ViewEdit::OnMouseMove(wxMouseEvent &event)
                 {
                     mSelectedActor->SetPosition(mSelectedActor->GetPosition() + delta);
                 }
-                GetPicture()->UpdateObservers();
+                GetPicture()->UpdateObservers(PictureObserver::Scene);
             }
             break;
 
@@ -152,7 +214,7 @@ void ViewEdit::OnMouseMove(wxMouseEvent &event)
             if (mSelectedDrawable != nullptr)
             {
                 mSelectedDrawable->SetRotation(mSelectedDrawable->GetRotation() + delta.y * RotationScaling);
-                GetPicture()->UpdateObservers();
+                GetPicture()->UpdateObservers(PictureObserver::Scene);
             }
             break;
 
@@ -229,5 +291,7 @@ void ViewEdit::OnEditMachines(wxCommandEvent &event)
         }
 
     }
+
+    GetPicture()->UpdateObservers(PictureObserver::Scene);
 }
 
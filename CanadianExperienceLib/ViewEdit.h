@@ -26,6 +26,7 @@ private:
     void OnLeftUp(wxMouseEvent& event);
     void OnMouseMove(wxMouseEvent& event);
     void OnPaint(wxPaintEvent& event);
+    void PaintPreview(wxDC *dc, const wxBrush &background);
 
     void OnEditMove(wxCommandEvent& event);
     void OnEditRotate(wxCommandEvent& event);
@@ -53,6 +54,7 @@ public:
     ViewEdit(wxFrame* parent);
 
     void UpdateObserver() override;
+    void UpdateObserverChanges(int changes) override;
 
 
 };
@@ -7,12 +7,15 @@
 
 #include <wx/dcbuffer.h>
 #include <wx/xrc/xmlres.h>
-#include <sstream>
+#include <wx/progdlg.h>
 
 #include "ViewTimeline.h"
 #include "TimelineDlg.h"
 #include "Picture.h"
 #include "Actor.h"
+#include "FrameExporter.h"
+
+#include <text-cache.h>
 
 /// Y location for the top of a tick mark
 const int TickTop = 15;
@@ -35,9 +38,16 @@ const int BorderLeft = 10;
 /// Space to the right of the scale
 const int BorderRight = 10;
 
+/// Extra space in pixels drawn on each side of the visible
+/// ruler so labels that straddle the window edge are complete
+const int LabelMargin = 50;
+
 /// Filename for the pointer image
 const std::wstring PointerImageFile = L"/pointer.png";
 
+/// Width of frames exported at 4K
+const double ExportWidth4K = 3840;
+
 
 /**
  * Constructor
@@ -54,6 +64,7 @@ ViewTimeline::ViewTimeline(wxFrame* parent, std::wstring imagesDir) :
     SetBackgroundStyle(wxBG_STYLE_PAINT);
 
     mPointerImage = std::make_unique<wxImage>(imagesDir + PointerImageFile, wxBITMAP_TYPE_ANY);
+    mTickFont = wxFont(wxSize(0, TickFontSize), wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
 
     Bind(wxEVT_PAINT, &ViewTimeline::OnPaint, this);
     Bind(wxEVT_LEFT_DOWN, &ViewTimeline::OnLeftDown, this);
@@ -63,6 +74,7 @@ ViewTimeline::ViewTimeline(wxFrame* parent, std::wstring imagesDir) :
 
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &ViewTimeline::OnFileSaveAs, this, wxID_SAVEAS);
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &ViewTimeline::OnFileOpen, this, wxID_OPEN);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &ViewTimeline::OnFileExportFrames, this, XRCID("FileExportFrames"));
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &ViewTimeline::OnEditTimelineProperties, this, XRCID("EditTimelineProperties"));
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &ViewTimeline::OnEditSetKeyframe, this, XRCID("EditSetKeyframe"));
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &ViewTimeline::OnEditDeleteKeyframe, this, XRCID("EditDeleteKeyframe"));
@@ -80,28 +92,68 @@ ViewTimeline::ViewTimeline(wxFrame* parent, std::wstring imagesDir) :
  */
 void ViewTimeline::UpdateObserver()
 {
-    Refresh();
-    Update();
+    UpdateObserverChanges(PictureObserver::AllChanges);
+}
+
+/**
+ * Update this window when the picture changes.
+ *
+ * The timeline only shows the time and the timeline
+ * properties, so scene edits such as dragging an actor
+ * are ignored. Refresh only invalidates the window, so
+ * changes coalesce into one repaint per idle tick.
+ * @param changes What changed in the picture
+ */
+void ViewTimeline::UpdateObserverChanges(int changes)
+{
+    if (changes & (PictureObserver::Time | PictureObserver::TimelineProperties))
+    {
+        Refresh();
+    }
 }
 
 /**
  * Paint event, draws the window.
+ *
+ * The ruler only changes when the timeline properties, the
+ * scroll position or the window size change, so it is drawn
+ * into a cached bitmap. Each paint blits that bitmap and
+ * draws the pointer on top of it.
  * @param event Paint event object
  */
 void ViewTimeline::OnPaint(wxPaintEvent& event)
 {
     // Get the timeline
     Timeline *timeline = GetPicture()->GetTimeline();
-    int sizeTotal = timeline->GetNumFrames() * TickSpacing + BorderLeft + BorderRight, WindowHeight;
+    int sizeTotal = timeline->GetNumFrames() * TickSpacing + BorderLeft + BorderRight;
     SetVirtualSize(sizeTotal, 0);
     SetScrollRate(1, 0);
 
     wxAutoBufferedPaintDC dc(this);
     DoPrepareDC(dc);
 
-    wxBrush background(*wxWHITE);
-    dc.SetBackground(background);
-    dc.Clear();
+    auto rect = GetClientRect();
+    int hit = rect.GetHeight();
+    int wid = rect.GetWidth();
+    if (wid <= 0 || hit <= 0)
+    {
+        return;
+    }
+
+    // Where the visible part of the window is in the scrolled area
+    int left = CalcUnscrolledPosition(wxPoint(0, 0)).x;
+
+    if (!mRulerBitmap.IsOk() ||
+            mRulerBitmap.GetWidth() != wid ||
+            mRulerBitmap.GetHeight() != hit ||
+            mRulerLeft != left ||
+            mRulerFrameRate != timeline->GetFrameRate() ||
+            mRulerNumFrames != timeline->GetNumFrames())
+    {
+        DrawRuler(timeline, left, wid, hit);
+    }
+
+    dc.DrawBitmap(mRulerBitmap, left, 0);
 
     // Create a graphics context
     auto graphics = std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create( dc ));
@@ -111,54 +163,80 @@ void ViewTimeline::OnPaint(wxPaintEvent& event)
         mPointerBitmap = graphics->CreateBitmapFromImage(*mPointerImage);
     }
 
-    auto rect = GetClientRect();
-    int hit = rect.GetHeight();
-    int wid = rect.GetWidth();
-
-    wxFont font(wxSize(0, TickFontSize),
-            wxFONTFAMILY_SWISS,
-            wxFONTSTYLE_NORMAL,
-            wxFONTWEIGHT_NORMAL);
-    graphics->SetFont(font, *wxBLACK);
-    graphics->SetPen(*wxBLACK_PEN);
+    //
+    // Draw the pointer
+    //
+    int pw = mPointerImage->GetWidth();
+    int ph = mPointerImage->GetHeight();
+    int x = BorderLeft + (int)(timeline->GetCurrentTime() * timeline->GetFrameRate() * TickSpacing);
+    graphics->DrawBitmap(mPointerBitmap,
+            x - pw / 2, TickTop,
+            pw, ph
+    );
+}
 
-    int top = TickTop;
+/**
+ * Draw the visible part of the ruler into mRulerBitmap
+ *
+ * Only the ticks that fall within the window (plus enough
+ * margin for a label that straddles the edge) are drawn, so
+ * the cost does not depend on the length of the animation.
+ * @param timeline The timeline we are drawing the ruler for
+ * @param left Scrolled x position of the left edge of the window
+ * @param width Window width in pixels
+ * @param height Window height in pixels
+ */
+void ViewTimeline::DrawRuler(Timeline *timeline, int left, int width, int height)
+{
+    mRulerBitmap = wxBitmap(width, height);
+    mRulerLeft = left;
+    mRulerFrameRate = timeline->GetFrameRate();
+    mRulerNumFrames = timeline->GetNumFrames();
 
+    wxMemoryDC dc(mRulerBitmap);
+    dc.SetBackground(*wxWHITE_BRUSH);
+    dc.Clear();
 
-    for (int tickNum = 0; tickNum <= timeline->GetNumFrames(); tickNum++)
     {
-        int x = BorderLeft + tickNum * TickSpacing;
-        int bottom = top + TickShort;
+        auto graphics = std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create(dc));
+        graphics->Translate(-left, 0);
 
-        bool onSecond = (tickNum % timeline->GetFrameRate()) == 0;
-        if (onSecond)
+        graphics->SetPen(*wxBLACK_PEN);
+        auto &textCache = TextCache::Shared();
+
+        int top = TickTop;
+
+        // Range of ticks that can be seen in the window
+        int firstTick = std::max(0, (left - BorderLeft - LabelMargin) / TickSpacing);
+        int lastTick = std::min(mRulerNumFrames,
+                (left + width - BorderLeft + LabelMargin) / TickSpacing + 1);
+
+        // All of the ticks are stroked as a single path
+        auto ticks = graphics->CreatePath();
+
+        for (int tickNum = firstTick; tickNum <= lastTick; tickNum++)
         {
-            bottom = top + TickLong;
+            int x = BorderLeft + tickNum * TickSpacing;
+            int bottom = top + TickShort;
 
-            // Convert the tick number to seconds in a string
-            std::wstringstream str;
-            str << tickNum / timeline->GetFrameRate();
-            std::wstring wstr = str.str();
+            bool onSecond = (tickNum % mRulerFrameRate) == 0;
+            if (onSecond)
+            {
+                bottom = top + TickLong;
 
-            double w, h;
-            graphics->GetTextExtent(wstr, &w, &h);
+                // The seconds label, centered, from the text cache
+                std::wstring wstr = std::to_wstring(tickNum / mRulerFrameRate);
+                textCache.Draw(graphics, mTickFont, wstr, *wxBLACK, x, bottom + 5, 0.5);
+            }
 
-            graphics->DrawText(wstr, x - w / 2, bottom + 5);
+            ticks.MoveToPoint(x, bottom);
+            ticks.AddLineToPoint(x, top);
         }
 
-        graphics->StrokeLine(x, bottom, x, top);
+        graphics->StrokePath(ticks);
     }
 
-    //
-    // Draw the pointer
-    //
-    int pw = mPointerImage->GetWidth();
-    int ph = mPointerImage->GetHeight();
-    int x = BorderLeft + (int)(timeline->GetCurrentTime() * timeline->GetFrameRate() * TickSpacing);
-    graphics->DrawBitmap(mPointerBitmap,
-            x - pw / 2, top,
-            pw, ph
-    );
+    dc.SelectObject(wxNullBitmap);
 }
 
 /**
@@ -176,6 +254,11 @@ void ViewTimeline::OnLeftDown(wxMouseEvent &event)
     int pointerX = (int)(timeline->GetCurrentTime() * timeline->GetFrameRate() * TickSpacing + BorderLeft);
 
     mMovingPointer = x >= pointerX - (int)mPointerImage->GetWidth() / 2 && x <= pointerX + (int)mPointerImage->GetWidth() / 2;
+    if (mMovingPointer && mPlaying)
+    {
+        // Dragging the pointer takes over from playback
+        Stop();
+    }
 }
 
 /**
@@ -228,7 +311,7 @@ void ViewTimeline::OnEditTimelineProperties(wxCommandEvent& event)
     TimelineDlg dlg(this->GetParent(), GetPicture()->GetTimeline());
     if(dlg.ShowModal() == wxID_OK)
     {
-        GetPicture()->UpdateObservers();
+        GetPicture()->UpdateObservers(PictureObserver::TimelineProperties);
     }
 }
 
@@ -243,6 +326,8 @@ void ViewTimeline::OnEditSetKeyframe(wxCommandEvent& event)
     {
         actor->SetKeyframe();
     }
+
+    picture->InvalidateKeyframe(picture->GetTimeline()->GetCurrentFrame());
 }
 
 /**
@@ -254,6 +339,7 @@ void ViewTimeline::OnEditDeleteKeyframe(wxCommandEvent& event)
     auto picture = GetPicture();
 
     picture->GetTimeline()->ClearKeyframe();
+    picture->InvalidateKeyframe(picture->GetTimeline()->GetCurrentFrame());
     picture->SetAnimationTime(picture->GetAnimationTime());
 }
 
@@ -274,6 +360,9 @@ void ViewTimeline::OnPlayPlay(wxCommandEvent& event)
     auto frameRate = timeline->GetFrameRate();
     auto time = timeline->GetCurrentTime();
 
+    mPlaying = true;
+    GetPicture()->GetFrameCache()->SetPreviewing(true);
+    mPlaybackEngine.Start(GetPicture(), timeline->GetCurrentFrame());
     mStopWatch.Start(lround(time * 1000));
     mTimer.Start(1000 / frameRate);
 }
@@ -295,6 +384,9 @@ void ViewTimeline::OnPlayPlayFromBeginning(wxCommandEvent& event)
 
     auto frameRate = timeline->GetFrameRate();
 
+    mPlaying = true;
+    GetPicture()->GetFrameCache()->SetPreviewing(true);
+    mPlaybackEngine.Start(GetPicture(), 0);
     mStopWatch.Start(0);
     mTimer.Start(1000 / frameRate);
 }
@@ -320,12 +412,19 @@ void ViewTimeline::OnTimer(wxTimerEvent& event)
     auto newTime = mStopWatch.Time() / 1000.0;
     auto frameRate = timeline->GetFrameRate();
 
-    int frame = (int)lround(newTime * frameRate);
+    // Truncated the same way as Timeline::GetCurrentFrame,
+    // so the frame presented is the one the picture draws
+    int frame = int(newTime * frameRate);
     if(frame >= timeline->GetNumFrames())
     {
-        frame = timeline->GetNumFrames();
         Stop();
     }
+    else
+    {
+        // Hand the prepared machine states to the machines
+        // before the picture asks them for this frame
+        mPlaybackEngine.Present(frame);
+    }
 
     GetPicture()->SetAnimationTime(newTime);
 }
@@ -339,6 +438,15 @@ void ViewTimeline::Stop()
     mPlaying = false;
     mTimer.Stop();
     mStopWatch.Pause();
+    GetPicture()->GetFrameCache()->SetPreviewing(false);
+
+    if (mPlaybackEngine.IsRunning())
+    {
+        auto &statistics = mPlaybackEngine.GetStatistics();
+        wxLogStatus(L"Played %d frames, %d dropped, %d late",
+                statistics.mShown, statistics.mDropped, statistics.mLate);
+        mPlaybackEngine.Stop();
+    }
 }
 
 
@@ -359,6 +467,68 @@ void ViewTimeline::OnFileSaveAs(wxCommandEvent& event)
     GetPicture()->Save(filename);
 }
 
+/**
+ * File>Export Frames menu handler
+ * @param event Menu event
+ */
+void ViewTimeline::OnFileExportFrames(wxCommandEvent& event)
+{
+    FrameExporter exporter(GetPicture());
+
+    // Scale and supersampling of each choice
+    auto size = GetPicture()->GetSize();
+    const double scales[] = {1, 1, 2, ExportWidth4K / size.GetWidth()};
+    const int supersamples[] = {1, 4, 2, 2};
+    wxArrayString choices;
+    for (int i = 0; i < 4; i++)
+    {
+        exporter.SetScale(scales[i]);
+        auto frameSize = exporter.GetFrameSize();
+        auto choice = wxString::Format(L"%d x %d", frameSize.GetWidth(), frameSize.GetHeight());
+        if (supersamples[i] > 1)
+        {
+            choice += wxString::Format(L", %dx supersampled", supersamples[i]);
+        }
+
+        choices.Add(choice);
+    }
+
+    auto choice = wxGetSingleChoiceIndex(_("Size of the exported frames"), _("Export Frames"), choices, this);
+    if (choice < 0)
+    {
+        return;
+    }
+
+    exporter.SetScale(scales[choice]);
+    exporter.SetSupersample(supersamples[choice]);
+
+    wxDirDialog dirDialog(this, _("Export frames to"), "", wxDD_DEFAULT_STYLE);
+    if (dirDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
+
+    auto numFrames = GetPicture()->GetTimeline()->GetNumFrames();
+    wxProgressDialog progressDialog(_("Export Frames"), _("Exporting frames..."), numFrames, this,
+            wxPD_APP_MODAL | wxPD_CAN_ABORT | wxPD_AUTO_HIDE);
+
+    auto written = exporter.Export(dirDialog.GetPath(), [&progressDialog](int frame, int) {
+        return progressDialog.Update(frame);
+    });
+
+    progressDialog.Update(numFrames);
+    if (!written && !progressDialog.WasCancelled())
+    {
+        wxMessageBox(_("Unable to write the frames"), _("Export Frames"), wxOK | wxICON_ERROR, this);
+    }
+    else if (exporter.GetIncompleteFrames() > 0)
+    {
+        wxMessageBox(wxString::Format(_("%d of the frames are missing drawing that can only be done on screen, "
+                "such as a machine stand-in"), exporter.GetIncompleteFrames()),
+                _("Export Frames"), wxOK | wxICON_WARNING, this);
+    }
+}
+
 /**
  * File>Open menu handler
  * @param event Menu event
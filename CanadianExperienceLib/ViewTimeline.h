@@ -9,6 +9,9 @@
 #define CANADIANEXPERIENCE_VIEWTIMELINE_H
 
 #include "PictureObserver.h"
+#include "PlaybackEngine.h"
+
+class Timeline;
 
 /**
  * View class for the timeline area of the screen.
@@ -29,6 +32,9 @@ private:
     void OnPlayPlayFromBeginning(wxCommandEvent& event);
     void OnFileSaveAs(wxCommandEvent& event);
     void OnFileOpen(wxCommandEvent& event);
+    void OnFileExportFrames(wxCommandEvent& event);
+
+    void DrawRuler(Timeline *timeline, int left, int width, int height);
 
     /// Bitmap image for the pointer
     std::unique_ptr<wxImage> mPointerImage;
@@ -36,6 +42,21 @@ private:
     /// Graphics bitmap to display
     wxGraphicsBitmap mPointerBitmap;
 
+    /// Cached image of the visible part of the ruler (ticks and labels)
+    wxBitmap mRulerBitmap;
+
+    /// Font the seconds labels are drawn in
+    wxFont mTickFont;
+
+    /// Scrolled x position of the left edge of mRulerBitmap
+    int mRulerLeft = 0;
+
+    /// Frame rate mRulerBitmap was drawn for
+    int mRulerFrameRate = 0;
+
+    /// Number of frames mRulerBitmap was drawn for
+    int mRulerNumFrames = 0;
+
     /// Flag to indicate we are moving the pointer
     bool mMovingPointer = false;
 
@@ -48,6 +69,9 @@ private:
     /// Are we playing?
     bool mPlaying = false;
 
+    /// Prepares machine frames ahead of the display while playing
+    PlaybackEngine mPlaybackEngine;
+
 public:
     static const int Height = 90;      ///< Height to make this window
 
@@ -55,6 +79,7 @@ public:
     ViewTimeline(wxFrame* parent, std::wstring imagesDir);
 
     void UpdateObserver() override;
+    void UpdateObserverChanges(int changes) override;
 
 
 
@@ -0,0 +1,364 @@
+/**
+ * @file main.cpp
+ * @author Thomas Toaz
+ *
+ * Benchmark of the machine simulation.
+ *
+ * Builds each machine through MachineSystemFactory, including the
+ * generated stress machine at its default size, and times
+ * forward playback, backward seeks and machine number switches.
+ * Forward playback is timed again with begin contact events
+ * batched after each step, and the contact counts are reported.
+ * It also times drawing a 4K frame of the first machine with the
+ * tile renderer on 1, 2, 4 and so on up to every core, which shows
+ * how the frame time scales with the core count.
+ * The results are written as JSON, to the file named on the
+ * command line or to standard output, so they can be compared
+ * across commits.
+ *
+ * Usage: MachineBenchmark [output.json] [frames]
+ */
+
+#include "pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#include <MachineSystemFactory.h>
+#include <MachineSystemActual.h>
+#include <RenderList.h>
+#include <RenderImage.h>
+#include <TileRenderer.h>
+#include <b2_time_step.h>
+
+/// Number of heap allocations made through operator new
+static std::atomic<size_t> Allocations{0};
+
+/**
+ * Counting replacement for the global operator new
+ * @param size Bytes to allocate
+ * @return Allocated memory
+ */
+void *operator new(size_t size)
+{
+    Allocations++;
+    if (auto memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+/**
+ * Counting replacement for the global operator new[]
+ * @param size Bytes to allocate
+ * @return Allocated memory
+ */
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+/**
+ * Replacement for the global operator delete
+ * @param memory Memory to free
+ */
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * Replacement for the global operator delete[]
+ * @param memory Memory to free
+ */
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * Sized replacement for the global operator delete
+ * @param memory Memory to free
+ */
+void operator delete(void *memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * Sized replacement for the global operator delete[]
+ * @param memory Memory to free
+ */
+void operator delete[](void *memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+/// Machine numbers that are benchmarked
+const int MachineNumbers[] = {1, 2, 3};
+
+/// Default number of frames of forward playback
+const int DefaultFrames = 600;
+
+/// Width of the frame drawn by the render benchmark
+const int RenderWidth = 3840;
+
+/// Height of the frame drawn by the render benchmark
+const int RenderHeight = 2160;
+
+/// Size of the picture the machine is placed in, scaled up to the frame
+const double PictureWidth = 1500;
+
+/// Number of frames timed at each thread count
+const int RenderFrames = 10;
+
+/// Clock used for timing
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Milliseconds since a start time
+ * @param start Start time
+ * @return Elapsed milliseconds
+ */
+static double Milliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * Benchmark one machine
+ * @param factory Factory that creates the machine systems
+ * @param number Machine number
+ * @param frames Number of frames of forward playback
+ * @param json Stream the JSON object for the machine is written to
+ */
+static void Benchmark(MachineSystemFactory &factory, int number, int frames, std::ostream &json)
+{
+    auto system = factory.CreateMachineSystem();
+    auto actual = std::dynamic_pointer_cast<MachineSystemActual>(system);
+
+    // Building the machine
+    auto start = Clock::now();
+    system->SetMachineNumber(number);
+    if (actual != nullptr)
+    {
+        actual->Activate();
+    }
+    auto buildMs = Milliseconds(start);
+
+    // Forward playback, one frame at a time
+    b2Profile total = {};
+    ContactListener::Statistics contacts;
+    size_t allocations = 0;
+    double forwardMs = 0;
+    for (int frame = 1; frame <= frames; frame++)
+    {
+        auto allocationsBefore = Allocations.load();
+        start = Clock::now();
+        system->SetMachineFrame(frame);
+        forwardMs += Milliseconds(start);
+        allocations += Allocations.load() - allocationsBefore;
+
+        auto profile = actual != nullptr ? actual->GetProfile() : nullptr;
+        if (profile != nullptr)
+        {
+            total.step += profile->step;
+            total.collide += profile->collide;
+            total.solve += profile->solve;
+            total.broadphase += profile->broadphase;
+            total.solveTOI += profile->solveTOI;
+        }
+
+        if (actual != nullptr)
+        {
+            auto step = actual->GetContactStatistics();
+            contacts.mBegins += step.mBegins;
+            contacts.mEnds += step.mEnds;
+            contacts.mPreSolves += step.mPreSolves;
+            contacts.mDispatched += step.mDispatched;
+            contacts.mContacts += step.mContacts;
+        }
+    }
+
+    // Forward playback again with begin contact events batched
+    double forwardBatchedMs = 0;
+    if (actual != nullptr)
+    {
+        actual->SetBatchContacts(true);
+        system->SetMachineFrame(0);
+        for (int frame = 1; frame <= frames; frame++)
+        {
+            start = Clock::now();
+            system->SetMachineFrame(frame);
+            forwardBatchedMs += Milliseconds(start);
+        }
+
+        actual->SetBatchContacts(false);
+    }
+
+    // Seek back to the middle, which replays from the start
+    start = Clock::now();
+    system->SetMachineFrame(frames / 2);
+    auto seekBackwardMs = Milliseconds(start);
+
+    // Switch to the other machine and back again
+    start = Clock::now();
+    system->SetMachineNumber(number == 1 ? 2 : 1);
+    system->SetMachineFrame(1);
+    system->SetMachineNumber(number);
+    system->SetMachineFrame(1);
+    auto switchMs = Milliseconds(start);
+
+    json << "    {\n";
+    json << "      \"machine\": " << number << ",\n";
+    json << "      \"frames\": " << frames << ",\n";
+    json << "      \"buildMs\": " << buildMs << ",\n";
+    json << "      \"forwardMs\": " << forwardMs << ",\n";
+    json << "      \"forwardMsPerFrame\": " << forwardMs / frames << ",\n";
+    json << "      \"forwardBatchedMs\": " << forwardBatchedMs << ",\n";
+    json << "      \"allocationsPerStep\": " << double(allocations) / frames << ",\n";
+    json << "      \"seekBackwardMs\": " << seekBackwardMs << ",\n";
+    json << "      \"switchMs\": " << switchMs << ",\n";
+    json << "      \"profileMs\": {\"step\": " << total.step
+         << ", \"collide\": " << total.collide
+         << ", \"solve\": " << total.solve
+         << ", \"broadphase\": " << total.broadphase
+         << ", \"solveTOI\": " << total.solveTOI << "},\n";
+    json << "      \"contacts\": {\"begins\": " << contacts.mBegins
+         << ", \"ends\": " << contacts.mEnds
+         << ", \"preSolves\": " << contacts.mPreSolves
+         << ", \"dispatched\": " << contacts.mDispatched
+         << ", \"meanContacts\": " << double(contacts.mContacts) / frames << "}\n";
+    json << "    }";
+}
+
+/**
+ * Benchmark drawing a frame a tile at a time.
+ *
+ * The first machine is recorded once partway through its run and
+ * drawn at 4K with more threads each time.
+ * @param factory Factory that creates the machine systems
+ * @param json Stream the JSON object for the render is written to
+ */
+static void BenchmarkRender(MachineSystemFactory &factory, std::ostream &json)
+{
+    auto system = std::dynamic_pointer_cast<MachineSystemActual>(factory.CreateMachineSystem());
+    if (system == nullptr)
+    {
+        // Only the actual machine system records its drawing
+        json << "  \"render\": null\n";
+        return;
+    }
+
+    system->SetMachineNumber(MachineNumbers[0]);
+    system->SetLocation(wxPoint(int(PictureWidth / 2), int(PictureWidth / 2)));
+    system->SetMachineFrame(DefaultFrames / 2);
+
+    RenderList list;
+    double scale = RenderWidth / PictureWidth;
+    list.Scale(scale, scale);
+    system->RecordMachine(list);
+
+    std::vector<unsigned> threadCounts;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads < cores; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+
+    threadCounts.push_back(cores);
+
+    json << "  \"render\": {\n";
+    json << "    \"width\": " << RenderWidth << ",\n";
+    json << "    \"height\": " << RenderHeight << ",\n";
+    json << "    \"threads\": [\n";
+
+    RenderImage image(RenderWidth, RenderHeight);
+    double singleMs = 0;
+    for (size_t i = 0; i < threadCounts.size(); i++)
+    {
+        TileRenderer tiles(threadCounts[i]);
+        auto draw = [&list](Renderer &renderer) { list.Replay(renderer); };
+
+        // The first frame fills the glyph atlases and image caches
+        tiles.Render(image, draw);
+
+        double renderMs = 0;
+        for (int frame = 0; frame < RenderFrames; frame++)
+        {
+            image.Fill(0xffffffff);
+            auto start = Clock::now();
+            tiles.Render(image, draw);
+            renderMs += Milliseconds(start);
+        }
+
+        double msPerFrame = renderMs / RenderFrames;
+        if (i == 0)
+        {
+            singleMs = msPerFrame;
+        }
+
+        json << "      {\"threads\": " << threadCounts[i]
+             << ", \"msPerFrame\": " << msPerFrame
+             << ", \"speedup\": " << singleMs / msPerFrame << "}"
+             << (i + 1 < threadCounts.size() ? ",\n" : "\n");
+    }
+
+    json << "    ]\n";
+    json << "  }\n";
+}
+
+/**
+ * Main entry point
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return 0 if successful
+ */
+int main(int argc, char **argv)
+{
+    wxInitAllImageHandlers();
+
+    int frames = argc > 2 ? std::atoi(argv[2]) : DefaultFrames;
+    if (frames <= 0)
+    {
+        frames = DefaultFrames;
+    }
+
+    MachineSystemFactory factory(L".");
+
+    std::stringstream json;
+    json << "{\n  \"machines\": [\n";
+    bool first = true;
+    for (auto number : MachineNumbers)
+    {
+        if (!first)
+        {
+            json << ",\n";
+        }
+
+        first = false;
+        Benchmark(factory, number, frames, json);
+    }
+
+    json << "\n  ],\n";
+    BenchmarkRender(factory, json);
+    json << "}\n";
+
+    if (argc > 1)
+    {
+        std::ofstream file(argv[1]);
+        file << json.str();
+        return file ? 0 : 1;
+    }
+
+    std::cout << json.str();
+    return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file AlphaKernel.cpp
+ * @author Thomas Toaz
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+/// SSE2 is available
+#define ALPHAKERNEL_SSE2
+#endif
+
+#include "AlphaKernel.h"
+
+/**
+ * Convert an opacity to the level ScaleAlpha uses
+ * @param opacity Opacity from 0 to 1
+ * @return Level from 0 to OpacityLevels - 1
+ */
+int AlphaKernel::OpacityLevel(double opacity)
+{
+    return std::clamp(int(std::lround(opacity * (OpacityLevels - 1))), 0, OpacityLevels - 1);
+}
+
+/**
+ * Scale an alpha plane by an opacity level.
+ *
+ * Each value becomes value * (level + 1) / 256, rounded down, so
+ * the top level leaves the plane unchanged. Sixteen values are
+ * done at a time with SSE2 when it is available. The result is
+ * the same either way.
+ * @param alpha Alpha values
+ * @param count Number of values
+ * @param level Opacity level from OpacityLevel
+ */
+void AlphaKernel::ScaleAlpha(unsigned char *alpha, size_t count, int level)
+{
+    unsigned factor = unsigned(level) + 1;
+    if (factor >= OpacityLevels)
+    {
+        return;
+    }
+
+    size_t i = 0;
+
+#ifdef ALPHAKERNEL_SSE2
+    auto zero = _mm_setzero_si128();
+    auto scale = _mm_set1_epi16(short(factor));
+    for ( ; i + 16 <= count; i += 16)
+    {
+        auto values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(alpha + i));
+        auto low = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(values, zero), scale), 8);
+        auto high = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(values, zero), scale), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(alpha + i), _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for ( ; i < count; i++)
+    {
+        alpha[i] = (unsigned char)((alpha[i] * factor) >> 8);
+    }
+}
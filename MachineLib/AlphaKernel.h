@@ -0,0 +1,29 @@
+/**
+ * @file AlphaKernel.h
+ * @author Thomas Toaz
+ *
+ * Pixel kernels for alpha channels.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_ALPHAKERNEL_H
+#define CANADIANEXPERIENCE_MACHINELIB_ALPHAKERNEL_H
+
+#include <cstddef>
+
+/**
+ * Pixel kernels for alpha channels.
+ *
+ * These work on the separate alpha plane of an image, so
+ * they do not depend on wxWidgets.
+ */
+class AlphaKernel
+{
+public:
+    /// Number of distinct opacity levels
+    static const int OpacityLevels = 256;
+
+    static int OpacityLevel(double opacity);
+    static void ScaleAlpha(unsigned char *alpha, size_t count, int level);
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_ALPHAKERNEL_H
@@ -0,0 +1,53 @@
+/**
+ * @file AlphaMask.cpp
+ * @author Thomas Toaz
+ */
+
+#include "AlphaMask.h"
+
+/**
+ * Constructor
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param alpha Alpha plane of width * height values, or nullptr
+ * if every pixel is opaque
+ * @param threshold Lowest alpha that counts as opaque
+ */
+AlphaMask::AlphaMask(int width, int height, const unsigned char *alpha, unsigned char threshold) :
+    mWidth(width), mHeight(height), mRowBytes((size_t(width) + 7) / 8)
+{
+    mBits.assign(mRowBytes * height, alpha == nullptr ? 0xff : 0);
+    if(alpha == nullptr)
+    {
+        return;
+    }
+
+    for(int y = 0; y < height; y++)
+    {
+        const unsigned char *line = alpha + size_t(y) * width;
+        unsigned char *bits = mBits.data() + size_t(y) * mRowBytes;
+        for(int x = 0; x < width; x++)
+        {
+            if(line[x] >= threshold)
+            {
+                bits[x >> 3] |= (unsigned char)(1 << (x & 7));
+            }
+        }
+    }
+}
+
+/**
+ * Is a pixel opaque?
+ * @param x X location in pixels
+ * @param y Y location in pixels
+ * @return true if the pixel is in the mask and opaque
+ */
+bool AlphaMask::IsOpaque(int x, int y) const
+{
+    if(x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+    {
+        return false;
+    }
+
+    return (mBits[size_t(y) * mRowBytes + (x >> 3)] >> (x & 7)) & 1;
+}
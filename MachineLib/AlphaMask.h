@@ -0,0 +1,66 @@
+/**
+ * @file AlphaMask.h
+ * @author Thomas Toaz
+ *
+ * One bit per pixel record of which pixels of an image are opaque.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_ALPHAMASK_H
+#define CANADIANEXPERIENCE_MACHINELIB_ALPHAMASK_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * One bit per pixel record of which pixels of an image are opaque.
+ *
+ * This is all hit testing needs of an image, at an eighth of the
+ * size of its alpha channel, so the pixels themselves can be
+ * released once they are in a graphics bitmap.
+ */
+class AlphaMask
+{
+private:
+    /// Width in pixels
+    int mWidth = 0;
+
+    /// Height in pixels
+    int mHeight = 0;
+
+    /// Bytes in each row of mBits
+    size_t mRowBytes = 0;
+
+    /// The bits, a row at a time, set where the pixel is opaque
+    std::vector<unsigned char> mBits;
+
+public:
+    /// Lowest alpha that counts as opaque, the same as wxImage::IsTransparent
+    static const unsigned char DefaultThreshold = 0x80;
+
+    /// Constructor, an empty mask
+    AlphaMask() {}
+
+    AlphaMask(int width, int height, const unsigned char *alpha, unsigned char threshold = DefaultThreshold);
+
+    bool IsOpaque(int x, int y) const;
+
+    /**
+     * Get the width of the mask
+     * @return Width in pixels
+     */
+    int GetWidth() const { return mWidth; }
+
+    /**
+     * Get the height of the mask
+     * @return Height in pixels
+     */
+    int GetHeight() const { return mHeight; }
+
+    /**
+     * Get the memory the mask holds
+     * @return Size of the bits in bytes
+     */
+    size_t GetBytes() const { return mBits.size(); }
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_ALPHAMASK_H
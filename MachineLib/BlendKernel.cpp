@@ -0,0 +1,138 @@
+/**
+ * @file BlendKernel.cpp
+ * @author Thomas Toaz
+ */
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+/// SSE2 is available
+#define BLENDKERNEL_SSE2
+#endif
+
+#include "BlendKernel.h"
+
+#ifdef BLENDKERNEL_SSE2
+/**
+ * Divide eight 16 bit products by 255, rounded as BlendKernel::Multiply does
+ * @param x Products of two values from 0 to 255
+ * @return The quotients
+ */
+static inline __m128i Divide255(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+/**
+ * Blend two premultiplied pixels held as 16 bit values over two destination pixels
+ * @param src Source pixels
+ * @param dst Destination pixels
+ * @return The blended pixels
+ */
+static inline __m128i Over(__m128i src, __m128i dst)
+{
+    auto alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, 0xff), 0xff);
+    auto inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+    return _mm_add_epi16(src, Divide255(_mm_mullo_epi16(dst, inverse)));
+}
+#endif
+
+/**
+ * Blend a solid colour over a span of pixels through a coverage mask.
+ *
+ * This is how filled shapes and text are drawn. Four pixels are
+ * done at a time with SSE2 when it is available.
+ * @param dst Destination pixels
+ * @param coverage How much of each pixel is covered, from 0 to 255
+ * @param count Number of pixels
+ * @param colour Colour as RGBA, red in the low byte, not premultiplied
+ */
+void BlendKernel::BlendSolid(unsigned char *dst, const unsigned char *coverage, size_t count, unsigned int colour)
+{
+    unsigned alpha = colour >> 24;
+    if(alpha == 0)
+    {
+        return;
+    }
+
+    unsigned premultiplied[4] = {Multiply(colour & 0xff, alpha), Multiply((colour >> 8) & 0xff, alpha),
+                                 Multiply((colour >> 16) & 0xff, alpha), alpha};
+
+    size_t i = 0;
+
+#ifdef BLENDKERNEL_SSE2
+    auto zero = _mm_setzero_si128();
+    auto source = _mm_set_epi16(short(premultiplied[3]), short(premultiplied[2]), short(premultiplied[1]), short(premultiplied[0]),
+                                short(premultiplied[3]), short(premultiplied[2]), short(premultiplied[1]), short(premultiplied[0]));
+    for( ; i + 4 <= count; i += 4)
+    {
+        auto m = coverage + i;
+        if((m[0] | m[1] | m[2] | m[3]) == 0)
+        {
+            continue;
+        }
+
+        auto low = _mm_set_epi16(m[1], m[1], m[1], m[1], m[0], m[0], m[0], m[0]);
+        auto high = _mm_set_epi16(m[3], m[3], m[3], m[3], m[2], m[2], m[2], m[2]);
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i * 4));
+        low = Over(Divide255(_mm_mullo_epi16(source, low)), _mm_unpacklo_epi8(pixels, zero));
+        high = Over(Divide255(_mm_mullo_epi16(source, high)), _mm_unpackhi_epi8(pixels, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for( ; i < count; i++)
+    {
+        unsigned m = coverage[i];
+        if(m == 0)
+        {
+            continue;
+        }
+
+        auto pixel = dst + i * 4;
+        unsigned inverse = 255 - Multiply(premultiplied[3], m);
+        for(int c = 0; c < 4; c++)
+        {
+            pixel[c] = (unsigned char)std::min(255u, unsigned(Multiply(premultiplied[c], m)) + Multiply(pixel[c], inverse));
+        }
+    }
+}
+
+/**
+ * Blend a span of premultiplied pixels over another.
+ *
+ * This is how images are drawn. Four pixels are done at a time
+ * with SSE2 when it is available.
+ * @param dst Destination pixels
+ * @param src Source pixels
+ * @param count Number of pixels
+ */
+void BlendKernel::BlendPixels(unsigned char *dst, const unsigned char *src, size_t count)
+{
+    size_t i = 0;
+
+#ifdef BLENDKERNEL_SSE2
+    auto zero = _mm_setzero_si128();
+    for( ; i + 4 <= count; i += 4)
+    {
+        auto source = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+        auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i * 4));
+        auto low = Over(_mm_unpacklo_epi8(source, zero), _mm_unpacklo_epi8(pixels, zero));
+        auto high = Over(_mm_unpackhi_epi8(source, zero), _mm_unpackhi_epi8(pixels, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_packus_epi16(low, high));
+    }
+#endif
+
+    for( ; i < count; i++)
+    {
+        auto pixel = dst + i * 4;
+        auto source = src + i * 4;
+        unsigned inverse = 255 - source[3];
+        for(int c = 0; c < 4; c++)
+        {
+            pixel[c] = (unsigned char)std::min(255u, unsigned(source[c]) + Multiply(pixel[c], inverse));
+        }
+    }
+}
@@ -0,0 +1,40 @@
+/**
+ * @file BlendKernel.h
+ * @author Thomas Toaz
+ *
+ * Pixel kernels that blend spans of premultiplied pixels.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_BLENDKERNEL_H
+#define CANADIANEXPERIENCE_MACHINELIB_BLENDKERNEL_H
+
+#include <cstddef>
+
+/**
+ * Pixel kernels that blend spans of premultiplied pixels.
+ *
+ * Pixels are four bytes, red, green, blue and alpha, with the
+ * colour multiplied by the alpha, as in RenderImage. Each
+ * blend is source over destination, rounded the same way
+ * whether or not SIMD is used.
+ */
+class BlendKernel
+{
+public:
+    /**
+     * Multiply two values from 0 to 255 as fractions of 255
+     * @param a First value
+     * @param b Second value
+     * @return a * b / 255, rounded
+     */
+    static unsigned char Multiply(unsigned a, unsigned b)
+    {
+        unsigned x = a * b + 128;
+        return (unsigned char)((x + (x >> 8)) >> 8);
+    }
+
+    static void BlendSolid(unsigned char *dst, const unsigned char *coverage, size_t count, unsigned int colour);
+    static void BlendPixels(unsigned char *dst, const unsigned char *src, size_t count);
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_BLENDKERNEL_H
@@ -17,12 +17,12 @@ void Body::AddPoint(int x, int y)
 }
 
 /**
- * Draw our polygon.
- * @param graphics The graphics context to draw on
+ * Record drawing our polygon.
+ * @param list Render list to record into
  */
-void Body::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void Body::Record(RenderList &list)
 {
-    mPolygon.Draw(graphics);
+    mPolygon.Record(list);
 }
 
 /**
@@ -113,3 +113,21 @@ void Body::SetInitialRotation(double rotation)
 {
     mPolygon.SetRotation(rotation);
 }
+
+/**
+ * Save the simulation state of the body
+ * @param state State to save to
+ */
+void Body::SaveState(MachineState &state)
+{
+    state.SaveBody(mPolygon.GetBody());
+}
+
+/**
+ * Restore the simulation state of the body
+ * @param reader Reader for the state to restore from
+ */
+void Body::RestoreState(MachineState::Reader &reader)
+{
+    reader.RestoreBody(mPolygon.GetBody());
+}
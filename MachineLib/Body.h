@@ -64,7 +64,14 @@ public:
     void SetImage(std::wstring fileName) {mPolygon.SetImage(fileName);}
 
     void Update(double elapsed) override;
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+
+    /**
+     * The body is moved only by the physics world, so it needs no updates
+     * @return false
+     */
+    bool NeedsUpdate() override { return false; }
+
+    void Record(RenderList &list) override;
 
     void SetInitialPosition(double x, double y);
     void Rectangle(double x, double y, double width, double height);
@@ -75,6 +82,9 @@ public:
 
     void Rotate(double rotation, double speed) override;
 
+    void SaveState(MachineState &state) override;
+    void RestoreState(MachineState::Reader &reader) override;
+
     void BottomCenteredRectangle(double x, double y);
     void SetInitialRotation(double rotation);
 };
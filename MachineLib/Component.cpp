@@ -3,7 +3,6 @@
  * @author Thomas Toaz
  */
 
-#include "pch.h"
 #include "Component.h"
 #include "Machine.h"
 
@@ -11,8 +11,10 @@
 #define CANADIANEXPERIENCE_MACHINELIB_COMPONENT_H
 
 #include "Machine.h"
+#include "MachineState.h"
 
 class b2World;
+class RenderList;
 
 
 /**
@@ -43,10 +45,10 @@ public:
 
 
     /**
-     * Draw the component
-     * @param graphics
+     * Record drawing the component into a render list
+     * @param list Render list to record into
      */
-    virtual void Draw(std::shared_ptr<wxGraphicsContext> graphics) = 0;
+    virtual void Record(RenderList &list) = 0;
 
     /**
      * Update the component
@@ -54,6 +56,25 @@ public:
      */
     virtual void Update(double elapsed) {};
 
+    /**
+     * Does this component do anything in Update?
+     *
+     * The machine only calls Update on components that return true.
+     * Components whose Update does nothing return false, so a
+     * component that forgets to override this is still updated.
+     * @return true if the component needs an update every step
+     */
+    virtual bool NeedsUpdate() { return true; }
+
+    /**
+     * Is this component at rest in the physics world?
+     *
+     * The machine does not update a component while it is asleep.
+     * @return true if the component has nothing to do until something
+     * wakes it, such as when Box2D has put its bodies to sleep
+     */
+    virtual bool IsAsleep() { return false; }
+
     /**
      * Install the object into the physics world of the system
      * @param world physics world you are installing the object into
@@ -73,6 +94,19 @@ public:
      */
     virtual void AddContact(std::shared_ptr<ContactListener> listener){}
 
+    /**
+     * Save the simulation state of this component
+     * @param state State to save to
+     */
+    virtual void SaveState(MachineState &state) {}
+
+    /**
+     * Restore the simulation state of this component.
+     * Must read exactly what SaveState saved.
+     * @param reader Reader for the state to restore from
+     */
+    virtual void RestoreState(MachineState::Reader &reader) {}
+
 };
 
 #endif //CANADIANEXPERIENCE_MACHINELIB_COMPONENT_H
@@ -3,26 +3,73 @@
  * @author Charles Owen
  */
 
-#include "pch.h"
+#include <b2_body.h>
 #include <b2_contact.h>
+#include <b2_world.h>
 
 #include "ContactListener.h"
 
+/**
+ * Add a dispatched listener for some body.
+ *
+ * The listener is stored in the body user data, which
+ * must not be used for anything else.
+ * @param body Body to listen for
+ * @param listener Listener to call
+ */
+void ContactListener::Add(b2Body *body, b2ContactListener *listener)
+{
+    body->GetUserData().pointer = reinterpret_cast<uintptr_t>(listener);
+}
+
 /**
  * Handle a contact beginning
  * @param contact Contact object
  */
 void ContactListener::BeginContact(b2Contact *contact)
 {
-    b2ContactListener* listener = nullptr;
-    if(ShouldDispatch(contact, 1, listener))
+    mStep.mBegins++;
+
+    b2ContactListener* listeners[] = {GetListener(contact->GetFixtureA()->GetBody()),
+                                      GetListener(contact->GetFixtureB()->GetBody())};
+    for(auto listener : listeners)
     {
-        listener->BeginContact(contact);
+        if(listener == nullptr)
+        {
+            continue;
+        }
+
+        if(mBatched)
+        {
+            mEvents.push_back(Event{listener, contact});
+        }
+        else
+        {
+            mStep.mDispatched++;
+            listener->BeginContact(contact);
+        }
     }
+}
+
+/**
+ * Handle the end of a contact situation
+ *
+ * Box2D destroys a contact after this returns, so any begin
+ * event still held for it is dropped rather than delivered
+ * with a dangling contact. That happens when a body is
+ * destroyed while its begin event is held.
+ * @param contact Contact object
+ */
+void ContactListener::EndContact(b2Contact *contact)
+{
+    mStep.mEnds++;
 
-    if(ShouldDispatch(contact, 2, listener))
+    for(auto &event : mEvents)
     {
-        listener->BeginContact(contact);
+        if(event.contact == contact)
+        {
+            event.contact = nullptr;
+        }
     }
 }
 
@@ -33,44 +80,60 @@ void ContactListener::BeginContact(b2Contact *contact)
  */
 void ContactListener::PreSolve(b2Contact *contact, const b2Manifold *oldManifold)
 {
-    b2ContactListener* listener = nullptr;
-    if(ShouldDispatch(contact, 1, listener))
+    mStep.mPreSolves++;
+
+    // This changes how the contact is solved, so it is never batched
+    auto listener = GetListener(contact->GetFixtureA()->GetBody());
+    if(listener != nullptr)
     {
+        mStep.mDispatched++;
         listener->PreSolve(contact, oldManifold);
     }
 
-    if(ShouldDispatch(contact, 2, listener))
+    listener = GetListener(contact->GetFixtureB()->GetBody());
+    if(listener != nullptr)
     {
+        mStep.mDispatched++;
         listener->PreSolve(contact, oldManifold);
     }
 }
 
 /**
- * Should a contact be dispatched to an installed listener for some body?
- *
- * We have installed listeners in mDispatch for bodies. This tests to see
- * if either of the two bodies involved  in the collision are in the
- * mDispatch map. If so, the listener reference value is set and a
- * true value is returned.
+ * Finish a step of the physics world.
  *
- * @param contact Contact to test
- * @param body Which body for the contact (1 or 2?)
- * @param listener Where to put the listener to call the function on
- * @return true if we should dispatch this contact
+ * Call this right after b2World::Step. It delivers any held
+ * begin contact events and records the statistics for the step.
+ * Box2D only destroys a contact during a step or when one of
+ * its bodies or fixtures is destroyed, and EndContact drops the
+ * held events of a contact destroyed that way, so the contacts
+ * delivered here are still alive. A listener may destroy bodies
+ * as it is called, which drops events later in the batch.
+ * @param world The world that was stepped
  */
- bool ContactListener::ShouldDispatch(b2Contact *contact, int body, b2ContactListener* &listener)
+void ContactListener::EndStep(b2World *world)
 {
-    b2Body* bodyD = body == 1 ? contact->GetFixtureA()->GetBody() :
-                               contact->GetFixtureB()->GetBody();
-
-    auto dispatchA = mDispatch.find(bodyD);
-    if(dispatchA != mDispatch.end())
+    for(auto &event : mEvents)
     {
-       listener = dispatchA->second;
-       return true;
+        if(event.contact != nullptr)
+        {
+            mStep.mDispatched++;
+            event.listener->BeginContact(event.contact);
+        }
     }
 
-    return false;
-}
+    mEvents.clear();
 
+    mStep.mContacts = world->GetContactCount();
+    mLastStep = mStep;
+    mStep = Statistics();
+}
 
+/**
+ * Get the listener installed for a body
+ * @param body Body to test
+ * @return Listener or nullptr if none is installed
+ */
+b2ContactListener *ContactListener::GetListener(b2Body *body)
+{
+    return reinterpret_cast<b2ContactListener *>(body->GetUserData().pointer);
+}
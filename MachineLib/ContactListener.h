@@ -9,40 +9,72 @@
 #ifndef CANADIANEXPERIENCE_MACHINELIB_CONTACTLISTENER_H
 #define CANADIANEXPERIENCE_MACHINELIB_CONTACTLISTENER_H
 
-#include <map>
+#include <vector>
 #include <b2_world_callbacks.h>
 
+class b2Body;
+class b2World;
+
 /**
  * A contact filter allows for testing for things
  * that should happen based on different contacts.
+ *
+ * The listener for a body is kept in the body's user data,
+ * so finding it costs a pointer read rather than a search.
  */
 class ContactListener : public b2ContactListener
 {
+public:
+    /// Contact counts for one step of the physics world
+    struct Statistics
+    {
+        /// Contacts that began touching
+        int mBegins = 0;
+
+        /// Contacts that stopped touching
+        int mEnds = 0;
+
+        /// Touching contacts about to be solved
+        int mPreSolves = 0;
+
+        /// Calls made to installed listeners
+        int mDispatched = 0;
+
+        /// Contacts in the world after the step
+        int mContacts = 0;
+    };
+
 private:
-    /**
-     * Keep track of bodies we want to dispatch
-     * the contact listener to.
-     */
-    std::map<b2Body*, b2ContactListener*> mDispatch;
+    /// Should begin contact events wait for EndStep?
+    bool mBatched = false;
+
+    /// A contact begin waiting to be delivered
+    struct Event
+    {
+        /// Listener to deliver to
+        b2ContactListener *listener;
+
+        /// The contact
+        b2Contact *contact;
+    };
+
+    /// Begin contact events waiting for EndStep
+    std::vector<Event> mEvents;
+
+    /// Counts for the step in progress
+    Statistics mStep;
+
+    /// Counts for the last completed step
+    Statistics mLastStep;
 
-    bool ShouldDispatch(b2Contact *contact, int body, b2ContactListener* &listener);
+    static b2ContactListener *GetListener(b2Body *body);
 
 public:
-    /**
-     * Add a dispatched listener for some body.
-     * @param body Body to listen for
-     * @param listener Listener to call
-     */
-    void Add(b2Body* body, b2ContactListener* listener) {mDispatch[body] = listener;}
+    void Add(b2Body* body, b2ContactListener* listener);
 
     void BeginContact(b2Contact* contact) override;
 
-    /**
-     * Handle the end of a contact situation
-     * @param contact Contact object
-     */
-    void EndContact(b2Contact* contact) override
-    { /* handle end event */ }
+    void EndContact(b2Contact* contact) override;
 
     void PreSolve(b2Contact* contact, const b2Manifold* oldManifold) override;
 
@@ -53,6 +85,30 @@ public:
      */
     void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse) override
     { /* handle post-solve event */ }
+
+    void EndStep(b2World *world);
+
+    /**
+     * Set whether begin contact events are held until EndStep.
+     *
+     * Held events are delivered in the order they happened,
+     * after the world has finished stepping. EndStep must be
+     * called right after each b2World::Step for this to hold.
+     * @param batched True to hold the events
+     */
+    void SetBatched(bool batched) { mBatched = batched; }
+
+    /**
+     * Are begin contact events held until EndStep?
+     * @return true if events are batched
+     */
+    bool IsBatched() const { return mBatched; }
+
+    /**
+     * Get the contact counts for the last step
+     * @return Statistics for the step that EndStep was last called for
+     */
+    const Statistics &GetStatistics() const { return mLastStep; }
 };
 
 #endif //CANADIANEXPERIENCE_MACHINELIB_CONTACTLISTENER_H
@@ -48,12 +48,12 @@ void Conveyor::Update(double elapsed)
 }
 
 /**
- * Draw our polygons for the conveyor.
- * @param graphics The graphics context to draw on
+ * Record drawing our polygons for the conveyor.
+ * @param list Render list to record into
  */
-void Conveyor::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void Conveyor::Record(RenderList &list)
 {
-    mConveyor.Draw(graphics);
+    mConveyor.Record(list);
 }
 
 /**
@@ -143,3 +143,23 @@ void Conveyor::SetInitialRotation(double rotation)
     mConveyor.SetRotation(rotation);
     mRotation = rotation;
 }
+
+/**
+ * Save the simulation state of the conveyor
+ * @param state State to save to
+ */
+void Conveyor::SaveState(MachineState &state)
+{
+    state.SaveBody(mConveyor.GetBody());
+    state.SaveValue(mSpeed);
+}
+
+/**
+ * Restore the simulation state of the conveyor
+ * @param reader Reader for the state to restore from
+ */
+void Conveyor::RestoreState(MachineState::Reader &reader)
+{
+    reader.RestoreBody(mConveyor.GetBody());
+    mSpeed = reader.NextValue();
+}
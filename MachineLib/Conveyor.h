@@ -44,13 +44,22 @@ public:
 
     void BeginContact(b2Contact *contact) override;
     void Update(double elapsed) override;
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+
+    /**
+     * The conveyor is driven through its rotation sink, so it needs no updates
+     * @return false
+     */
+    bool NeedsUpdate() override { return false; }
+
+    void Record(RenderList &list) override;
     void SetPosition(double x, double y) override;
     void InstallPhysics(std::shared_ptr<b2World> world) override;
     void AddContact(std::shared_ptr<ContactListener> listener) override;
     void PreSolve(b2Contact *contact, const b2Manifold *oldManifold) override;
     void Rotate(double rotation, double speed) override;
     void SetInitialRotation(double rotation);
+    void SaveState(MachineState &state) override;
+    void RestoreState(MachineState::Reader &reader) override;
 
     /**
      * Get the position of the conveyor belt
@@ -0,0 +1,217 @@
+/**
+ * @file GlyphAtlas.cpp
+ * @author Thomas Toaz
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "GlyphAtlas.h"
+
+/// First character in the built-in font
+const wchar_t FirstBuiltIn = L' ';
+
+/// Last character in the built-in font
+const wchar_t LastBuiltIn = L'~';
+
+/// Columns of each built-in glyph
+const int BuiltInColumns = 5;
+
+/// Rows of each built-in glyph, including the descender
+const int BuiltInRows = 8;
+
+/// Columns from one built-in glyph to the next
+const int BuiltInAdvance = 6;
+
+/// Samples across and down each pixel when scaling the built-in font
+const int BuiltInSamples = 4;
+
+/// Pixels left empty around each glyph in the page
+const int GlyphPadding = 1;
+
+/**
+ * The built-in font, a column at a time with the top row in the low bit
+ */
+static const unsigned char BuiltInFont[][BuiltInColumns] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x56, 0x20, 0x50}, {0x00, 0x08, 0x07, 0x03, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x2A, 0x1C, 0x7F, 0x1C, 0x2A}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+    {0x00, 0x80, 0x70, 0x30, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x00, 0x60, 0x60, 0x00},
+    {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+    {0x72, 0x49, 0x49, 0x49, 0x46}, {0x21, 0x41, 0x49, 0x4D, 0x33}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+    {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x31}, {0x41, 0x21, 0x11, 0x09, 0x07},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x46, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x00, 0x14, 0x00, 0x00},
+    {0x00, 0x40, 0x34, 0x00, 0x00}, {0x00, 0x08, 0x14, 0x22, 0x41}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x59, 0x09, 0x06}, {0x3E, 0x41, 0x5D, 0x59, 0x4E},
+    {0x7C, 0x12, 0x11, 0x12, 0x7C}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+    {0x7F, 0x41, 0x41, 0x41, 0x3E}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01},
+    {0x3E, 0x41, 0x41, 0x51, 0x73}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+    {0x7F, 0x02, 0x1C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+    {0x26, 0x49, 0x49, 0x49, 0x32}, {0x03, 0x01, 0x7F, 0x01, 0x03}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+    {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x59, 0x49, 0x4D, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x41},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x41, 0x7F}, {0x04, 0x02, 0x01, 0x02, 0x04},
+    {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x03, 0x07, 0x08, 0x00}, {0x20, 0x54, 0x54, 0x78, 0x40},
+    {0x7F, 0x28, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x28}, {0x38, 0x44, 0x44, 0x28, 0x7F},
+    {0x38, 0x54, 0x54, 0x54, 0x18}, {0x00, 0x08, 0x7E, 0x09, 0x02}, {0x18, 0xA4, 0xA4, 0x9C, 0x78},
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x40, 0x3D, 0x00},
+    {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x78, 0x04, 0x78},
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0xFC, 0x18, 0x24, 0x24, 0x18},
+    {0x18, 0x24, 0x24, 0x18, 0xFC}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x24},
+    {0x04, 0x04, 0x3F, 0x44, 0x24}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x4C, 0x90, 0x90, 0x90, 0x7C},
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x77, 0x00, 0x00},
+    {0x00, 0x41, 0x36, 0x08, 0x00}, {0x02, 0x01, 0x02, 0x04, 0x02},
+};
+
+/**
+ * Constructor
+ */
+GlyphAtlas::GlyphAtlas() : mPage(size_t(PageSize) * PageSize, 0), mRasterizer(BuiltInGlyph)
+{
+}
+
+/**
+ * Get the atlas shared by every software renderer
+ * @return The shared atlas
+ */
+GlyphAtlas &GlyphAtlas::Shared()
+{
+    static GlyphAtlas atlas;
+    return atlas;
+}
+
+/**
+ * Rasterize a glyph of the built-in font.
+ *
+ * The font is a grid of 5 by 8 cells scaled to the height, with
+ * each pixel covered by how many of its samples land in a set
+ * cell. Characters the font does not have are drawn as '?'.
+ * @param code The character
+ * @param height Height in pixels
+ * @param coverage Receives the coverage, a row at a time
+ * @param width Receives the width in pixels
+ * @param advance Receives the distance to the next glyph in pixels
+ * @return true
+ */
+bool GlyphAtlas::BuiltInGlyph(wchar_t code, int height, std::vector<unsigned char> &coverage, int &width, double &advance)
+{
+    if(code < FirstBuiltIn || code > LastBuiltIn)
+    {
+        code = L'?';
+    }
+
+    auto columns = BuiltInFont[code - FirstBuiltIn];
+    double scale = double(height) / BuiltInRows;
+    width = int(std::ceil(BuiltInColumns * scale));
+    advance = BuiltInAdvance * scale;
+
+    coverage.assign(size_t(width) * height, 0);
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            int covered = 0;
+            for(int sy = 0; sy < BuiltInSamples; sy++)
+            {
+                int row = int((y + (sy + 0.5) / BuiltInSamples) / scale);
+                for(int sx = 0; sx < BuiltInSamples; sx++)
+                {
+                    int column = int((x + (sx + 0.5) / BuiltInSamples) / scale);
+                    if(column < BuiltInColumns && row < BuiltInRows && (columns[column] >> row) & 1)
+                    {
+                        covered++;
+                    }
+                }
+            }
+
+            coverage[size_t(y) * width + x] = (unsigned char)(covered * 255 / (BuiltInSamples * BuiltInSamples));
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Set the function that rasterizes glyphs.
+ *
+ * The page is emptied, since its glyphs came from the old one.
+ * @param rasterizer Rasterizer function
+ */
+void GlyphAtlas::SetRasterizer(Rasterizer rasterizer)
+{
+    mRasterizer = rasterizer;
+    Clear();
+}
+
+/**
+ * Find a glyph, rasterizing it into the page if it is not there.
+ *
+ * The glyph returned is only good until the next call, which may
+ * empty the page to make room.
+ * @param code The character
+ * @param height Height in pixels, at most MaxHeight
+ * @return Where the glyph is in the page
+ */
+const GlyphAtlas::Glyph &GlyphAtlas::Find(wchar_t code, int height)
+{
+    height = std::clamp(height, 1, MaxHeight);
+    auto key = (static_cast<unsigned long long>(code) << 8) | height;
+    auto found = mGlyphs.find(key);
+    if(found != mGlyphs.end())
+    {
+        return found->second;
+    }
+
+    Glyph glyph;
+    std::vector<unsigned char> coverage;
+    int width = 0;
+    if(!mRasterizer(code, height, coverage, width, glyph.mAdvance) || width <= 0)
+    {
+        return mGlyphs[key] = glyph;
+    }
+
+    int stride = width;
+    width = std::min(width, PageSize - GlyphPadding * 2);
+    if(mRowX + width + GlyphPadding * 2 > PageSize)
+    {
+        // Start a new row
+        mRowX = 0;
+        mRowY += mRowHeight;
+        mRowHeight = 0;
+    }
+
+    if(mRowY + height + GlyphPadding * 2 > PageSize)
+    {
+        Clear();
+    }
+
+    glyph.mX = mRowX + GlyphPadding;
+    glyph.mY = mRowY + GlyphPadding;
+    glyph.mWidth = width;
+    glyph.mHeight = height;
+    for(int y = 0; y < height; y++)
+    {
+        std::copy(coverage.begin() + size_t(y) * stride, coverage.begin() + size_t(y) * stride + width,
+                mPage.begin() + size_t(glyph.mY + y) * PageSize + glyph.mX);
+    }
+
+    mRowX += width + GlyphPadding * 2;
+    mRowHeight = std::max(mRowHeight, height + GlyphPadding * 2);
+    return mGlyphs[key] = glyph;
+}
+
+/**
+ * Remove every glyph from the page
+ */
+void GlyphAtlas::Clear()
+{
+    std::fill(mPage.begin(), mPage.end(), 0);
+    mGlyphs.clear();
+    mRowX = 0;
+    mRowY = 0;
+    mRowHeight = 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file GlyphAtlas.h
+ * @author Thomas Toaz
+ *
+ * Cache of rasterized glyphs packed into one coverage page.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_GLYPHATLAS_H
+#define CANADIANEXPERIENCE_MACHINELIB_GLYPHATLAS_H
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Cache of rasterized glyphs packed into one coverage page.
+ *
+ * A glyph is rasterized the first time it is drawn at a pixel
+ * height and is kept in the page, so drawing the same text again
+ * only copies coverage. Glyphs are packed in rows, and when the
+ * page is full it is emptied and filled again.
+ *
+ * Glyphs come from a rasterizer function. The default is a small
+ * built-in font that covers printable ASCII, so text can be drawn
+ * with no font system at all.
+ */
+class GlyphAtlas
+{
+public:
+    /// Width and height of the page in pixels
+    static constexpr int PageSize = 512;
+
+    /// Tallest glyph kept, in pixels
+    static constexpr int MaxHeight = PageSize / 4;
+
+    /// Where a glyph is in the page
+    struct Glyph
+    {
+        /// Left of the glyph in the page
+        int mX = 0;
+
+        /// Top of the glyph in the page
+        int mY = 0;
+
+        /// Width in pixels
+        int mWidth = 0;
+
+        /// Height in pixels
+        int mHeight = 0;
+
+        /// Distance to the next glyph in pixels
+        double mAdvance = 0;
+    };
+
+    /**
+     * Function that rasterizes a glyph.
+     *
+     * It is given the character and the pixel height, and fills in
+     * the coverage, a row at a time, its width and its advance. The
+     * coverage must be width * height values.
+     */
+    typedef std::function<bool(wchar_t code, int height, std::vector<unsigned char> &coverage,
+            int &width, double &advance)> Rasterizer;
+
+private:
+    /// Coverage of the packed glyphs
+    std::vector<unsigned char> mPage;
+
+    /// Glyphs in the page by character and height
+    std::unordered_map<unsigned long long, Glyph> mGlyphs;
+
+    /// Left of the next glyph in the current row
+    int mRowX = 0;
+
+    /// Top of the current row
+    int mRowY = 0;
+
+    /// Height of the tallest glyph in the current row
+    int mRowHeight = 0;
+
+    /// Rasterizes glyphs that are not in the page
+    Rasterizer mRasterizer;
+
+public:
+    GlyphAtlas();
+
+    /// Copy constructor (disabled)
+    GlyphAtlas(const GlyphAtlas &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const GlyphAtlas &) = delete;
+
+    static GlyphAtlas &Shared();
+
+    static bool BuiltInGlyph(wchar_t code, int height, std::vector<unsigned char> &coverage, int &width, double &advance);
+
+    void SetRasterizer(Rasterizer rasterizer);
+    const Glyph &Find(wchar_t code, int height);
+    void Clear();
+
+    /**
+     * Get the packed coverage, PageSize values a row
+     * @return The first value of the page
+     */
+    const unsigned char *GetPage() const { return mPage.data(); }
+
+    /**
+     * Get the number of glyphs in the page
+     * @return Number of glyphs
+     */
+    size_t GetGlyphCount() const { return mGlyphs.size(); }
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_GLYPHATLAS_H
@@ -7,7 +7,6 @@
 #include "Goal.h"
 #include "ContactListener.h"
 #include "b2_contact.h"
-#include <sstream>
 
 /// Image to draw for the goal
 const std::wstring GoalImage = L"/goal.png";
@@ -66,38 +65,38 @@ Goal::Goal(std::wstring imagesDir)
 
     mGoal.BottomCenteredRectangle(TargetSize);
     mGoal.SetColor(*wxBLUE);
+
+    mScoreboardFont = wxFont(ScoreboardFontSize, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
 }
 
 
 /**
- * Draw our polygons.
- * @param graphics The graphics context to draw on
+ * Record drawing our polygons.
+ * @param list Render list to record into
  */
-void Goal::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void Goal::Record(RenderList &list)
 {
-    mPolygon.DrawPolygon(graphics,mGoalPos.x,mGoalPos.y,0);
+    mPolygon.RecordPolygon(list,mGoalPos.x,mGoalPos.y,0);
 
     // Draw the scoreboard background
-    graphics->SetBrush(wxBrush(ScoreboardBackgroundColor));
-    graphics->SetPen(wxPen(wxColor(0, 0, 0), ScoreboarderLineWidth));
-    graphics->DrawRectangle(mGoalPos.x+ScoreboardRectangle.m_x, mGoalPos.y+ScoreboardRectangle.m_y, ScoreboardRectangle.m_width, ScoreboardRectangle.m_height);
+    list.SetBrush(wxBrush(ScoreboardBackgroundColor));
+    list.SetPen(wxPen(wxColor(0, 0, 0), ScoreboarderLineWidth));
+    list.DrawRectangle(mGoalPos.x+ScoreboardRectangle.m_x, mGoalPos.y+ScoreboardRectangle.m_y, ScoreboardRectangle.m_width, ScoreboardRectangle.m_height);
 
-    graphics->PushState();
-    graphics->Translate(mGoalPos.x + ScoreboardTextLocation.m_x,mGoalPos.y + ScoreboardTextLocation.m_y);
-    graphics->Scale(1, -1);
+    list.PushState();
+    list.Translate(mGoalPos.x + ScoreboardTextLocation.m_x,mGoalPos.y + ScoreboardTextLocation.m_y);
+    list.Scale(1, -1);
 
-    std::stringstream score;
+    // Two digits, so the text is one of a few cached runs
+    auto score = std::to_wstring(mScore);
     if(mScore<10)
     {
-        score << 0;
+        score = L"0" + score;
     }
-    score << mScore;
 
-    // Set text color and font size
-    wxFont font(ScoreboardFontSize, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    graphics->SetFont(font, wxColor(255, 255, 255));  // White text color
-    graphics->DrawText(score.str(), 0, 0);
-    graphics->PopState();
+    list.SetFont(mScoreboardFont, wxColor(255, 255, 255));  // White text color
+    list.DrawText(score, 0, 0);
+    list.PopState();
 }
 
 /**
@@ -166,3 +165,24 @@ void Goal::AddContact(std::shared_ptr<ContactListener> listener)
     listener->Add(mGoal.GetBody(), this);
 }
 
+/**
+ * Save the simulation state of the goal
+ * @param state State to save to
+ */
+void Goal::SaveState(MachineState &state)
+{
+    state.SaveBody(mGoal.GetBody());
+    state.SaveBody(mPost.GetBody());
+    state.SaveValue(mScore);
+}
+
+/**
+ * Restore the simulation state of the goal
+ * @param reader Reader for the state to restore from
+ */
+void Goal::RestoreState(MachineState::Reader &reader)
+{
+    reader.RestoreBody(mGoal.GetBody());
+    reader.RestoreBody(mPost.GetBody());
+    mScore = (int)reader.NextValue();
+}
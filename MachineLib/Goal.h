@@ -32,6 +32,9 @@ private:
     /// Goal score
     int mScore = 0;
 
+    /// Font the score is drawn in
+    wxFont mScoreboardFont;
+
     /// Position of the goal polygon
     wxPoint mGoalPos;
 
@@ -48,7 +51,14 @@ public:
 
 
     void Update(double elapsed) override;
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+
+    /**
+     * The goal is moved only by the physics world, so it needs no updates
+     * @return false
+     */
+    bool NeedsUpdate() override { return false; }
+
+    void Record(RenderList &list) override;
     void SetPosition(double x, double y) override;
 
     void InstallPhysics(std::shared_ptr<b2World> world) override;
@@ -58,6 +68,8 @@ public:
 
 
     void AddContact(std::shared_ptr<ContactListener> listener) override;
+    void SaveState(MachineState &state) override;
+    void RestoreState(MachineState::Reader &reader) override;
 
 };
 
@@ -156,31 +156,32 @@ void Hamster::Update(double elapsed)
         // Stop all sinks this source is attached to.
         mSource.SetRotation(0, 0);
         mSource.UpdateSinks();
+        mSinksStopped = true;
     }
 }
 
 /**
- * Draw our polygons for the hamster.
- * @param graphics The graphics context to draw on
+ * Record drawing our polygons for the hamster.
+ * @param list Render list to record into
  */
-void Hamster::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void Hamster::Record(RenderList &list)
 {
-    mCage.Draw(graphics);
-    mWheel.DrawPolygon(graphics,mPosition.m_x + WheelCenter.m_x,mPosition.m_y + WheelCenter.m_y,mRotation);
+    mCage.Record(list);
+    mWheel.RecordPolygon(list,mPosition.m_x + WheelCenter.m_x,mPosition.m_y + WheelCenter.m_y,mRotation);
 
-    graphics->PushState();
-    graphics->Translate(mPosition.m_x + WheelCenter.m_x, mPosition.m_y + WheelCenter.m_y);
+    list.PushState();
+    list.Translate(mPosition.m_x + WheelCenter.m_x, mPosition.m_y + WheelCenter.m_y);
 
     if(mSpeed < 0)
     {
-        graphics->Scale(-1, 1);
+        list.Scale(-1, 1);
     }
 
 
     // Draw the running image
-    mHamsters[mHamsterIndex].DrawPolygon(graphics, 0, 0, 0);
+    mHamsters[mHamsterIndex].RecordPolygon(list, 0, 0, 0);
 
-    graphics->PopState();
+    list.PopState();
 
 }
 
@@ -211,6 +212,8 @@ void Hamster::InstallPhysics(std::shared_ptr<b2World> world)
         mHamsterIndex = 0;
     }
 
+    // The sinks are new to this world, so stop them again
+    mSinksStopped = false;
 }
 
 /**
@@ -256,3 +259,28 @@ void Hamster::TurnDemon(std::wstring imagesDir)
     }
     mCage.SetImage(imagesDir + DemonHamsterCageImage);
 }
+
+/**
+ * Save the simulation state of the hamster
+ * @param state State to save to
+ */
+void Hamster::SaveState(MachineState &state)
+{
+    state.SaveBody(mCage.GetBody());
+    state.SaveValue(mRotation);
+    state.SaveValue(mHamsterIndex);
+    state.SaveValue(mRunning ? 1 : 0);
+}
+
+/**
+ * Restore the simulation state of the hamster
+ * @param reader Reader for the state to restore from
+ */
+void Hamster::RestoreState(MachineState::Reader &reader)
+{
+    reader.RestoreBody(mCage.GetBody());
+    mRotation = reader.NextValue();
+    mHamsterIndex = (int)reader.NextValue();
+    mRunning = reader.NextValue() != 0;
+    mSinksStopped = false;
+}
@@ -50,6 +50,9 @@ private:
     /// Boolean for wheather hamster is running INITIALLY or not
     bool mInitiallyRunning = false;
 
+    /// Have the sinks been stopped since the hamster was last running?
+    bool mSinksStopped = false;
+
 public:
     Hamster(std::wstring imagesDir);
 
@@ -67,10 +70,27 @@ public:
     void BeginContact(b2Contact *contact);
 
     void Update(double elapsed) override;
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+
+    /**
+     * The hamster drives its sinks every step while it runs
+     * @return true
+     */
+    bool NeedsUpdate() override { return true; }
+
+    /**
+     * Is the hamster asleep?
+     *
+     * A hamster that is not running has nothing to do once it
+     * has stopped its sinks, until a contact wakes it.
+     * @return true if the hamster is stopped and so are its sinks
+     */
+    bool IsAsleep() override { return mHamsterIndex == 0 && mSinksStopped; }
+    void Record(RenderList &list) override;
     void SetPosition(double x, double y) override;
     void InstallPhysics(std::shared_ptr<b2World> world)override;
     void AddContact(std::shared_ptr<ContactListener> listener) override;
+    void SaveState(MachineState &state) override;
+    void RestoreState(MachineState::Reader &reader) override;
 
     void SetInitiallyRunning(bool running);
 
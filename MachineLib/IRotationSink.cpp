@@ -3,5 +3,4 @@
  * @author Thomas Toaz
  */
 
-#include "pch.h"
 #include "IRotationSink.h"
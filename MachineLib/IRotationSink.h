@@ -8,6 +8,8 @@
 #ifndef CANADIANEXPERIENCE_MACHINELIB_IROTATIONSINK_H
 #define CANADIANEXPERIENCE_MACHINELIB_IROTATIONSINK_H
 
+class RotationSource;
+
 /**
  * Rotational sink interface class for linking to rotational sources
  */
@@ -16,13 +18,25 @@ class IRotationSink
 private:
 
 public:
+    /// Destructor
+    virtual ~IRotationSink() = default;
+
     /**
      * Transfer the rotation/speed of something else into this sink
+     *
+     * This only updates the sink itself. Any sinks it drives
+     * are updated by the RotationSource that drives this one.
      * @param rotation
      * @param speed
      */
     virtual void Rotate(double rotation, double speed) = 0;
 
+    /**
+     * Get the source this sink passes its rotation on to
+     * @return Rotation source or nullptr if this sink drives nothing
+     */
+    virtual RotationSource *GetDrivenSource() { return nullptr; }
+
 };
 
 #endif //CANADIANEXPERIENCE_MACHINELIB_IROTATIONSINK_H
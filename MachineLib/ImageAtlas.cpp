@@ -0,0 +1,460 @@
+/**
+ * @file ImageAtlas.cpp
+ * @author Thomas Toaz
+ */
+
+#include "pch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <wx/dir.h>
+#include <wx/filename.h>
+#include <wx/textfile.h>
+#include <wx/tokenzr.h>
+
+#include "ImageAtlas.h"
+#include "ImageMemory.h"
+
+/// Transparent pixels left between images so filtering does not bleed
+const int Padding = 1;
+
+/// Name of the index file in the cache directory
+const std::wstring IndexName = L"atlas.txt";
+
+/// Prefix of the page file names in the cache directory
+const std::wstring PagePrefix = L"atlas-";
+
+/**
+ * Constructor
+ * @param pageSize Width and height of a page in pixels
+ * @param maxImageSize Largest width or height of an image that is packed
+ */
+ImageAtlas::ImageAtlas(int pageSize, int maxImageSize) :
+    mPageSize(pageSize), mMaxImageSize(std::min(maxImageSize, pageSize - Padding))
+{
+    // Construct the shared record first so it outlives the shared atlas
+    ImageMemory::Shared();
+}
+
+/**
+ * Destructor
+ */
+ImageAtlas::~ImageAtlas()
+{
+    ImageMemory::Shared().Forget(this);
+}
+
+/**
+ * Get the atlas shared by the application and the machines
+ * @return Shared atlas, empty until Build is called
+ */
+ImageAtlas &ImageAtlas::Shared()
+{
+    static ImageAtlas atlas;
+    return atlas;
+}
+
+/**
+ * Get the key an image is stored under
+ * @param filename Image file name, relative or absolute
+ * @return Absolute path of the file
+ */
+std::wstring ImageAtlas::Key(const std::wstring &filename)
+{
+    wxFileName name(filename);
+    name.MakeAbsolute();
+    return name.GetFullPath().ToStdWstring();
+}
+
+/**
+ * Build the atlas from the images in a directory.
+ *
+ * Images larger than the maximum image size are left out and
+ * are loaded from their own files as before.
+ * @param directory Directory containing the images
+ * @param cacheDir Directory to load the atlas from if it is up to
+ * date, and to save it to otherwise. Empty for no cache.
+ * @return true if the directory could be read
+ */
+bool ImageAtlas::Build(const std::wstring &directory, const std::wstring &cacheDir)
+{
+    Clear();
+
+    if(!wxDir::Exists(directory))
+    {
+        return false;
+    }
+
+    if(!cacheDir.empty() && LoadCache(directory, cacheDir))
+    {
+        RecordMemory();
+        return true;
+    }
+
+    // Prevent error popups for files that are not images
+    wxLogNull logNo;
+
+    wxArrayString names;
+    wxDir::GetAllFiles(directory, &names, wxEmptyString, wxDIR_FILES);
+
+    std::vector<std::wstring> files;
+    std::vector<wxImage> images;
+    for(auto &name : names)
+    {
+        wxImage image;
+        if(!image.LoadFile(name, wxBITMAP_TYPE_ANY) ||
+            image.GetWidth() > mMaxImageSize || image.GetHeight() > mMaxImageSize)
+        {
+            continue;
+        }
+
+        if(!image.HasAlpha())
+        {
+            image.InitAlpha();
+        }
+
+        files.push_back(name.ToStdWstring());
+        images.push_back(image);
+    }
+
+    Pack(directory, files, images);
+
+    if(!cacheDir.empty())
+    {
+        SaveCache(directory, cacheDir);
+    }
+
+    RecordMemory();
+    return true;
+}
+
+/**
+ * Record the page pixels in the shared ImageMemory
+ */
+void ImageAtlas::RecordMemory()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    size_t bytes = 0;
+    for(auto &page : mPages)
+    {
+        bytes += ImageMemory::ImageBytes(page.GetWidth(), page.GetHeight(), page.HasAlpha());
+    }
+
+    ImageMemory::Shared().Record(this, L"atlas pages", bytes);
+}
+
+/**
+ * Pack images onto pages.
+ *
+ * Images are placed on shelves, tallest first, which wastes
+ * little space for images of similar heights.
+ * @param directory Directory the images came from
+ * @param files File name of each image
+ * @param images The decoded images, with alpha channels
+ */
+void ImageAtlas::Pack(const std::wstring &directory, std::vector<std::wstring> &files, std::vector<wxImage> &images)
+{
+    std::vector<size_t> order(images.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&images](size_t a, size_t b) {
+        return images[a].GetHeight() > images[b].GetHeight();
+    });
+
+    std::map<std::wstring, Entry> entries;
+    std::vector<int> pageHeights;
+    int x = 0, y = 0, shelfHeight = 0;
+    for(auto i : order)
+    {
+        int wid = images[i].GetWidth();
+        int hit = images[i].GetHeight();
+
+        if(!pageHeights.empty() && x + wid > mPageSize)
+        {
+            // Start a new shelf
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+
+        if(pageHeights.empty() || y + hit > mPageSize)
+        {
+            // Start a new page
+            pageHeights.push_back(0);
+            x = y = shelfHeight = 0;
+        }
+
+        Entry entry;
+        entry.mPage = int(pageHeights.size()) - 1;
+        entry.mRect = wxRect(x, y, wid, hit);
+        entries[Key(files[i])] = entry;
+
+        x += wid + Padding;
+        shelfHeight = std::max(shelfHeight, hit + Padding);
+        pageHeights.back() = std::max(pageHeights.back(), y + hit);
+    }
+
+    // Pages are only as tall as they need to be
+    std::vector<wxImage> pages;
+    for(auto height : pageHeights)
+    {
+        wxImage page(mPageSize, height);
+        page.InitAlpha();
+        std::memset(page.GetAlpha(), 0, size_t(mPageSize) * height);
+        pages.push_back(page);
+    }
+
+    for(size_t i = 0; i < images.size(); i++)
+    {
+        auto &entry = entries[Key(files[i])];
+        auto &page = pages[entry.mPage];
+        auto &image = images[i];
+        int wid = image.GetWidth();
+        for(int row = 0; row < image.GetHeight(); row++)
+        {
+            size_t to = size_t(entry.mRect.y + row) * mPageSize + entry.mRect.x;
+            size_t from = size_t(row) * wid;
+            std::memcpy(page.GetData() + to * 3, image.GetData() + from * 3, size_t(wid) * 3);
+            std::memcpy(page.GetAlpha() + to, image.GetAlpha() + from, wid);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPages = pages;
+    mEntries = entries;
+    mPageBitmaps.assign(mPages.size(), wxGraphicsBitmap());
+}
+
+/**
+ * Remove all images from the atlas
+ */
+void ImageAtlas::Clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPages.clear();
+    mEntries.clear();
+    mPageBitmaps.clear();
+    mSubBitmaps.clear();
+    ImageMemory::Shared().Forget(this);
+}
+
+/**
+ * Is an image in the atlas?
+ * @param filename Image file name
+ * @return true if the image is on one of the pages
+ */
+bool ImageAtlas::Contains(const std::wstring &filename) const
+{
+    auto key = Key(filename);
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEntries.find(key) != mEntries.end();
+}
+
+/**
+ * Get a copy of an image from the atlas
+ * @param filename Image file name
+ * @return The image or an invalid image if it is not in the atlas
+ */
+wxImage ImageAtlas::GetImage(const std::wstring &filename) const
+{
+    auto key = Key(filename);
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto found = mEntries.find(key);
+    if(found == mEntries.end())
+    {
+        return wxImage();
+    }
+
+    return mPages[found->second.mPage].GetSubImage(found->second.mRect);
+}
+
+/**
+ * Get a graphics bitmap for an image in the atlas.
+ *
+ * The bitmap is a sub-bitmap of its page bitmap, which is
+ * created the first time any image on the page is drawn.
+ * @param graphics Graphics context the bitmap is for
+ * @param filename Image file name
+ * @return Bitmap or a null bitmap if the image is not in the atlas
+ */
+wxGraphicsBitmap ImageAtlas::GetBitmap(std::shared_ptr<wxGraphicsContext> graphics, const std::wstring &filename)
+{
+    auto key = Key(filename);
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto sub = mSubBitmaps.find(key);
+    if(sub != mSubBitmaps.end())
+    {
+        return sub->second;
+    }
+
+    auto found = mEntries.find(key);
+    if(found == mEntries.end())
+    {
+        return wxGraphicsBitmap();
+    }
+
+    auto &entry = found->second;
+    auto &pageBitmap = mPageBitmaps[entry.mPage];
+    if(pageBitmap.IsNull())
+    {
+        pageBitmap = graphics->CreateBitmapFromImage(mPages[entry.mPage]);
+    }
+
+    auto bitmap = graphics->CreateSubBitmap(pageBitmap, entry.mRect.x, entry.mRect.y,
+                                            entry.mRect.width, entry.mRect.height);
+    mSubBitmaps[key] = bitmap;
+    return bitmap;
+}
+
+/**
+ * Describe a file the way the cache index records it
+ * @param filename Full path of the file
+ * @return Modification time and size, tab separated
+ */
+static wxString FileStamp(const wxString &filename)
+{
+    wxFileName name(filename);
+    return wxString::Format(L"%lld\t%s", (long long)name.GetModificationTime().GetTicks(),
+                            name.GetSize().ToString());
+}
+
+/**
+ * Load the atlas from a cache directory if it is up to date.
+ *
+ * The cache is up to date if it lists every file in the image
+ * directory with the same modification time and size.
+ * @param directory Directory containing the images
+ * @param cacheDir Directory the cache was saved to
+ * @return true if the atlas was loaded
+ */
+bool ImageAtlas::LoadCache(const std::wstring &directory, const std::wstring &cacheDir)
+{
+    wxTextFile index;
+    if(!wxFileExists(cacheDir + L"/" + IndexName) || !index.Open(cacheDir + L"/" + IndexName))
+    {
+        return false;
+    }
+
+    long pageSize = 0, maxImageSize = 0, pageCount = 0;
+    wxStringTokenizer header(index.GetFirstLine(), L"\t");
+    if(header.GetNextToken() != L"atlas" || !header.GetNextToken().ToLong(&pageSize) ||
+        !header.GetNextToken().ToLong(&maxImageSize) || !header.GetNextToken().ToLong(&pageCount) ||
+        pageSize != mPageSize || maxImageSize != mMaxImageSize)
+    {
+        return false;
+    }
+
+    wxArrayString names;
+    wxDir::GetAllFiles(directory, &names, wxEmptyString, wxDIR_FILES);
+    if(index.GetLineCount() != names.size() + 1)
+    {
+        return false;
+    }
+
+    std::map<std::wstring, Entry> entries;
+    for(size_t line = 1; line < index.GetLineCount(); line++)
+    {
+        auto fields = wxStringTokenize(index.GetLine(line), L"\t", wxTOKEN_RET_EMPTY_ALL);
+        if(fields.size() < 4)
+        {
+            return false;
+        }
+
+        auto filename = directory + L"/" + fields[1].ToStdWstring();
+        if(!wxFileExists(filename) || FileStamp(filename) != fields[2] + L"\t" + fields[3])
+        {
+            return false;
+        }
+
+        if(fields[0] != L"image")
+        {
+            continue;
+        }
+
+        long values[5];
+        for(int v = 0; v < 5; v++)
+        {
+            if(size_t(v + 4) >= fields.size() || !fields[v + 4].ToLong(&values[v]))
+            {
+                return false;
+            }
+        }
+
+        Entry entry;
+        entry.mPage = int(values[0]);
+        entry.mRect = wxRect(values[1], values[2], values[3], values[4]);
+        entries[Key(filename)] = entry;
+    }
+
+    wxLogNull logNo;
+    std::vector<wxImage> pages;
+    for(long p = 0; p < pageCount; p++)
+    {
+        wxImage page;
+        if(!page.LoadFile(cacheDir + L"/" + PagePrefix + std::to_wstring(p) + L".png", wxBITMAP_TYPE_PNG) ||
+            !page.HasAlpha())
+        {
+            return false;
+        }
+
+        pages.push_back(page);
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPages = pages;
+    mEntries = entries;
+    mPageBitmaps.assign(mPages.size(), wxGraphicsBitmap());
+    return true;
+}
+
+/**
+ * Save the atlas pages and index to a cache directory
+ * @param directory Directory containing the images
+ * @param cacheDir Directory to save to
+ * @return true if successful
+ */
+bool ImageAtlas::SaveCache(const std::wstring &directory, const std::wstring &cacheDir)
+{
+    if(!wxFileName::Mkdir(cacheDir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    for(size_t p = 0; p < mPages.size(); p++)
+    {
+        if(!mPages[p].SaveFile(cacheDir + L"/" + PagePrefix + std::to_wstring(p) + L".png", wxBITMAP_TYPE_PNG))
+        {
+            return false;
+        }
+    }
+
+    wxTextFile index(cacheDir + L"/" + IndexName);
+    if(wxFileExists(index.GetName()) ? !index.Open() : !index.Create())
+    {
+        return false;
+    }
+
+    index.Clear();
+    index.AddLine(wxString::Format(L"atlas\t%d\t%d\t%d", mPageSize, mMaxImageSize, int(mPages.size())));
+
+    wxArrayString names;
+    wxDir::GetAllFiles(directory, &names, wxEmptyString, wxDIR_FILES);
+    for(auto &name : names)
+    {
+        auto stamp = wxFileName(name).GetFullName() + L"\t" + FileStamp(name);
+        auto found = mEntries.find(Key(name.ToStdWstring()));
+        if(found == mEntries.end())
+        {
+            index.AddLine(L"skip\t" + stamp);
+            continue;
+        }
+
+        auto &rect = found->second.mRect;
+        index.AddLine(wxString::Format(L"image\t%s\t%d\t%d\t%d\t%d\t%d", stamp, found->second.mPage,
+                                       rect.x, rect.y, rect.width, rect.height));
+    }
+
+    return index.Write();
+}
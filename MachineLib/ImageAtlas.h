@@ -0,0 +1,111 @@
+/**
+ * @file ImageAtlas.h
+ * @author Thomas Toaz
+ *
+ * Packs the small images of a directory into a few large pages.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_IMAGEATLAS_H
+#define CANADIANEXPERIENCE_MACHINELIB_IMAGEATLAS_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Packs the small images of a directory into a few large pages.
+ *
+ * Each image keeps its own rectangle on a page. Drawing code
+ * asks the atlas for an image by its file name and gets a copy
+ * of that rectangle, or a sub-bitmap of the page bitmap, so all
+ * of the images on a page share one graphics bitmap.
+ *
+ * The pages and their index can be saved to a cache directory.
+ * A later run that finds the cache up to date decodes the few
+ * page files instead of every image.
+ *
+ * Lookups may come from any thread.
+ */
+class ImageAtlas
+{
+public:
+    /// Default width and height of a page in pixels
+    static const int DefaultPageSize = 2048;
+
+    /// Default largest width or height of an image that is packed
+    static const int DefaultMaxImageSize = 512;
+
+    /// Where an image is in the atlas
+    struct Entry
+    {
+        /// Page the image is on
+        int mPage = 0;
+
+        /// Rectangle of the image on the page
+        wxRect mRect;
+    };
+
+private:
+    /// Width and height of a page
+    int mPageSize;
+
+    /// Largest width or height of an image that is packed
+    int mMaxImageSize;
+
+    /// The page images
+    std::vector<wxImage> mPages;
+
+    /// Images in the atlas by full path
+    std::map<std::wstring, Entry> mEntries;
+
+    /// Graphics bitmaps for the pages, created when first drawn
+    std::vector<wxGraphicsBitmap> mPageBitmaps;
+
+    /// Sub-bitmaps of the page bitmaps by full path
+    std::map<std::wstring, wxGraphicsBitmap> mSubBitmaps;
+
+    /// Protects everything above
+    mutable std::mutex mMutex;
+
+    static std::wstring Key(const std::wstring &filename);
+    void Pack(const std::wstring &directory, std::vector<std::wstring> &files, std::vector<wxImage> &images);
+    bool LoadCache(const std::wstring &directory, const std::wstring &cacheDir);
+    bool SaveCache(const std::wstring &directory, const std::wstring &cacheDir);
+    void RecordMemory();
+
+public:
+    ImageAtlas(int pageSize = DefaultPageSize, int maxImageSize = DefaultMaxImageSize);
+
+    ~ImageAtlas();
+
+    /// Copy constructor (disabled)
+    ImageAtlas(const ImageAtlas &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ImageAtlas &) = delete;
+
+    static ImageAtlas &Shared();
+
+    bool Build(const std::wstring &directory, const std::wstring &cacheDir = L"");
+    void Clear();
+
+    bool Contains(const std::wstring &filename) const;
+    wxImage GetImage(const std::wstring &filename) const;
+    wxGraphicsBitmap GetBitmap(std::shared_ptr<wxGraphicsContext> graphics, const std::wstring &filename);
+
+    /**
+     * Get the number of pages
+     * @return Number of pages
+     */
+    size_t GetPageCount() const { std::lock_guard<std::mutex> lock(mMutex); return mPages.size(); }
+
+    /**
+     * Get the number of images in the atlas
+     * @return Number of images
+     */
+    size_t GetImageCount() const { std::lock_guard<std::mutex> lock(mMutex); return mEntries.size(); }
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_IMAGEATLAS_H
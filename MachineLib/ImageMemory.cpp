@@ -0,0 +1,88 @@
+/**
+ * @file ImageMemory.cpp
+ * @author Thomas Toaz
+ */
+
+#include <algorithm>
+
+#include "ImageMemory.h"
+
+/**
+ * Get the record shared by the application and the machines
+ * @return Shared record
+ */
+ImageMemory &ImageMemory::Shared()
+{
+    static ImageMemory memory;
+    return memory;
+}
+
+/**
+ * Record the bytes an object holds, replacing what it held before
+ * @param owner The object holding the pixels
+ * @param asset The file the pixels came from
+ * @param bytes Bytes of pixels held
+ */
+void ImageMemory::Record(const void *owner, const std::wstring &asset, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto &entry = mOwners[owner];
+    entry.mAsset = asset;
+    entry.mBytes = bytes;
+}
+
+/**
+ * Forget what an object holds
+ * @param owner The object, which need not have recorded anything
+ */
+void ImageMemory::Forget(const void *owner)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mOwners.erase(owner);
+}
+
+/**
+ * Get the bytes held for each asset.
+ *
+ * Objects holding pixels from the same file are added together.
+ * @return One entry per asset, largest first
+ */
+std::vector<ImageMemory::Entry> ImageMemory::GetReport() const
+{
+    std::map<std::wstring, size_t> assets;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for(auto &owner : mOwners)
+        {
+            assets[owner.second.mAsset] += owner.second.mBytes;
+        }
+    }
+
+    std::vector<Entry> report;
+    for(auto &asset : assets)
+    {
+        report.push_back(Entry{asset.first, asset.second});
+    }
+
+    std::stable_sort(report.begin(), report.end(), [](const Entry &a, const Entry &b) {
+        return a.mBytes > b.mBytes;
+    });
+
+    return report;
+}
+
+/**
+ * Get the bytes held by all objects
+ * @return Bytes of pixels held
+ */
+size_t ImageMemory::GetTotalBytes() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    size_t total = 0;
+    for(auto &owner : mOwners)
+    {
+        total += owner.second.mBytes;
+    }
+
+    return total;
+}
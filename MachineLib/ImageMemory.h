@@ -0,0 +1,93 @@
+/**
+ * @file ImageMemory.h
+ * @author Thomas Toaz
+ *
+ * Record of the image pixels held in memory by each asset.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_IMAGEMEMORY_H
+#define CANADIANEXPERIENCE_MACHINELIB_IMAGEMEMORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Record of the image pixels held in memory by each asset.
+ *
+ * Objects that hold decoded images record how many bytes they
+ * hold under the file the pixels came from, and forget them when
+ * they are destroyed. This also holds the memory mode: when
+ * pixels are released, objects free their decoded images once
+ * the images are in graphics bitmaps, keeping only what they
+ * need for hit testing and decoding again if they need more.
+ *
+ * Objects may record from any thread.
+ */
+class ImageMemory
+{
+public:
+    /// Bytes held for one asset
+    struct Entry
+    {
+        /// The file the pixels came from
+        std::wstring mAsset;
+
+        /// Bytes of pixels held
+        size_t mBytes = 0;
+    };
+
+private:
+    /// Are decoded pixels released after bitmap creation?
+    std::atomic<bool> mReleasePixels{false};
+
+    /// Protects mOwners
+    mutable std::mutex mMutex;
+
+    /// What each object holds
+    std::map<const void *, Entry> mOwners;
+
+public:
+    /// Constructor
+    ImageMemory() {}
+
+    /// Copy constructor (disabled)
+    ImageMemory(const ImageMemory &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ImageMemory &) = delete;
+
+    static ImageMemory &Shared();
+
+    /**
+     * Get the bytes a decoded image holds
+     * @param width Width in pixels
+     * @param height Height in pixels
+     * @param alpha true if the image has an alpha channel
+     * @return Bytes of RGB and alpha
+     */
+    static size_t ImageBytes(int width, int height, bool alpha) { return size_t(width) * height * (alpha ? 4 : 3); }
+
+    /**
+     * Set whether decoded pixels are released after bitmap creation
+     * @param release true to release them
+     */
+    void SetReleasePixels(bool release) { mReleasePixels = release; }
+
+    /**
+     * Are decoded pixels released after bitmap creation?
+     * @return true if they are
+     */
+    bool IsReleasePixels() const { return mReleasePixels; }
+
+    void Record(const void *owner, const std::wstring &asset, size_t bytes);
+    void Forget(const void *owner);
+
+    std::vector<Entry> GetReport() const;
+    size_t GetTotalBytes() const;
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_IMAGEMEMORY_H
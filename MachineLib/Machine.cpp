@@ -3,11 +3,12 @@
  * @author Thomas Toaz
  */
 
-#include "pch.h"
+#include <b2_world.h>
+
 #include "Machine.h"
 #include "Component.h"
-#include "b2_world.h"
 #include "ContactListener.h"
+#include "MachineState.h"
 
 /// Gravity in meters per second per second
 const float Gravity = -9.8f;
@@ -32,14 +33,14 @@ Machine::Machine(int number)
 }
 
 /**
-* Draw the machine looping through all of its component pieces
-* @param graphics Graphics object to render to
-*/
-void Machine::DrawMachine(std::shared_ptr<wxGraphicsContext> graphics)
+ * Record drawing the machine into a render list
+ * @param list Render list to record into
+ */
+void Machine::RecordMachine(RenderList &list)
 {
     for(auto component : mComponents)
     {
-        component->Draw(graphics);
+        component->Record(list);
     }
 }
 
@@ -49,13 +50,43 @@ void Machine::DrawMachine(std::shared_ptr<wxGraphicsContext> graphics)
  */
 void Machine::Update(double elapsed)
 {
-    for(auto component : mComponents)
+    for(auto component : mUpdated)
+    {
+        if(!component->IsAsleep())
+        {
+            component->Update(elapsed);
+        }
+    }
+
+    // Advance the physics system one frame in time. A step of a
+    // world where every body is asleep changes nothing, so it is
+    // skipped until a component update wakes something.
+    mSettled = !IsWorldAwake();
+    mProfile = {};
+    if(!mSettled)
+    {
+        mWorld->Step(elapsed, VelocityIterations, PositionIterations);
+        mProfile = mWorld->GetProfile();
+    }
+
+    mContactListener->EndStep(mWorld.get());
+}
+
+/**
+ * Is any body in the physics world awake?
+ * @return true if a step of the world could move something
+ */
+bool Machine::IsWorldAwake()
+{
+    for(auto body = mWorld->GetBodyList(); body != nullptr; body = body->GetNext())
     {
-        component->Update(elapsed);
+        if(body->IsAwake())
+        {
+            return true;
+        }
     }
 
-    // Advance the physics system one frame in time
-    mWorld->Step(elapsed, VelocityIterations, PositionIterations);
+    return false;
 }
 
 /**
@@ -66,18 +97,50 @@ void Machine::Reset()
     // Create new b2world
     mWorld = std::make_shared<b2World>(b2Vec2(0.0f, Gravity));
 
-    // Create and install the contact filter
+    // Create and install the contact filter. It is new with the
+    // world, so no event held for the old world is ever delivered.
     mContactListener = std::make_shared<ContactListener>();
+    mContactListener->SetBatched(mBatchContacts);
     mWorld->SetContactListener(mContactListener.get());
 
     // Install components into physics world
+    mUpdated.clear();
     for(auto component : mComponents)
     {
         component->InstallPhysics(mWorld);
         component->AddContact(mContactListener);
+
+        if(component->NeedsUpdate())
+        {
+            mUpdated.push_back(component.get());
+        }
+    }
+
+    mSettled = false;
+}
+
+/**
+ * Set whether begin contact events are delivered after each physics step
+ * @param batched True to deliver them in one batch after the step
+ */
+void Machine::SetBatchContacts(bool batched)
+{
+    mBatchContacts = batched;
+    if(mContactListener != nullptr)
+    {
+        mContactListener->SetBatched(batched);
     }
 }
 
+/**
+ * Get the contact counts for the last physics step
+ * @return Statistics from the contact listener
+ */
+ContactListener::Statistics Machine::GetContactStatistics() const
+{
+    return mContactListener != nullptr ? mContactListener->GetStatistics() : ContactListener::Statistics();
+}
+
 /**
  * Add a component to the machine
  * @param component component being added
@@ -88,3 +151,38 @@ void Machine::AddComponent(const std::shared_ptr<Component> &component)
     component->SetMachine(this);
 }
 
+/**
+ * Save the simulation state of the machine
+ * @param frame The machine frame the state is for
+ * @return Saved state
+ */
+std::shared_ptr<MachineState> Machine::SaveState(int frame)
+{
+    auto state = std::make_shared<MachineState>(mNumber, frame);
+    for(auto component : mComponents)
+    {
+        component->SaveState(*state);
+    }
+
+    return state;
+}
+
+/**
+ * Restore a saved simulation state into the machine
+ *
+ * The state must have been saved from a machine with the same number.
+ * @param state State to restore
+ */
+void Machine::RestoreState(const MachineState &state)
+{
+    if(state.GetMachineNumber() != mNumber)
+    {
+        return;
+    }
+
+    MachineState::Reader reader(state);
+    for(auto component : mComponents)
+    {
+        component->RestoreState(reader);
+    }
+}
@@ -8,12 +8,22 @@
 #ifndef CANADIANEXPERIENCE_MACHINELIB_MACHINE_H
 #define CANADIANEXPERIENCE_MACHINELIB_MACHINE_H
 
+#include <memory>
+#include <vector>
+#include <b2_time_step.h>
+
+#include "ContactListener.h"
+
 class Component;
 class b2World;
-class ContactListener;
+class MachineState;
+class RenderList;
 
 /**
  * Actual machine made of components
+ *
+ * This steps the physics world and the components, and does not
+ * use wxWidgets. Drawing is recorded by the components themselves.
  */
 class Machine
 {
@@ -30,6 +40,20 @@ private:
     /// The installed contact filter
     std::shared_ptr<ContactListener> mContactListener;
 
+    /// Components that need per-step updates
+    std::vector<Component *> mUpdated;
+
+    /// Time spent in the physics world at the last update
+    b2Profile mProfile = {};
+
+    /// Was every body asleep at the last update?
+    bool mSettled = false;
+
+    /// Are begin contact events delivered after each step?
+    bool mBatchContacts = false;
+
+    bool IsWorldAwake();
+
 public:
     /// Constructor
     Machine(int number);
@@ -40,7 +64,7 @@ public:
     /// Assignment operator
     void operator=(const Machine &) = delete;
 
-    void DrawMachine(std::shared_ptr<wxGraphicsContext> graphics);
+    void RecordMachine(RenderList &list);
     void Update(double elapsed);
     void AddComponent(const std::shared_ptr<Component>& component);
 
@@ -52,6 +76,28 @@ public:
 
     void Reset();
 
+    std::shared_ptr<MachineState> SaveState(int frame);
+    void RestoreState(const MachineState &state);
+
+    /**
+     * Was every body in the physics world asleep at the last update?
+     *
+     * The physics world is not stepped while it is settled.
+     * @return true if the machine is at rest
+     */
+    bool IsSettled() const {return mSettled;}
+
+    /**
+     * Get where the physics world spent its time at the last update
+     *
+     * All times are zero if the world was settled and not stepped.
+     * @return Box2D profile, times in milliseconds
+     */
+    const b2Profile &GetProfile() const {return mProfile;}
+
+    void SetBatchContacts(bool batched);
+    ContactListener::Statistics GetContactStatistics() const;
+
 };
 
 #endif //CANADIANEXPERIENCE_MACHINELIB_MACHINE_H
@@ -0,0 +1,233 @@
+/**
+ * @file MachineFactory3.cpp
+ * @author Thomas Toaz
+ */
+
+#include "pch.h"
+#include <algorithm>
+
+#include "MachineFactory3.h"
+#include "Machine.h"
+#include "Body.h"
+#include "Goal.h"
+#include "Pulley.h"
+#include "Hamster.h"
+#include "Conveyor.h"
+
+/// The images directory in resources
+const std::wstring ImagesDirectory = L"/images";
+
+/// The machine number of this machine
+const int MachineNumber = 3;
+
+/// Width of one hamster and conveyor cell in centimeters
+const double CellWidth = 250;
+
+/// Offset from the hamster to the conveyor in a cell
+const auto ConveyorOffset = wxPoint2DDouble(140, 60);
+
+/// Height of the floor in centimeters
+const double FloorHeight = 15;
+
+/// Height of the walls at the ends of the floor
+const double WallHeight = 600;
+
+/// Height of the overhead pulley chain
+const double OverheadY = 550;
+
+/// Spacing of the overhead pulleys
+const double OverheadSpacing = 40;
+
+/// Radius of a ball in centimeters
+const double BallRadius = 8;
+
+/// Spacing of the ball grid
+const double BallSpacing = 25;
+
+/// Height of the lowest row of balls
+const double BallsY = 200;
+
+/**
+ * Constructor
+ * @param resourcesDir Path to the resources directory
+ * @param parameters Size of the machine to generate
+ */
+MachineFactory3::MachineFactory3(std::wstring resourcesDir, const Parameters &parameters) :
+    mResourcesDir(resourcesDir), mParameters(parameters)
+{
+    mImagesDir = mResourcesDir + ImagesDirectory;
+}
+
+/**
+ * Factory method to create machine #3
+ * @return The generated machine
+ */
+std::shared_ptr<Machine> MachineFactory3::Create()
+{
+    auto machine = std::make_shared<Machine>(MachineNumber);
+
+    // Notice: All dimensions are in centimeters and assumes
+    // the Y axis is positive in the up direction.
+    int cells = std::max(1, std::max(mParameters.mHamsters, mParameters.mConveyors));
+    auto width = Floor(machine, cells);
+
+    // The pulleys driven by the first hamster drive the overhead chain
+    std::shared_ptr<Pulley> overheadDriver;
+    int pulleys = mParameters.mPulleys;
+    for(int cell = 0; cell < cells; cell++)
+    {
+        std::shared_ptr<Pulley> driver;
+        pulleys -= Cell(machine, cell, driver);
+        if(overheadDriver == nullptr)
+        {
+            overheadDriver = driver;
+        }
+    }
+
+    OverheadPulleys(machine, pulleys, overheadDriver);
+    Balls(machine, width);
+
+    // The goal is added last so the balls draw behind it
+    auto goal = std::make_shared<Goal>(mImagesDir);
+    goal->SetPosition(width / 2 - 100, 0);
+    machine->AddComponent(goal);
+
+    return machine;
+}
+
+/**
+ * Add the floor and the walls at its ends
+ * @param machine Machine to add to
+ * @param cells Number of cells the floor holds
+ * @return Width of the floor in centimeters
+ */
+double MachineFactory3::Floor(std::shared_ptr<Machine> machine, int cells)
+{
+    auto width = cells * CellWidth + CellWidth;
+
+    // The top of the floor is at Y=0
+    auto floor = std::make_shared<Body>();
+    floor->Rectangle(-width / 2, -FloorHeight, width, FloorHeight);
+    floor->SetImage(mImagesDir + L"/floor.png");
+    machine->AddComponent(floor);
+
+    for(auto x : {-width / 2 - FloorHeight, width / 2})
+    {
+        auto wall = std::make_shared<Body>();
+        wall->Rectangle(x, -FloorHeight, FloorHeight, WallHeight);
+        wall->SetImage(mImagesDir + L"/floor.png");
+        machine->AddComponent(wall);
+    }
+
+    return width;
+}
+
+/**
+ * Add one cell of the machine.
+ *
+ * A cell may have a hamster, a conveyor or both. When it
+ * has both, the hamster drives the conveyor through a pair
+ * of pulleys, if enough pulleys are left.
+ * @param machine Machine to add to
+ * @param cell Cell number, from the left
+ * @param driver Set to the pulley on the hamster shaft, if there is one
+ * @return Number of pulleys used
+ */
+int MachineFactory3::Cell(std::shared_ptr<Machine> machine, int cell, std::shared_ptr<Pulley> &driver)
+{
+    int cells = std::max(1, std::max(mParameters.mHamsters, mParameters.mConveyors));
+    auto x = -cells * CellWidth / 2 + cell * CellWidth;
+
+    std::shared_ptr<Hamster> hamster;
+    if(cell < mParameters.mHamsters)
+    {
+        hamster = std::make_shared<Hamster>(mImagesDir);
+        hamster->SetPosition(x, 0);
+        hamster->SetInitiallyRunning(true);
+        hamster->SetSpeed(cell % 2 == 0 ? -1 : -2);
+        machine->AddComponent(hamster);
+    }
+
+    std::shared_ptr<Conveyor> conveyor;
+    if(cell < mParameters.mConveyors)
+    {
+        conveyor = std::make_shared<Conveyor>(mImagesDir);
+        conveyor->SetPosition(x + ConveyorOffset.m_x, ConveyorOffset.m_y);
+        machine->AddComponent(conveyor);
+    }
+
+    // Cells before the pulleys run out are driven
+    int pulleysLeft = mParameters.mPulleys - cell * 2;
+    if(hamster == nullptr || conveyor == nullptr || pulleysLeft < 2)
+    {
+        return 0;
+    }
+
+    auto hamsterShaft = hamster->GetShaftPosition();
+    auto conveyorShaft = conveyor->GetShaftPosition();
+
+    driver = std::make_shared<Pulley>(10);
+    driver->SetImage(mImagesDir + L"/pulley3.png");
+    driver->SetPosition(hamsterShaft.x, hamsterShaft.y);
+    machine->AddComponent(driver);
+    hamster->GetSource()->AddSink(driver);
+
+    auto driven = std::make_shared<Pulley>(15);
+    driven->SetImage(mImagesDir + L"/pulley3.png");
+    driven->SetPosition(conveyorShaft.x, conveyorShaft.y);
+    machine->AddComponent(driven);
+    driver->Drive(driven);
+    driven->GetSource()->AddSink(conveyor);
+
+    return 2;
+}
+
+/**
+ * Add the overhead chain of pulleys
+ * @param machine Machine to add to
+ * @param pulleys Number of pulleys in the chain
+ * @param driver Pulley that drives the chain or nullptr if it is not driven
+ */
+void MachineFactory3::OverheadPulleys(std::shared_ptr<Machine> machine, int pulleys, std::shared_ptr<Pulley> driver)
+{
+    auto x = -pulleys * OverheadSpacing / 2;
+    for(int p = 0; p < pulleys; p++)
+    {
+        auto pulley = std::make_shared<Pulley>(p % 2 == 0 ? 10 : 15);
+        pulley->SetImage(mImagesDir + L"/pulley3.png");
+        pulley->SetPosition(x + p * OverheadSpacing, OverheadY);
+        machine->AddComponent(pulley);
+
+        if(driver != nullptr)
+        {
+            driver->Drive(pulley);
+        }
+
+        driver = pulley;
+    }
+}
+
+/**
+ * Add the grid of balls that drop onto the machine
+ * @param machine Machine to add to
+ * @param width Width of the floor in centimeters
+ */
+void MachineFactory3::Balls(std::shared_ptr<Machine> machine, double width)
+{
+    int columns = std::max(1, int((width - BallSpacing) / BallSpacing));
+    for(int b = 0; b < mParameters.mBalls; b++)
+    {
+        // Odd rows are offset so the balls do not stack
+        int row = b / columns;
+        auto x = -width / 2 + BallSpacing + (b % columns) * BallSpacing + (row % 2) * BallSpacing / 2;
+        auto y = BallsY + row * BallSpacing;
+
+        auto ball = std::make_shared<Body>();
+        ball->Circle(BallRadius);
+        ball->SetImage(mImagesDir + (b % 2 == 0 ? L"/basketball1.png" : L"/basketball2.png"));
+        ball->SetInitialPosition(x, y);
+        ball->SetDynamic();
+        ball->SetPhysics(1, 0.5, 0.6);
+        machine->AddComponent(ball);
+    }
+}
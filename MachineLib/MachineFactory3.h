@@ -0,0 +1,67 @@
+/**
+ * @file MachineFactory3.h
+ * @author Thomas Toaz
+ *
+ * Factory for a generated machine of configurable size.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_MACHINEFACTORY3_H
+#define CANADIANEXPERIENCE_MACHINELIB_MACHINEFACTORY3_H
+
+#include <memory>
+#include <string>
+
+class Machine;
+class Pulley;
+
+/**
+ * Factory for a generated machine of configurable size.
+ *
+ * Machine #3 is a stress machine. It is laid out as a row of
+ * cells, each with a hamster that drives a conveyor through
+ * a pair of pulleys. The remaining pulleys form an overhead
+ * chain driven by the first hamster, and the balls drop onto
+ * the row from a grid above it. It is used to find where the
+ * physics or the drawing stops scaling.
+ */
+class MachineFactory3 {
+public:
+    /// How big a machine to generate
+    struct Parameters
+    {
+        /// Number of balls
+        int mBalls = 1000;
+
+        /// Number of pulleys
+        int mPulleys = 200;
+
+        /// Number of hamsters
+        int mHamsters = 50;
+
+        /// Number of conveyors
+        int mConveyors = 50;
+    };
+
+private:
+    /// Path to the resources directory
+    std::wstring mResourcesDir;
+
+    /// Path to the images directory
+    std::wstring mImagesDir;
+
+    /// Size of the machine to generate
+    Parameters mParameters;
+
+    double Floor(std::shared_ptr<Machine> machine, int cells);
+    int Cell(std::shared_ptr<Machine> machine, int cell, std::shared_ptr<Pulley> &driver);
+    void OverheadPulleys(std::shared_ptr<Machine> machine, int pulleys, std::shared_ptr<Pulley> driver);
+    void Balls(std::shared_ptr<Machine> machine, double width);
+
+public:
+    MachineFactory3(std::wstring resourcesDir, const Parameters &parameters = Parameters());
+
+    std::shared_ptr<Machine> Create();
+
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_MACHINEFACTORY3_H
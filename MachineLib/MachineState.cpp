@@ -0,0 +1,127 @@
+/**
+ * @file MachineState.cpp
+ * @author Thomas Toaz
+ */
+
+#include "MachineState.h"
+#include <b2_body.h>
+#include <cstring>
+
+/// FNV-1a 64 bit offset basis
+const uint64_t HashBasis = 14695981039346656037ull;
+
+/// FNV-1a 64 bit prime
+const uint64_t HashPrime = 1099511628211ull;
+
+/**
+ * Add the bytes of a value to an FNV-1a hash
+ * @param hash Hash to add to
+ * @param value Value to add
+ */
+template<class T>
+static void HashValue(uint64_t &hash, T value)
+{
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (auto byte : bytes)
+    {
+        hash = (hash ^ byte) * HashPrime;
+    }
+}
+
+/**
+ * Save the state of a physics body
+ *
+ * Bodies that have not been installed in the physics
+ * system are still saved, so the order is kept.
+ * @param body Body to save, may be nullptr
+ */
+void MachineState::SaveBody(b2Body *body)
+{
+    BodyState state;
+    if (body != nullptr)
+    {
+        auto position = body->GetPosition();
+        auto velocity = body->GetLinearVelocity();
+
+        state.x = position.x;
+        state.y = position.y;
+        state.angle = body->GetAngle();
+        state.vx = velocity.x;
+        state.vy = velocity.y;
+        state.omega = body->GetAngularVelocity();
+        state.awake = body->IsAwake();
+        state.installed = true;
+    }
+
+    mBodies.push_back(state);
+}
+
+/**
+ * Restore the next saved body into a physics body
+ * @param body Body to restore, may be nullptr
+ */
+void MachineState::Reader::RestoreBody(b2Body *body)
+{
+    if (mBody >= mState.mBodies.size())
+    {
+        return;
+    }
+
+    const auto &state = mState.mBodies[mBody++];
+    if (body == nullptr || !state.installed)
+    {
+        return;
+    }
+
+    body->SetTransform(b2Vec2(state.x, state.y), state.angle);
+    body->SetLinearVelocity(b2Vec2(state.vx, state.vy));
+    body->SetAngularVelocity(state.omega);
+    body->SetAwake(state.awake);
+}
+
+/**
+ * Get the next saved component value
+ * @return Value or 0 if there are no more values
+ */
+double MachineState::Reader::NextValue()
+{
+    if (mValue >= mState.mValues.size())
+    {
+        return 0;
+    }
+
+    return mState.mValues[mValue++];
+}
+
+/**
+ * Compute a hash of the saved state.
+ *
+ * Every body transform and velocity and every component value
+ * is hashed bit for bit, so two states only hash the same if
+ * the simulations that produced them are identical.
+ * @return 64 bit FNV-1a hash
+ */
+uint64_t MachineState::GetHash() const
+{
+    uint64_t hash = HashBasis;
+    HashValue(hash, mMachineNumber);
+    for (auto &body : mBodies)
+    {
+        HashValue(hash, body.x);
+        HashValue(hash, body.y);
+        HashValue(hash, body.angle);
+        HashValue(hash, body.vx);
+        HashValue(hash, body.vy);
+        HashValue(hash, body.omega);
+        HashValue(hash, body.awake);
+        HashValue(hash, body.installed);
+    }
+
+    for (auto value : mValues)
+    {
+        HashValue(hash, value);
+    }
+
+    return hash;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file MachineState.h
+ * @author Thomas Toaz
+ *
+ * Snapshot of the simulation state of a machine at one frame.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_MACHINESTATE_H
+#define CANADIANEXPERIENCE_MACHINELIB_MACHINESTATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class b2Body;
+
+/**
+ * Snapshot of the simulation state of a machine at one frame.
+ *
+ * Components save their physics bodies and any other values
+ * they need to draw themselves, in machine order. Restoring
+ * reads the values back in that same order, so a state can
+ * only be restored into a machine with the same number.
+ *
+ * A saved state is never modified, so it can be handed
+ * between threads.
+ */
+class MachineState
+{
+public:
+    /// The saved state of one physics body
+    struct BodyState
+    {
+        float x = 0;        ///< Position X in meters
+        float y = 0;        ///< Position Y in meters
+        float angle = 0;    ///< Angle in radians
+        float vx = 0;       ///< Linear velocity X in meters per second
+        float vy = 0;       ///< Linear velocity Y in meters per second
+        float omega = 0;    ///< Angular velocity in radians per second
+        bool awake = false; ///< Is the body awake?
+        bool installed = false; ///< Was the body installed in the physics system?
+    };
+
+    /**
+     * Reads a state back in the order it was saved.
+     */
+    class Reader
+    {
+    private:
+        /// The state we are reading
+        const MachineState &mState;
+
+        /// Next body to read
+        size_t mBody = 0;
+
+        /// Next value to read
+        size_t mValue = 0;
+
+    public:
+        /**
+         * Constructor
+         * @param state The state to read
+         */
+        explicit Reader(const MachineState &state) : mState(state) {}
+
+        void RestoreBody(b2Body *body);
+        double NextValue();
+    };
+
+private:
+    /// Number of the machine this is a state for
+    int mMachineNumber;
+
+    /// Machine frame this is the state at
+    int mFrame;
+
+    /// Saved physics bodies in machine order
+    std::vector<BodyState> mBodies;
+
+    /// Saved component values in machine order
+    std::vector<double> mValues;
+
+public:
+    /**
+     * Constructor
+     * @param machineNumber Number of the machine this is a state for
+     * @param frame Machine frame this is the state at
+     */
+    MachineState(int machineNumber, int frame) : mMachineNumber(machineNumber), mFrame(frame) {}
+
+    void SaveBody(b2Body *body);
+
+    /**
+     * Save a component value
+     * @param value Value to save
+     */
+    void SaveValue(double value) { mValues.push_back(value); }
+
+    /**
+     * Get the number of the machine this is a state for
+     * @return Machine number
+     */
+    int GetMachineNumber() const { return mMachineNumber; }
+
+    /**
+     * Get the machine frame this is the state at
+     * @return Frame number
+     */
+    int GetFrame() const { return mFrame; }
+
+    /**
+     * Get the saved physics bodies
+     * @return Body states in machine order
+     */
+    const std::vector<BodyState> &GetBodies() const { return mBodies; }
+
+    /**
+     * Get the saved component values
+     * @return Values in machine order
+     */
+    const std::vector<double> &GetValues() const { return mValues; }
+
+    uint64_t GetHash() const;
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_MACHINESTATE_H
@@ -8,19 +8,25 @@
 #include "Machine.h"
 #include "MachineFactory1.h"
 #include "MachineFactory2.h"
+#include "MachineFactory3.h"
+#include "MachineState.h"
 
 /// number of machine 1
 const int Machine1Number = 1;
 
+/// number of machine 2, which is built for any number without a machine of its own
+const int Machine2Number = 2;
+
+/// number of machine 3, the generated stress machine
+const int Machine3Number = 3;
+
 /**
  * Constructor for the machine system
  * @param resourcesDir
  */
-MachineSystemActual::MachineSystemActual(std::wstring resourcesDir)
+MachineSystemActual::MachineSystemActual(std::wstring resourcesDir) : mMachineNumber(Machine1Number)
 {
     mResourcesDir = resourcesDir;
-    SetMachineNumber(Machine1Number);
-
 }
 
 /**
@@ -47,16 +53,26 @@ wxPoint MachineSystemActual::GetLocation()
 */
 void MachineSystemActual::DrawMachine(std::shared_ptr<wxGraphicsContext> graphics)
 {
-    graphics->PushState();
-    graphics->Translate(mLocation.x, mLocation.y);
-    graphics->Scale(mPixelsPerCentimeter, -mPixelsPerCentimeter);
-
-    // Draw your machine assuming an origin of 0,0
-    mMachine->DrawMachine(graphics);
+    RenderList list;
+    RecordMachine(list);
+    list.Replay(graphics);
+}
 
-    graphics->PopState();
+/**
+ * Record drawing the machine at the currently specified location
+ * @param list Render list to record into
+ */
+void MachineSystemActual::RecordMachine(RenderList &list)
+{
+    list.PushState();
+    list.Translate(mLocation.x, mLocation.y);
+    list.Scale(mPixelsPerCentimeter, -mPixelsPerCentimeter);
 
+    // Draw your machine assuming an origin of 0,0
+    Activate();
+    mMachine->RecordMachine(list);
 
+    list.PopState();
 }
 
 /**
@@ -65,9 +81,21 @@ void MachineSystemActual::DrawMachine(std::shared_ptr<wxGraphicsContext> graphic
 */
 void MachineSystemActual::SetMachineFrame(int frame)
 {
-    if(frame < mCurrentFrame)
+    if(mMachine == nullptr && frame <= 0)
+    {
+        // A machine that has not been built is already at its start
+        mCurrentFrame = 0;
+        return;
+    }
+
+    Activate();
+    if(frame < mCurrentFrame || (mRestored && frame != mCurrentFrame))
     {
+        // A restored state does not include Box2D's contacts, warm
+        // starting impulses or sleep timers, so stepping on from one
+        // would not match the machine simulated from the start
         mCurrentFrame = 0;
+        mRestored = false;
         mMachine->Reset();
     }
 
@@ -96,17 +124,42 @@ void MachineSystemActual::SetFrameRate([[maybe_unused]] double rate)
 */
 void MachineSystemActual::SetMachineNumber(int machine)
 {
-    if(machine == Machine1Number)
+    // The machine is built when it is first needed
+    mMachineNumber = machine == Machine1Number || machine == Machine3Number ? machine : Machine2Number;
+    mMachine = nullptr;
+    mCurrentFrame = 0;
+    mRestored = false;
+}
+
+/**
+ * Build the machine if it has not been built yet
+ */
+void MachineSystemActual::Activate()
+{
+    if(mMachine != nullptr)
+    {
+        return;
+    }
+
+    if(mMachineNumber == Machine1Number)
     {
         MachineFactory1 machineFactory(mResourcesDir);
         mMachine = machineFactory.Create();
     }
+    else if(mMachineNumber == Machine3Number)
+    {
+        MachineFactory3 machineFactory(mResourcesDir, mStressParameters);
+        mMachine = machineFactory.Create();
+    }
     else
     {
         MachineFactory2 machineFactory(mResourcesDir);
         mMachine = machineFactory.Create();
     }
+    mMachine->SetBatchContacts(mBatchContacts);
     mMachine->Reset();
+    mCurrentFrame = 0;
+    mRestored = false;
 }
 
 /**
@@ -115,7 +168,7 @@ void MachineSystemActual::SetMachineNumber(int machine)
  */
 int MachineSystemActual::GetMachineNumber()
 {
-    return mMachine->GetMachine();
+    return mMachineNumber;
 }
 
 /**
@@ -125,4 +178,84 @@ int MachineSystemActual::GetMachineNumber()
 double MachineSystemActual::GetMachineTime()
 {
     return mCurrentFrame/mFrameRate;
-}
\ No newline at end of file
+}
+
+/**
+ * Get a snapshot of the simulation state at the current frame
+ * @return Machine state
+ */
+std::shared_ptr<const MachineState> MachineSystemActual::GetMachineState()
+{
+    Activate();
+    return mMachine->SaveState(mCurrentFrame);
+}
+
+/**
+ * Restore a simulation state saved by GetMachineState
+ *
+ * States for a different machine number are ignored. The
+ * restored state is only for display: the next SetMachineFrame
+ * to any other frame simulates again from the start.
+ * @param state State to restore
+ */
+void MachineSystemActual::SetMachineState(const MachineState &state)
+{
+    if(state.GetMachineNumber() != mMachineNumber)
+    {
+        return;
+    }
+
+    Activate();
+    mMachine->RestoreState(state);
+    mCurrentFrame = state.GetFrame();
+    mRestored = true;
+}
+
+/**
+ * Get where the physics world spent its time in the last machine update
+ * @return Box2D profile or nullptr if the machine has not been built
+ */
+const b2Profile *MachineSystemActual::GetProfile() const
+{
+    return mMachine != nullptr ? &mMachine->GetProfile() : nullptr;
+}
+
+/**
+ * Set whether begin contact events are delivered in a batch after each physics step
+ *
+ * The machine simulates the same either way; this only
+ * changes when component contact handlers are called.
+ * @param batched True to deliver them after the step
+ */
+void MachineSystemActual::SetBatchContacts(bool batched)
+{
+    mBatchContacts = batched;
+    if(mMachine != nullptr)
+    {
+        mMachine->SetBatchContacts(batched);
+    }
+}
+
+/**
+ * Get the contact counts for the last physics step
+ * @return Statistics, all zero if the machine has not been built
+ */
+ContactListener::Statistics MachineSystemActual::GetContactStatistics() const
+{
+    return mMachine != nullptr ? mMachine->GetContactStatistics() : ContactListener::Statistics();
+}
+
+/**
+ * Set the size of the generated stress machine (machine 3)
+ *
+ * If machine 3 has been built, it is rebuilt when next needed.
+ * @param parameters Size of the machine
+ */
+void MachineSystemActual::SetStressParameters(const MachineFactory3::Parameters &parameters)
+{
+    mStressParameters = parameters;
+    if(mMachineNumber == Machine3Number)
+    {
+        SetMachineNumber(Machine3Number);
+    }
+}
@@ -10,17 +10,28 @@
 #define CANADIANEXPERIENCE_MACHINELIB_MACHINESYSTEMACTUAL_H
 
 #include "IMachineSystem.h"
+#include "MachineFactory3.h"
+#include "RenderList.h"
+#include "ContactListener.h"
 
 class Machine;
+class MachineState;
+struct b2Profile;
 
 /**
  * A Machine System class that displays a machine.
+ *
+ * IMachineSystem may not be changed, so the machine states,
+ * deferred building and recorded drawing this adds are only
+ * available on this class. Callers holding an IMachineSystem
+ * reach them with std::dynamic_pointer_cast.
  */
 class MachineSystemActual : public IMachineSystem
 {
 private:
     /**
      * A pointer to the machine class being displayed.
+     * This is nullptr until the machine is first needed.
      */
     std::shared_ptr<Machine> mMachine;
 
@@ -49,12 +60,24 @@ private:
      */
     int mCurrentFrame = 0;
 
+    /// True if the machine shows a restored state rather than one it simulated
+    bool mRestored = false;
+
     /// How many pixels there are for each CM
     double mPixelsPerCentimeter = 1.5;
 
     /// Resource Directory of the project
     std::wstring mResourcesDir;
 
+    /// Number of the machine to build
+    int mMachineNumber;
+
+    /// Size of the generated stress machine
+    MachineFactory3::Parameters mStressParameters;
+
+    /// Are begin contact events delivered in a batch after each step?
+    bool mBatchContacts = false;
+
 public:
     /// Constructor
     MachineSystemActual(std::wstring resourcesDir);
@@ -69,6 +92,7 @@ public:
     wxPoint GetLocation() override;
 
     void DrawMachine(std::shared_ptr<wxGraphicsContext> graphics) override;
+    void RecordMachine(RenderList &list);
     void SetMachineFrame(int frame) override;
     void SetFrameRate(double rate) override;
     void SetMachineNumber(int machine) override;
@@ -81,6 +105,23 @@ public:
      */
     void SetFlag(int flag) override {}
 
+    std::shared_ptr<const MachineState> GetMachineState();
+    void SetMachineState(const MachineState &state);
+    void Activate();
+
+    /**
+     * Has the machine been built yet?
+     * @return true if built
+     */
+    bool IsActive() const { return mMachine != nullptr; }
+
+    const b2Profile *GetProfile() const;
+
+    void SetBatchContacts(bool batched);
+    ContactListener::Statistics GetContactStatistics() const;
+
+    void SetStressParameters(const MachineFactory3::Parameters &parameters);
+
 };
 
 #endif //CANADIANEXPERIENCE_MACHINELIB_MACHINESYSTEMACTUAL_H
@@ -0,0 +1,98 @@
+/**
+ * @file MachineTrace.cpp
+ * @author Thomas Toaz
+ */
+
+#include <fstream>
+
+#include "MachineTrace.h"
+#include "MachineState.h"
+
+/**
+ * Add the state for the next frame to the trace
+ * @param state State after the machine was advanced to the frame
+ */
+void MachineTrace::Add(const MachineState &state)
+{
+    mHashes.push_back(state.GetHash());
+}
+
+/**
+ * Save the trace to a file.
+ *
+ * The file is text, with the machine number on the first
+ * line and one hexadecimal hash per frame after it.
+ * @param filename File to save to
+ * @return true if successful
+ */
+bool MachineTrace::Save(const std::string &filename) const
+{
+    std::ofstream file(filename);
+    if (!file)
+    {
+        return false;
+    }
+
+    file << "machine " << mMachineNumber << std::endl;
+    file << std::hex;
+    for (auto hash : mHashes)
+    {
+        file << hash << std::endl;
+    }
+
+    return bool(file);
+}
+
+/**
+ * Load a trace saved by Save
+ * @param filename File to load from
+ * @return true if successful
+ */
+bool MachineTrace::Load(const std::string &filename)
+{
+    std::ifstream file(filename);
+    std::string keyword;
+    int machineNumber;
+    if (!(file >> keyword >> machineNumber) || keyword != "machine")
+    {
+        return false;
+    }
+
+    mMachineNumber = machineNumber;
+    mHashes.clear();
+
+    uint64_t hash;
+    file >> std::hex;
+    while (file >> hash)
+    {
+        mHashes.push_back(hash);
+    }
+
+    return file.eof();
+}
+
+/**
+ * Find the first frame where this trace and another differ
+ *
+ * Traces of different lengths differ at the end of the shorter one.
+ * @param other Trace to compare against
+ * @return Frame number or -1 if the traces are identical
+ */
+int MachineTrace::FirstDivergence(const MachineTrace &other) const
+{
+    if (mMachineNumber != other.mMachineNumber)
+    {
+        return 0;
+    }
+
+    size_t frame = 0;
+    for ( ; frame < mHashes.size() && frame < other.mHashes.size(); frame++)
+    {
+        if (mHashes[frame] != other.mHashes[frame])
+        {
+            return int(frame);
+        }
+    }
+
+    return mHashes.size() == other.mHashes.size() ? -1 : int(frame);
+}
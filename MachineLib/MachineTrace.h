@@ -0,0 +1,68 @@
+/**
+ * @file MachineTrace.h
+ * @author Thomas Toaz
+ *
+ * Per-frame hashes of a machine simulation.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_MACHINETRACE_H
+#define CANADIANEXPERIENCE_MACHINELIB_MACHINETRACE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MachineState;
+
+/**
+ * Per-frame hashes of a machine simulation.
+ *
+ * A trace saved from a known good build is a golden trace.
+ * Comparing a new trace against it finds the first frame
+ * where a change to the simulation code or the build flags
+ * made the simulation diverge.
+ */
+class MachineTrace
+{
+private:
+    /// Number of the machine this is a trace of
+    int mMachineNumber;
+
+    /// State hash for each frame, starting at frame 0
+    std::vector<uint64_t> mHashes;
+
+public:
+    /**
+     * Constructor
+     * @param machineNumber Number of the machine this is a trace of
+     */
+    explicit MachineTrace(int machineNumber = 0) : mMachineNumber(machineNumber) {}
+
+    void Add(const MachineState &state);
+
+    bool Save(const std::string &filename) const;
+    bool Load(const std::string &filename);
+
+    int FirstDivergence(const MachineTrace &other) const;
+
+    /**
+     * Get the number of the machine this is a trace of
+     * @return Machine number
+     */
+    int GetMachineNumber() const { return mMachineNumber; }
+
+    /**
+     * Get the number of frames in the trace
+     * @return Number of frames
+     */
+    int GetFrameCount() const { return int(mHashes.size()); }
+
+    /**
+     * Get the hash for a frame
+     * @param frame Frame number
+     * @return State hash
+     */
+    uint64_t GetHash(int frame) const { return mHashes[frame]; }
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_MACHINETRACE_H
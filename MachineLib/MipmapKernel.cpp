@@ -0,0 +1,204 @@
+/**
+ * @file MipmapKernel.cpp
+ * @author Thomas Toaz
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+/// SSE2 is available
+#define MIPMAPKERNEL_SSE2
+#endif
+
+#include "MipmapKernel.h"
+
+/**
+ * Get the size of the next level for a width or height
+ * @param size Width or height of a level
+ * @return Width or height of the level after it, at least 1
+ */
+int MipmapKernel::HalfSize(int size)
+{
+    return std::max(1, size / 2);
+}
+
+/**
+ * Build the next mipmap level of a pixel plane with a 2x2 box filter.
+ *
+ * Each destination value is the rounded average of the four
+ * source values under it. A last odd row or column is dropped,
+ * and a plane one pixel wide or high is only halved the other
+ * way. The rows are summed sixteen values at a time with SSE2
+ * when it is available. The result is the same either way.
+ * @param src Source pixels, width * height * channels values
+ * @param width Source width in pixels
+ * @param height Source height in pixels
+ * @param channels Values per pixel, 3 for RGB or 1 for alpha
+ * @param dst Destination of HalfSize(width) * HalfSize(height) * channels values
+ */
+void MipmapKernel::Downsample(const unsigned char *src, int width, int height, int channels, unsigned char *dst)
+{
+    int dstWidth = HalfSize(width);
+    int dstHeight = HalfSize(height);
+    size_t rowValues = size_t(width) * channels;
+
+    // Sum of each value in a pair of source rows
+    std::vector<unsigned short> sums(rowValues);
+
+    for (int row = 0; row < dstHeight; row++)
+    {
+        const unsigned char *row0 = src + size_t(std::min(row * 2, height - 1)) * rowValues;
+        const unsigned char *row1 = src + size_t(std::min(row * 2 + 1, height - 1)) * rowValues;
+
+        size_t i = 0;
+
+#ifdef MIPMAPKERNEL_SSE2
+        auto zero = _mm_setzero_si128();
+        for ( ; i + 16 <= rowValues; i += 16)
+        {
+            auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + i));
+            auto b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + i));
+            auto low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            auto high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sums.data() + i), low);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sums.data() + i + 8), high);
+        }
+#endif
+
+        for ( ; i < rowValues; i++)
+        {
+            sums[i] = (unsigned short)(row0[i] + row1[i]);
+        }
+
+        unsigned char *line = dst + size_t(row) * dstWidth * channels;
+        for (int col = 0; col < dstWidth; col++)
+        {
+            size_t left = size_t(std::min(col * 2, width - 1)) * channels;
+            size_t right = size_t(std::min(col * 2 + 1, width - 1)) * channels;
+            for (int c = 0; c < channels; c++)
+            {
+                line[col * channels + c] = (unsigned char)((sums[left + c] + sums[right + c] + 2) >> 2);
+            }
+        }
+    }
+}
+
+/**
+ * Reduce a pixel plane by a whole factor with a box filter.
+ *
+ * Each destination value is the rounded average of the factor by
+ * factor block of source values under it. Rows and columns past
+ * the last whole block are dropped. The rows of a block are summed
+ * sixteen values at a time with SSE2 when it is available, and
+ * four channel pixels are summed across a block a pixel at a time.
+ * The result is the same either way.
+ *
+ * A tall plane can be reduced a strip at a time, as long as each
+ * strip is a whole number of blocks high.
+ * @param src Source pixels, width * height * channels values
+ * @param width Source width in pixels
+ * @param height Source height in pixels
+ * @param channels Values per pixel
+ * @param factor Source pixels across and down each destination pixel, 1 to MaxBoxFactor
+ * @param dst Destination of (width / factor) * (height / factor) * channels values
+ */
+void MipmapKernel::DownsampleBox(const unsigned char *src, int width, int height, int channels, int factor,
+        unsigned char *dst)
+{
+    factor = std::clamp(factor, 1, MaxBoxFactor);
+    int dstWidth = width / factor;
+    int dstHeight = height / factor;
+    size_t rowValues = size_t(width) * channels;
+    unsigned count = unsigned(factor * factor);
+
+    // Sum of each value down the rows of a block, at most 16 * 255
+    std::vector<unsigned short> sums(rowValues);
+
+    for (int row = 0; row < dstHeight; row++)
+    {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int y = 0; y < factor; y++)
+        {
+            const unsigned char *line = src + size_t(row * factor + y) * rowValues;
+
+            size_t i = 0;
+
+#ifdef MIPMAPKERNEL_SSE2
+            auto zero = _mm_setzero_si128();
+            for ( ; i + 16 <= rowValues; i += 16)
+            {
+                auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(line + i));
+                auto low = reinterpret_cast<__m128i *>(sums.data() + i);
+                auto high = reinterpret_cast<__m128i *>(sums.data() + i + 8);
+                _mm_storeu_si128(low, _mm_add_epi16(_mm_loadu_si128(low), _mm_unpacklo_epi8(a, zero)));
+                _mm_storeu_si128(high, _mm_add_epi16(_mm_loadu_si128(high), _mm_unpackhi_epi8(a, zero)));
+            }
+#endif
+
+            for ( ; i < rowValues; i++)
+            {
+                sums[i] = (unsigned short)(sums[i] + line[i]);
+            }
+        }
+
+        unsigned char *out = dst + size_t(row) * dstWidth * channels;
+        for (int col = 0; col < dstWidth; col++)
+        {
+            const unsigned short *block = sums.data() + size_t(col) * factor * channels;
+
+#ifdef MIPMAPKERNEL_SSE2
+            if (channels == 4)
+            {
+                // The four channels of a pixel are summed side by side
+                auto total = _mm_setzero_si128();
+                for (int x = 0; x < factor; x++)
+                {
+                    auto pixel = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(block + x * 4));
+                    total = _mm_add_epi32(total, _mm_unpacklo_epi16(pixel, _mm_setzero_si128()));
+                }
+
+                alignas(16) unsigned int values[4];
+                _mm_store_si128(reinterpret_cast<__m128i *>(values), total);
+                for (int c = 0; c < 4; c++)
+                {
+                    out[col * 4 + c] = (unsigned char)((values[c] + count / 2) / count);
+                }
+                continue;
+            }
+#endif
+
+            for (int c = 0; c < channels; c++)
+            {
+                unsigned total = 0;
+                for (int x = 0; x < factor; x++)
+                {
+                    total += block[x * channels + c];
+                }
+
+                out[col * channels + c] = (unsigned char)((total + count / 2) / count);
+            }
+        }
+    }
+}
+
+/**
+ * Choose the mipmap level to draw at a scale.
+ *
+ * The level whose size is closest to the drawn size is chosen,
+ * comparing sizes as powers of two.
+ * @param scale Device pixels per level 0 pixel
+ * @param levels Number of levels available
+ * @return Level from 0 to levels - 1
+ */
+int MipmapKernel::SelectLevel(double scale, int levels)
+{
+    if (!(scale > 0) || levels <= 1)
+    {
+        return 0;
+    }
+
+    return std::clamp(int(std::lround(-std::log2(scale))), 0, levels - 1);
+}
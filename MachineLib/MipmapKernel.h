@@ -0,0 +1,33 @@
+/**
+ * @file MipmapKernel.h
+ * @author Thomas Toaz
+ *
+ * Pixel kernels that build and choose mipmap levels.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_MIPMAPKERNEL_H
+#define CANADIANEXPERIENCE_MACHINELIB_MIPMAPKERNEL_H
+
+#include <cstddef>
+
+/**
+ * Pixel kernels that build and choose mipmap levels.
+ *
+ * Level 0 is the full image and each level after it is half the
+ * size of the one before. These work on raw pixel planes, so
+ * they do not depend on wxWidgets.
+ */
+class MipmapKernel
+{
+public:
+    /// Largest factor DownsampleBox reduces by
+    static constexpr int MaxBoxFactor = 16;
+
+    static int HalfSize(int size);
+    static void Downsample(const unsigned char *src, int width, int height, int channels, unsigned char *dst);
+    static void DownsampleBox(const unsigned char *src, int width, int height, int channels, int factor,
+            unsigned char *dst);
+    static int SelectLevel(double scale, int levels);
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_MIPMAPKERNEL_H
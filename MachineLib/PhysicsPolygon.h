@@ -11,16 +11,13 @@
  * Version history:
  * 1.00 Initial version for FS23 project 2
  * 1.01 Revised to work prior to physics installation
+ * 1.02 Physics system side moved to PhysicsShape
  */
 
 #pragma once
 
 #include "Polygon.h"
-#include <b2_math.h>
-#include <b2_body.h>
-
-class b2Body;
-class b2World;
+#include "PhysicsShape.h"
 
 namespace cse335
 {
@@ -38,27 +35,8 @@ namespace cse335
 class PhysicsPolygon : public Polygon
 {
 private:
-    /// The physics system body for this component
-    /// Null until installed in the physics system
-    b2Body *mBody = nullptr;
-
-    /// Initial rotation of the component in radians
-    double mInitialRotation = 0;
-
-    /// The location of the component in the machine
-    wxPoint2DDouble mInitialPosition;
-
-    /// What is the body type
-    b2BodyType mType = b2_staticBody;
-
-    /// Density in kg/m^2
-    double mDensity = 1.0;
-
-    /// Friction coefficient in the range [0, 1]
-    double mFriction = 0.5f;
-
-    /// Restitution (elasticity) in the range [0, 1]
-    double mRestitution = 0.5;
+    /// The physics system side of this polygon
+    PhysicsShape mShape;
 
 public:
     PhysicsPolygon();
@@ -70,19 +48,20 @@ public:
     void operator=(const PhysicsPolygon &) = delete;
 
     virtual void Draw(std::shared_ptr<wxGraphicsContext> graphics);
+    virtual void Record(RenderList &list);
 
     /**
      * Set the component position in the machine
      * @param x X position in centimeters
      * @param y Y position in centimeters
      */
-    void SetInitialPosition(double x, double y) { mInitialPosition = wxPoint2DDouble(x, y); }
+    void SetInitialPosition(double x, double y) { mShape.SetInitialPosition(x, y); }
 
     /**
      * Set the component initial rotation
      * @param r Rotation in turns (0-1 for one rotation)
      */
-    void SetInitialRotation(double r) { mInitialRotation = r * M_PI * 2; }
+    void SetInitialRotation(double r) { mShape.SetInitialRotation(r); }
 
     void SetRotation(double rotation);
 
@@ -94,9 +73,32 @@ public:
 
     void InstallPhysics(std::shared_ptr<b2World> world);
 
-    void SetDynamic();
-    void SetKinematic();
-    void SetPhysics(double density=1.0, double friction=0.5, double restitution=0.5);
+    /**
+     * Make this component a dynamic component
+     *
+     * Dynamic components move based on the physics
+     */
+    void SetDynamic() { mShape.SetDynamic(); }
+
+    /**
+     * Make this component a kinematic component
+     *
+     * Kinematic components move based on defined velocities.
+     */
+    void SetKinematic() { mShape.SetKinematic(); }
+
+    /**
+     * Set the physics characteristics of this component.
+     *
+     * Must be called before InstallPhysics is called.
+     * @param density Density in kg/m^2
+     * @param friction Friction coefficient in the range [0, 1]
+     * @param restitution Restitution value in the range [0, 1]
+     */
+    void SetPhysics(double density=1.0, double friction=0.5, double restitution=0.5)
+    {
+        mShape.SetPhysics(density, friction, restitution);
+    }
 
     /**
      * Get the physics body for this component.
@@ -104,7 +106,13 @@ public:
      * Only set after InstallPhysics has been called.
      * @return b2Body object
      */
-    b2Body* GetBody() {return mBody;}
+    b2Body* GetBody() {return mShape.GetBody();}
+
+    /**
+     * Get the physics system side of this polygon
+     * @return Pointer to the PhysicsShape object
+     */
+    PhysicsShape *GetShape() {return &mShape;}
 };
 
 } // cse335
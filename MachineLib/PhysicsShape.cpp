@@ -0,0 +1,193 @@
+/**
+ * @file PhysicsShape.cpp
+ * @author Thomas Toaz
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <b2_polygon_shape.h>
+#include <b2_circle_shape.h>
+#include <b2_fixture.h>
+#include <b2_world.h>
+
+#include "PhysicsShape.h"
+#include "Consts.h"
+
+/**
+ * Make the shape a polygon
+ * @param vertices Polygon vertices in centimeters
+ */
+void PhysicsShape::SetPolygon(const std::vector<Vertex> &vertices)
+{
+    mVertices = vertices;
+    mRadius = 0;
+}
+
+/**
+ * Make the shape a circle centered on the part position
+ * @param radius Radius in centimeters
+ */
+void PhysicsShape::SetCircle(double radius)
+{
+    mVertices.clear();
+    mRadius = radius;
+}
+
+/**
+ * Set the part initial rotation
+ * @param rotation Rotation in turns (0-1 for one rotation)
+ */
+void PhysicsShape::SetInitialRotation(double rotation)
+{
+    mInitialRotation = rotation * M_PI * 2;
+}
+
+/**
+ * Install this part into the physics system world.
+ * @param world Physics system world
+ */
+void PhysicsShape::InstallPhysics(std::shared_ptr<b2World> world)
+{
+    // Create the physics system body we will need for any
+    // item in the physics space
+    b2BodyDef bodyDefinition;
+    bodyDefinition.type = mType;
+    mBody = world->CreateBody(&bodyDefinition);
+
+    b2FixtureDef fixtureDef;
+
+    // These must be in the same scope as fixtureDef:
+    b2CircleShape circle;
+    b2PolygonShape poly;
+
+    if(IsCircle())
+    {
+        circle.m_radius = mRadius / Consts::MtoCM - 0.005;
+        fixtureDef.shape = &circle;
+    }
+    else if(!mVertices.empty())
+    {
+        // Determine the maximum values in each dimension
+        auto minX = mVertices[0].x, maxX = mVertices[0].x;
+        auto minY = mVertices[0].y, maxY = mVertices[0].y;
+        for(auto v : mVertices)
+        {
+            minX = std::min(minX, v.x);
+            maxX = std::max(maxX, v.x);
+            minY = std::min(minY, v.y);
+            maxY = std::max(maxY, v.y);
+        }
+
+        // Box2D adds a 0.5cm "skin" around objects. This shrinks the
+        // representation in that system to reflect that extra skin in the size
+        double sizeX = (maxX - minX) / 2;
+        double sizeY = (maxY - minY) / 2;
+        double centerX = minX + sizeX;
+        double centerY = minY + sizeY;
+        double scaleX = (sizeX - 0.95) / sizeX;
+        double scaleY = (sizeY - 0.95) / sizeY;
+
+        std::vector<b2Vec2> vertices;
+        for(auto v : mVertices)
+        {
+            double scaledX = (v.x - centerX) * scaleX + centerX;
+            double scaledY = (v.y - centerY) * scaleY + centerY;
+
+            vertices.push_back(b2Vec2(scaledX / Consts::MtoCM, scaledY / Consts::MtoCM));
+        }
+
+        poly.Set(&vertices[0], vertices.size());
+        fixtureDef.shape = &poly;
+    }
+
+    fixtureDef.density = mDensity;
+    fixtureDef.friction = mFriction;
+    fixtureDef.restitution = mRestitution;
+
+    if(fixtureDef.shape != nullptr)
+    {
+        mBody->CreateFixture(&fixtureDef);
+    }
+
+    mBody->SetTransform(b2Vec2(mInitialPosition.x / Consts::MtoCM,
+                               mInitialPosition.y / Consts::MtoCM), mInitialRotation);
+}
+
+/**
+ * Get the part position in the machine.
+ * @return Position in centimeters
+ */
+PhysicsShape::Vertex PhysicsShape::GetPosition() const
+{
+    if(mBody != nullptr)
+    {
+        // Once installed in the physics system, we us
+        // the current position from that system, converting
+        // meters to centimeters.
+        auto position = mBody->GetPosition();
+
+        return Vertex{position.x * Consts::MtoCM, position.y * Consts::MtoCM};
+    }
+    else
+    {
+        return mInitialPosition;
+    }
+}
+
+/**
+ * Set the part rotation (current)
+ *
+ * Rotation is in turns, not radians or degrees
+ *
+ * @param rotation Rotation in turns
+ */
+void PhysicsShape::SetRotation(double rotation)
+{
+    if(mBody != nullptr)
+    {
+        mBody->SetTransform(mBody->GetPosition(), rotation * M_PI * 2);
+        mBody->SetGravityScale(0);
+    }
+    else
+    {
+        SetInitialRotation(rotation);
+    }
+}
+
+/**
+ * Get the part rotation
+ * @return Rotation in turns (0-1)
+ */
+double PhysicsShape::GetRotation() const
+{
+    auto rotation = mBody != nullptr ? mBody->GetAngle() : mInitialRotation;
+    return rotation / (M_PI * 2);
+}
+
+/**
+ * Set the physics characteristics of this part.
+ *
+ * Must be called before InstallPhysics is called.
+ * @param density Density in kg/m^2
+ * @param friction Friction coefficient in the range [0, 1]
+ * @param restitution Restitution value in the range [0, 1]
+ */
+void PhysicsShape::SetPhysics(double density, double friction, double restitution)
+{
+    mDensity = density;
+    mFriction = friction;
+    mRestitution = restitution;
+}
+
+/**
+ * Set the angular velocity (rotation speed)
+ * @param speed Speed in turns per second
+ */
+void PhysicsShape::SetAngularVelocity(double speed)
+{
+    if(mBody != nullptr)
+    {
+        mBody->SetAngularVelocity(speed * M_PI * 2);
+    }
+}
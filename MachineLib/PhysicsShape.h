@@ -0,0 +1,120 @@
+/**
+ * @file PhysicsShape.h
+ * @author Thomas Toaz
+ *
+ * The physics system side of a machine part.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_PHYSICSSHAPE_H
+#define CANADIANEXPERIENCE_MACHINELIB_PHYSICSSHAPE_H
+
+#include <memory>
+#include <vector>
+#include <b2_math.h>
+#include <b2_body.h>
+
+class b2World;
+
+/**
+ * The physics system side of a machine part.
+ *
+ * This holds the shape, material and body of a part in the
+ * physics system and nothing about how it is drawn, so it
+ * does not depend on wxWidgets.
+ *
+ * Note: Dimensions are in centimeters.
+ */
+class PhysicsShape
+{
+public:
+    /// A shape vertex in centimeters
+    struct Vertex
+    {
+        double x = 0;   ///< X in centimeters
+        double y = 0;   ///< Y in centimeters
+    };
+
+private:
+    /// The physics system body for this part
+    /// Null until installed in the physics system
+    b2Body *mBody = nullptr;
+
+    /// Vertices of the shape if it is a polygon
+    std::vector<Vertex> mVertices;
+
+    /// Radius of the shape if it is a circle, otherwise 0
+    double mRadius = 0;
+
+    /// Initial rotation of the part in radians
+    double mInitialRotation = 0;
+
+    /// The location of the part in the machine
+    Vertex mInitialPosition;
+
+    /// What is the body type
+    b2BodyType mType = b2_staticBody;
+
+    /// Density in kg/m^2
+    double mDensity = 1.0;
+
+    /// Friction coefficient in the range [0, 1]
+    double mFriction = 0.5;
+
+    /// Restitution (elasticity) in the range [0, 1]
+    double mRestitution = 0.5;
+
+public:
+    PhysicsShape() = default;
+
+    /// Copy constructor (disabled)
+    PhysicsShape(const PhysicsShape &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const PhysicsShape &) = delete;
+
+    void SetPolygon(const std::vector<Vertex> &vertices);
+    void SetCircle(double radius);
+
+    /**
+     * Is the shape a circle?
+     * @return true if a circle
+     */
+    bool IsCircle() const { return mRadius > 0; }
+
+    /**
+     * Set the part position in the machine
+     * @param x X position in centimeters
+     * @param y Y position in centimeters
+     */
+    void SetInitialPosition(double x, double y) { mInitialPosition = Vertex{x, y}; }
+
+    void SetInitialRotation(double rotation);
+    void SetRotation(double rotation);
+    double GetRotation() const;
+    Vertex GetPosition() const;
+    void SetAngularVelocity(double speed);
+
+    void InstallPhysics(std::shared_ptr<b2World> world);
+
+    /**
+     * Make this a dynamic body, moved by the physics
+     */
+    void SetDynamic() { mType = b2_dynamicBody; }
+
+    /**
+     * Make this a kinematic body, moved by set velocities
+     */
+    void SetKinematic() { mType = b2_kinematicBody; }
+
+    void SetPhysics(double density = 1.0, double friction = 0.5, double restitution = 0.5);
+
+    /**
+     * Get the physics body for this part.
+     *
+     * Only set after InstallPhysics has been called.
+     * @return b2Body object
+     */
+    b2Body *GetBody() { return mBody; }
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_PHYSICSSHAPE_H
@@ -6,13 +6,43 @@
 
 #include "pch.h"
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <wx/hyperlink.h>
+#include <wx/thread.h>
 
 #include "Polygon.h"
+#include "AlphaKernel.h"
+#include "MipmapKernel.h"
+#include "ImageAtlas.h"
+#include "ImageMemory.h"
+#include "RenderImage.h"
 
 using namespace cse335;
 
+/**
+ * Tell the user an image could not be loaded.
+ *
+ * Images are set while machines are built and decoded when first
+ * drawn, and both can happen on worker threads. A message box may
+ * only be shown on the UI thread, so it is queued to the
+ * application to show there.
+ * @param filename Image file that could not be loaded
+ */
+static void ReportLoadFailure(const std::wstring &filename)
+{
+    if(wxTheApp == nullptr)
+    {
+        return;
+    }
+
+    std::wstringstream str;
+    str << L"Unable to load '" << filename << "'" << std::endl;
+    wxString message = str.str();
+    wxTheApp->CallAfter([message] { wxMessageBox(message, L"Polygon Image File Load Failure!"); });
+}
+
 /**
  * Constructor
  */
@@ -25,6 +55,7 @@ Polygon::Polygon() : mBrush(*wxBLACK)
  */
 Polygon::~Polygon()
 {
+    ImageMemory::Shared().Forget(this);
 }
 
 /**
@@ -44,6 +75,7 @@ void Polygon::AddPoint(double x, double y)
     }
 
     mPoints.push_back(wxPoint2DDouble(x, y));
+    mMaskDirty = true;
 }
 
 
@@ -64,7 +96,7 @@ void Polygon::Rectangle(double x, double y, double width, double height)
     if(width <= 0)
     {
         // Optional automatic width determination from image
-        if(!Assert(mImage != nullptr,
+        if(!Assert(LoadImage(),
                    L"You must select an image before calling Rectangle with no specified width."))
         {
             return;
@@ -76,7 +108,7 @@ void Polygon::Rectangle(double x, double y, double width, double height)
     if(height <= 0)
     {
         // Optional automatic height determination from image
-        if(!Assert(mImage != nullptr,
+        if(!Assert(LoadImage(),
                L"You must select an image before calling Rectangle with no specified height."))
         {
             return;
@@ -114,7 +146,7 @@ void Polygon::BottomCenteredRectangle(double width, double height)
 {
     if(width == 0)
     {
-        if(!Assert(mImage != nullptr,
+        if(!Assert(LoadImage(),
                 L"You must select an image before calling BottomCenteredRectangle with no width."))
         {
             return;
@@ -124,7 +156,7 @@ void Polygon::BottomCenteredRectangle(double width, double height)
     }
     else if(height == 0)
     {
-        if(!Assert(mImage != nullptr,
+        if(!Assert(LoadImage(),
                 L"You must select an image before calling BottomCenteredRectangle with no height."))
         {
             return;
@@ -145,7 +177,7 @@ void Polygon::CenteredSquare(double size)
 {
     if(size == 0)
     {
-        if(!Assert(mImage != nullptr,
+        if(!Assert(LoadImage(),
                 L"You must select an image before calling BottomCenteredRectangle."))
         {
             return;
@@ -199,21 +231,65 @@ void Polygon::SetColor(wxColour color)
  */
 void Polygon::SetImage(std::wstring filename)
 {
-    // Prevent error popup from wxWidgets
-    wxLogNull logNo;
+    // The image is decoded when it is first needed
+    mImage = nullptr;
+    mImageFilename.clear();
+    mMaskDirty = true;
 
-    mImage = std::make_unique<wxImage>();
-    if(mImage->LoadFile(filename, wxBITMAP_TYPE_ANY))
+    if(wxFileExists(filename))
     {
+        mImageFilename = filename;
         mMode = Mode::Image;
     }
     else
     {
-        std::wstringstream str;
-        str << L"Unable to load '" << filename << "'" << std::endl;
-        wxMessageBox(str.str(), L"Polygon Image File Load Failure!");
+        ReportLoadFailure(filename);
+    }
+}
+
+/**
+ * Decode the image set by SetImage if it has not been decoded yet.
+ *
+ * A machine with many polygons only pays for the images
+ * it actually draws or measures.
+ * @return true if an image is available
+ */
+bool Polygon::LoadImage()
+{
+    if(mImage != nullptr)
+    {
+        return true;
+    }
+
+    if(mImageFilename.empty())
+    {
+        return false;
+    }
+
+    // Small images come from the shared atlas without decoding
+    auto image = ImageAtlas::Shared().GetImage(mImageFilename);
+    if(image.IsOk())
+    {
+        mImage = std::make_unique<wxImage>(image);
+        RecordMemory();
+        return true;
+    }
+
+    // Prevent error popup from wxWidgets
+    wxLogNull logNo;
+
+    mImage = std::make_unique<wxImage>();
+    if(!mImage->LoadFile(mImageFilename, wxBITMAP_TYPE_ANY))
+    {
+        ReportLoadFailure(mImageFilename);
         mImage = nullptr;
+        mImageFilename.clear();
+        mMode = Mode::Unset;
+        return false;
     }
+
+    RecordMemory();
+    return true;
 }
 
 
@@ -226,6 +302,20 @@ void Polygon::SetImage(std::wstring filename)
  * @param rotation Rotation in turns (0-1)
  */
 void Polygon::DrawPolygon(std::shared_ptr<wxGraphicsContext> graphics, double x, double y, double rotation)
+{
+    RenderList list;
+    RecordPolygon(list, x, y, rotation);
+    list.Replay(graphics);
+}
+
+/**
+ * Record drawing the polygon into a render list
+ * @param list Render list to record into
+ * @param x X location to draw in pixels
+ * @param y Y location to draw in pixels
+ * @param rotation Rotation in turns (0-1)
+ */
+void Polygon::RecordPolygon(RenderList &list, double x, double y, double rotation)
 {
     if(mPoints.size() < 3)
     {
@@ -238,21 +328,13 @@ void Polygon::DrawPolygon(std::shared_ptr<wxGraphicsContext> graphics, double x,
 
     mHasDrawn = true;
 
-#ifndef WIN32
-    if(mOpacity < 1)
-    {
-        // Layer opacity does not work on Windows systems.
-        graphics->BeginLayer(mOpacity);
-    }
-#endif
-
     switch (mMode) {
     case Mode::Color:
-        DrawColorPolygon(graphics, x, y, rotation);
+        RecordColorPolygon(list, x, y, rotation);
         break;
 
     case Mode::Image:
-        DrawImagePolygon(graphics, x, y, rotation);
+        RecordImagePolygon(list, x, y, rotation);
         break;
 
     default:
@@ -263,152 +345,480 @@ void Polygon::DrawPolygon(std::shared_ptr<wxGraphicsContext> graphics, double x,
                 L"https://facweb.cse.msu.edu/cbowen/cse335/polygon/c/");
         break;
     }
-
-#ifndef WIN32
-    if(mOpacity < 1)
-    {
-        graphics->EndLayer();
-    }
-#endif
 }
 
 
 
 /**
- * Draw the polygon as a solid color-filled polygon
- * @param graphics Graphics object to draw on
+ * Record the polygon as a solid color-filled polygon
+ * @param list Render list to record into
  * @param x X location to draw in pixels
  * @param y Y location to draw in pixels
  * @param rotation Rotation in turns
  */
-void Polygon::DrawColorPolygon(std::shared_ptr<wxGraphicsContext> graphics, double x, double y, double rotation)
+void Polygon::RecordColorPolygon(RenderList &list, double x, double y, double rotation)
 {
-    if(mPath.IsNull())
+    if(mPath == nullptr)
     {
-        // Create the graphics path
-        mPath = graphics->CreatePath();
+        // Create the path
+        mPath = std::make_shared<RenderList::Path>();
 
-        mPath.MoveToPoint(mPoints[0].m_x, mPoints[0].m_y);
+        mPath->MoveToPoint(mPoints[0].m_x, mPoints[0].m_y);
         for(size_t i=1; i<mPoints.size(); i++)
         {
-            mPath.AddLineToPoint(mPoints[i].m_x, mPoints[i].m_y);
+            mPath->AddLineToPoint(mPoints[i].m_x, mPoints[i].m_y);
         }
-        mPath.CloseSubpath();
+        mPath->CloseSubpath();
     }
 
-    graphics->PushState();
+    list.PushState();
 
-    graphics->Translate(x, y);
-    graphics->Rotate(rotation * M_PI * 2);
+    list.Translate(x, y);
+    list.Rotate(rotation * M_PI * 2);
 
-    graphics->SetBrush(mBrush);
-    graphics->FillPath(mPath);
+    if(mOpacity < 1)
+    {
+        // The opacity goes into the brush color
+        auto color = mBrush.GetColour();
+        wxBrush brush(mBrush);
+        brush.SetColour(wxColour(color.Red(), color.Green(), color.Blue(), int(color.Alpha() * mOpacity)));
+        list.SetBrush(brush);
+    }
+    else
+    {
+        list.SetBrush(mBrush);
+    }
 
-    graphics->PopState();
+    list.FillPath(mPath);
+
+    list.PopState();
 }
 
 /**
- * Draw the polygon as a texture mapped image.
- *
- * This is accomplished by drawing the bitmap image clipped
- * by the supplied polygon points.
+ * Record the polygon as an image.
  *
- * @param graphics Graphics object to draw on
+ * The sprite is baked when it is recorded. The bitmap is chosen
+ * when the list is replayed, since the mipmap level depends on
+ * the transform of the context it is replayed into.
+ * @param list Render list to record into
  * @param x X location to draw in pixels
  * @param y Y location to draw in pixels
- * @param rotation Rotation in turn
+ * @param rotation Rotation in turns
  */
-void Polygon::DrawImagePolygon(std::shared_ptr<wxGraphicsContext> graphics, double x, double y, double rotation)
+void Polygon::RecordImagePolygon(RenderList &list, double x, double y, double rotation)
 {
-    if(mBitmapDirty || mGraphicsBitmap.IsNull())
+    if(mMaskDirty || mSpriteLevelCount == 0)
     {
-#ifdef WIN32
-        // Implementation of opacity for Windows systems.
-        // Windows does not support transparency layers.
-        if(mOpacity < 1) {
-            // Ensure the image has an alpha map
-            if (!mImage->HasAlpha()) {
-                mImage->InitAlpha();
-            }
+        if(!LoadImage())
+        {
+            return;
+        }
 
-            wxImage img = mImage->Copy();
+        BakeSprite();
+        BuildSpriteLevels();
+        ClearOpacitySprites();
+        mMaskDirty = false;
+    }
 
-            unsigned char *alpha = img.GetAlpha();
-            for(int i=0; i<img.GetWidth()*img.GetHeight(); i++)
-            {
-                alpha[i] = int(alpha[i] * mOpacity);
-            }
+    list.PushState();
+
+    list.Translate(x, y);
+    list.Rotate(rotation * M_PI * 2);
+
+    list.Translate(mImageClipRegionTopLeft.m_x, mImageClipRegionTopLeft.m_y);
+
+    int opacityLevel = AlphaKernel::OpacityLevel(mOpacity);
+    auto source = [this, opacityLevel](std::shared_ptr<wxGraphicsContext> graphics) {
+        return SpriteBitmap(graphics, opacityLevel);
+    };
+    auto image = [this, opacityLevel](double scale) {
+        return SpriteImage(scale, opacityLevel);
+    };
+
+    if(mInvertedY)
+    {
+        // Flip the bitmap upside down
+        list.Scale(1, -1);
+        list.DrawBitmap(mImageFilename, source, image, 0, -mImageClipRegionSize.m_y, mImageClipRegionSize.m_x, mImageClipRegionSize.m_y);
+    }
+    else
+    {
+        list.DrawBitmap(mImageFilename, source, image, 0, 0, mImageClipRegionSize.m_x, mImageClipRegionSize.m_y);
+    }
+
+    list.PopState();
+}
+
+/**
+ * Get the bitmap to draw the sprite with in a graphics context.
+ *
+ * This is called when a render list is replayed, with the
+ * transform the sprite will be drawn with already applied.
+ * @param graphics Graphics context the sprite will be drawn on
+ * @param opacityLevel Opacity level from AlphaKernel::OpacityLevel
+ * @return Graphics bitmap
+ */
+wxGraphicsBitmap Polygon::SpriteBitmap(std::shared_ptr<wxGraphicsContext> graphics, int opacityLevel)
+{
+    double a, b, c, d, tx, ty;
+    graphics->GetTransform().Get(&a, &b, &c, &d, &tx, &ty);
+
+    auto bitmap = OpacityBitmap(graphics, SpriteLevel(std::sqrt(std::abs(a * d - b * c))), opacityLevel);
+
+    if(ImageMemory::Shared().IsReleasePixels())
+    {
+        ReleasePixels();
+    }
+
+    return bitmap;
+}
+
+/**
+ * Get the pixels to draw the sprite with in a Renderer.
+ *
+ * This is called when a render list is replayed into a Renderer
+ * such as the software renderer. Pixels are kept for the
+ * opacities and mipmap levels used most recently, as bitmaps are,
+ * even when the decoded image is released.
+ * @param scale Device pixels each unit of the transform the sprite
+ * will be drawn with covers
+ * @param opacityLevel Opacity level from AlphaKernel::OpacityLevel
+ * @return Pixels or nullptr if the image can not be loaded
+ */
+std::shared_ptr<const RenderImage> Polygon::SpriteImage(double scale, int opacityLevel)
+{
+    int spriteLevel = SpriteLevel(scale);
+    auto &entry = UseOpacityEntry(spriteLevel * AlphaKernel::OpacityLevels + opacityLevel);
+    if(entry.mImage == nullptr)
+    {
+        auto sprite = OpacitySprite(spriteLevel, opacityLevel);
+        if(!sprite.IsOk())
+        {
+            return nullptr;
+        }
+
+        entry.mImage = RenderList::MakeImage(sprite);
+        RecordMemory();
+    }
+
+    auto image = entry.mImage;
+
+    if(ImageMemory::Shared().IsReleasePixels())
+    {
+        ReleasePixels();
+    }
+
+    return image;
+}
+
+/**
+ * Choose the mipmap level of the sprite to draw.
+ *
+ * The level is chosen by how many device pixels each sprite pixel
+ * covers, so a machine drawn scaled down draws a smaller level
+ * that is already filtered.
+ * @param scale Device pixels each unit of the transform the sprite
+ * will be drawn with covers
+ * @return Index into mSpriteLevels
+ */
+int Polygon::SpriteLevel(double scale)
+{
+    if(mSpriteLevelCount <= 1)
+    {
+        return 0;
+    }
 
-            mGraphicsBitmap = graphics->CreateBitmapFromImage(img);
+    double area = scale * scale * std::abs(mImageClipRegionSize.m_x * mImageClipRegionSize.m_y);
+    return MipmapKernel::SelectLevel(std::sqrt(area / (double(mSpriteSize.GetWidth()) * mSpriteSize.GetHeight())),
+            mSpriteLevelCount);
+}
+
+/**
+ * Get the bitmap of the sprite at an opacity.
+ *
+ * Bitmaps are kept for the opacities and mipmap levels used most
+ * recently, so a polygon switching between a few of them does not
+ * bake them again.
+ * @param graphics Graphics context the bitmap is for
+ * @param spriteLevel Mipmap level from SpriteLevel
+ * @param opacityLevel Opacity level from AlphaKernel::OpacityLevel
+ * @return Graphics bitmap
+ */
+wxGraphicsBitmap Polygon::OpacityBitmap(std::shared_ptr<wxGraphicsContext> graphics, int spriteLevel, int opacityLevel)
+{
+    auto &entry = UseOpacityEntry(spriteLevel * AlphaKernel::OpacityLevels + opacityLevel);
+    if(entry.mBitmap.IsNull())
+    {
+        auto sprite = OpacitySprite(spriteLevel, opacityLevel);
+        if(!sprite.IsOk())
+        {
+            return wxGraphicsBitmap();
         }
-        else
+
+        entry.mBitmap = graphics->CreateBitmapFromImage(sprite);
+    }
+
+    return entry.mBitmap;
+}
+
+/**
+ * Get the cache entry for an opacity and mipmap level, making it most recently used.
+ *
+ * A new entry is empty. If the cache is full, the entry used least
+ * recently is dropped to make room, so a polygon fading through many
+ * opacities does not push out the levels other draws keep using.
+ * @param key Mipmap level times AlphaKernel::OpacityLevels plus the opacity level
+ * @return The entry
+ */
+Polygon::OpacityEntry &Polygon::UseOpacityEntry(int key)
+{
+    auto found = mOpacitySprites.find(key);
+    if(found != mOpacitySprites.end())
+    {
+        mOpacityOrder.splice(mOpacityOrder.begin(), mOpacityOrder, found->second.mOrder);
+        return found->second;
+    }
+
+    if(mOpacitySprites.size() >= MaxOpacitySprites)
+    {
+        mOpacitySprites.erase(mOpacityOrder.back());
+        mOpacityOrder.pop_back();
+    }
+
+    mOpacityOrder.push_front(key);
+    auto &entry = mOpacitySprites[key];
+    entry.mOrder = mOpacityOrder.begin();
+    return entry;
+}
+
+/**
+ * Drop every sprite kept for an opacity and mipmap level
+ */
+void Polygon::ClearOpacitySprites()
+{
+    mOpacitySprites.clear();
+    mOpacityOrder.clear();
+}
+
+/**
+ * Get a mipmap level of the sprite at an opacity.
+ *
+ * The opacity is baked into a copy of the sprite alpha, so a
+ * translucent polygon draws like an opaque one and needs no
+ * transparency layer. If the pixels were released they are
+ * baked again.
+ * @param spriteLevel Mipmap level from SpriteLevel
+ * @param opacityLevel Opacity level from AlphaKernel::OpacityLevel
+ * @return The sprite, or an invalid image if the image can not be loaded
+ */
+wxImage Polygon::OpacitySprite(int spriteLevel, int opacityLevel)
+{
+    if(mSpriteLevels.empty())
+    {
+        // The pixels were released, so bake them again
+        if(!LoadImage())
         {
-            mGraphicsBitmap = graphics->CreateBitmapFromImage(*mImage);
+            return wxImage();
+        }
+
+        BakeSprite();
+        BuildSpriteLevels();
+    }
+
+    auto &sprite = mSpriteLevels[spriteLevel];
+    if(opacityLevel == AlphaKernel::OpacityLevels - 1)
+    {
+        return sprite;
+    }
+
+    wxImage img = sprite.Copy();
+    AlphaKernel::ScaleAlpha(img.GetAlpha(), size_t(img.GetWidth()) * img.GetHeight(), opacityLevel);
+    return img;
+}
+
+/**
+ * Bake the polygon outline into the alpha channel of a copy of the image.
+ *
+ * The image is stretched over the bounding box of the polygon
+ * when drawn. Pixels whose centers fall outside the polygon
+ * are made transparent, so the bitmap can be drawn without
+ * clipping. This is only redone when the image or points change.
+ */
+void Polygon::BakeSprite()
+{
+    //
+    // Determine the top left and the size of the
+    // region covered by our polygon
+    //
+    mImageClipRegionTopLeft = mPoints[0];
+    auto imageClipRegionBottomRight = mPoints[0];
+
+    for(auto point : mPoints)
+    {
+        if(point.m_x < mImageClipRegionTopLeft.m_x) {
+            mImageClipRegionTopLeft.m_x = point.m_x;
+        }
+
+        if(point.m_y < mImageClipRegionTopLeft.m_y) {
+            mImageClipRegionTopLeft.m_y = point.m_y;
+        }
+
+        if(point.m_x > imageClipRegionBottomRight.m_x) {
+            imageClipRegionBottomRight.m_x = point.m_x;
         }
-#else
-        mGraphicsBitmap = graphics->CreateBitmapFromImage(*mImage);
-#endif
-
-        //
-        // Determine the top left and the size of the
-        // region covered by our polygon
-        //
-        mImageClipRegionTopLeft = mPoints[0];
-        auto imageClipRegionBottomRight = mPoints[0];
-
-        for(auto point : mPoints)
+
+        if(point.m_y > imageClipRegionBottomRight.m_y) {
+            imageClipRegionBottomRight.m_y = point.m_y;
+        }
+    }
+
+    mImageClipRegionSize = imageClipRegionBottomRight - mImageClipRegionTopLeft;
+
+    mSprite = mImage->Copy();
+    if(!mSprite.HasAlpha())
+    {
+        mSprite.InitAlpha();
+    }
+
+    int wid = mSprite.GetWidth();
+    int hit = mSprite.GetHeight();
+    if(mImageClipRegionSize.m_x <= 0 || mImageClipRegionSize.m_y <= 0)
+    {
+        return;
+    }
+
+    // The polygon in image pixel coordinates. With an inverted
+    // Y axis the bitmap is drawn upside down.
+    std::vector<wxPoint2DDouble> points;
+    for(auto point : mPoints)
+    {
+        auto u = (point.m_x - mImageClipRegionTopLeft.m_x) * wid / mImageClipRegionSize.m_x;
+        auto v = (point.m_y - mImageClipRegionTopLeft.m_y) * hit / mImageClipRegionSize.m_y;
+        points.push_back(wxPoint2DDouble(u, mInvertedY ? hit - v : v));
+    }
+
+    // Scanline fill: for each row find where the pixel centers
+    // cross the polygon edges and clear the alpha outside the spans
+    unsigned char *alpha = mSprite.GetAlpha();
+    std::vector<double> crossings;
+    for(int row = 0; row < hit; row++)
+    {
+        double center = row + 0.5;
+
+        crossings.clear();
+        for(size_t i = 0; i < points.size(); i++)
         {
-            if(point.m_x < mImageClipRegionTopLeft.m_x) {
-                mImageClipRegionTopLeft.m_x = point.m_x;
+            auto &a = points[i];
+            auto &b = points[(i + 1) % points.size()];
+            if((a.m_y <= center) != (b.m_y <= center))
+            {
+                crossings.push_back(a.m_x + (center - a.m_y) * (b.m_x - a.m_x) / (b.m_y - a.m_y));
             }
+        }
 
-            if(point.m_y < mImageClipRegionTopLeft.m_y) {
-                mImageClipRegionTopLeft.m_y = point.m_y;
-            }
+        std::sort(crossings.begin(), crossings.end());
 
-            if(point.m_x > imageClipRegionBottomRight.m_x) {
-                imageClipRegionBottomRight.m_x = point.m_x;
+        unsigned char *line = alpha + size_t(row) * wid;
+        int col = 0;
+        for(size_t i = 0; i + 1 < crossings.size(); i += 2)
+        {
+            int spanStart = std::clamp(int(std::ceil(crossings[i] - 0.5)), 0, wid);
+            int spanEnd = std::clamp(int(std::ceil(crossings[i + 1] - 0.5)), 0, wid);
+            for( ; col < spanStart; col++)
+            {
+                line[col] = 0;
             }
 
-            if(point.m_y > imageClipRegionBottomRight.m_y) {
-                imageClipRegionBottomRight.m_y = point.m_y;
-            }
+            col = std::max(col, spanEnd);
         }
 
-        mImageClipRegionSize = imageClipRegionBottomRight - mImageClipRegionTopLeft;
+        for( ; col < wid; col++)
+        {
+            line[col] = 0;
+        }
+    }
+}
 
-        mImageClipRegion.Clear();
-        std::vector<wxPoint> points;
-        for(auto point : mPoints)
+/**
+ * Build the mipmap levels of the sprite.
+ *
+ * Each level is filtered down from the one before with a box
+ * filter, so drawing a small level looks like drawing the full
+ * sprite filtered down to that size, without the cost of
+ * filtering on every draw.
+ */
+void Polygon::BuildSpriteLevels()
+{
+    mSpriteLevels.clear();
+    mSpriteLevels.push_back(mSprite);
+
+    while(int(mSpriteLevels.size()) < MaxSpriteLevels)
+    {
+        auto &last = mSpriteLevels.back();
+        int wid = last.GetWidth();
+        int hit = last.GetHeight();
+        if(wid <= 1 && hit <= 1)
         {
-            points.push_back(wxPoint(int(point.m_x - mImageClipRegionTopLeft.m_x + 0.5),
-                    int(point.m_y - mImageClipRegionTopLeft.m_y + 0.5)));
+            break;
         }
 
-        mImageClipRegion = wxRegion(points.size(), &points[0]);
-        mBitmapDirty = false;
+        wxImage level(MipmapKernel::HalfSize(wid), MipmapKernel::HalfSize(hit), false);
+        level.InitAlpha();
+        MipmapKernel::Downsample(last.GetData(), wid, hit, 3, level.GetData());
+        MipmapKernel::Downsample(last.GetAlpha(), wid, hit, 1, level.GetAlpha());
+        mSpriteLevels.push_back(level);
     }
 
-    graphics->PushState();
+    mSpriteSize = mSprite.GetSize();
+    mSpriteLevelCount = int(mSpriteLevels.size());
+    RecordMemory();
+}
 
-    graphics->Translate(x, y);
-    graphics->Rotate(rotation * M_PI * 2);
+/**
+ * Release the decoded image and sprite pixels.
+ *
+ * The bitmaps and software renderer pixels already made are kept,
+ * since they are what is drawn. A new opacity or mipmap level,
+ * or a call that needs the image, decodes it again.
+ */
+void Polygon::ReleasePixels()
+{
+    if(mImage == nullptr && mSpriteLevels.empty())
+    {
+        return;
+    }
 
-    graphics->Translate(mImageClipRegionTopLeft.m_x, mImageClipRegionTopLeft.m_y);
-    graphics->Clip(mImageClipRegion);
+    mImage = nullptr;
+    mSprite = wxImage();
+    mSpriteLevels.clear();
+    RecordMemory();
+}
 
-    if(mInvertedY)
+/**
+ * Record the pixels this polygon holds in the shared ImageMemory
+ */
+void Polygon::RecordMemory()
+{
+    size_t bytes = 0;
+    if(mImage != nullptr)
     {
-        // Flip the bitmap upside down
-        graphics->Scale(1, -1);
-        graphics->DrawBitmap(mGraphicsBitmap, 0, -mImageClipRegionSize.m_y, mImageClipRegionSize.m_x, mImageClipRegionSize.m_y);
+        bytes += ImageMemory::ImageBytes(mImage->GetWidth(), mImage->GetHeight(), mImage->HasAlpha());
     }
-    else
+
+    for(auto &level : mSpriteLevels)
     {
-        graphics->DrawBitmap(mGraphicsBitmap, 0, 0, mImageClipRegionSize.m_x, mImageClipRegionSize.m_y);
+        bytes += ImageMemory::ImageBytes(level.GetWidth(), level.GetHeight(), true);
     }
 
-    graphics->PopState();
+    for(auto &sprite : mOpacitySprites)
+    {
+        if(sprite.second.mImage != nullptr)
+        {
+            bytes += sprite.second.mImage->GetBytes();
+        }
+    }
+
+    ImageMemory::Shared().Record(this, mImageFilename, bytes);
 }
 
 /**
@@ -435,7 +845,7 @@ void Polygon::DrawCrosshair(std::shared_ptr<wxGraphicsContext> graphics, double
 */
 int Polygon::GetImageWidth()
 {
-    if(!Assert(mImage != nullptr, L"You must specify an image before you can call GetImageWidth()"))
+    if(!Assert(LoadImage(), L"You must specify an image before you can call GetImageWidth()"))
     {
         return 0;
     }
@@ -451,7 +861,7 @@ int Polygon::GetImageWidth()
 */
 int Polygon::GetImageHeight()
 {
-    if(!Assert(mImage != nullptr, L"You must specify an image before you can call GetImageHeight()"))
+    if(!Assert(LoadImage(), L"You must specify an image before you can call GetImageHeight()"))
     {
         return 0;
     }
@@ -488,8 +898,6 @@ bool Polygon::Assert(bool condition, wxString msg, const wxString &url)
 /**
  * Set the opacity of the polygon rendering.
  *
- * Currently only works for images.
- *
  * @param opacity Opacity from 0 to 1
  */
 void Polygon::SetOpacity(double opacity)
@@ -504,9 +912,6 @@ void Polygon::SetOpacity(double opacity)
 
         // We have an opacity change
         mOpacity = opacity;
-#ifdef WIN32
-        mBitmapDirty = true;
-#endif
     }
 }
 
@@ -522,6 +927,10 @@ void Polygon::SetOpacity(double opacity)
 double Polygon::AverageLuminance(int x, int y, int wid, int hit)
 {
     assert(mMode == Mode::Image);
+    if(!LoadImage())
+    {
+        return 0;
+    }
 
     double sum = 0;
     int cnt = 0;
@@ -628,6 +1037,9 @@ wxRect2DDouble Polygon::BoundingBox()
  * Fire a message display after a delay. This is done since it is not
  * possible to bring up a dialog box in a Draw function, which is
  * where most errors occur.
+ *
+ * Machines may be built and drawn on worker threads, where the timer
+ * can not be started, so it is then started on the UI thread.
  * @param msg Message to display
  * @param url Optional URL for help
  */
@@ -639,8 +1051,22 @@ void Polygon::DelayedMessage::Fire(const wxString& msg, const wxString& url) {
 
     mMessage = msg;
     mURL = url;
-    StartOnce(10);
     mFired = true;
+
+    if(wxThread::IsMain())
+    {
+        StartOnce(10);
+    }
+    else if(wxTheApp != nullptr)
+    {
+        std::weak_ptr<DelayedMessage> message = shared_from_this();
+        wxTheApp->CallAfter([message] {
+            if(auto delayed = message.lock())
+            {
+                delayed->StartOnce(10);
+            }
+        });
+    }
 }
 
 
@@ -2,7 +2,7 @@
  * @file Polygon.h
  *
  * @author Charles Owen
- * @version 1.05
+ * @version 1.13
  *
  * Generic polygon class that is used to make shapes we
  * will use in our project.
@@ -14,14 +14,26 @@
  * 1.03 Put into cse335 namespace, opacity support
  * 1.04 Added Circle function
  * 1.05 Special version that works with inverted Y axis
+ * 1.06 Images are decoded when first needed
+ * 1.07 Polygon outline baked into the image alpha instead of clipping
+ * 1.08 Opacity baked into the bitmap on all systems, no layers
+ * 1.09 Images are taken from the shared ImageAtlas when it has them
+ * 1.10 Mipmap levels of the sprite chosen by the drawn scale
+ * 1.11 Pixels can be released after drawing, memory recorded in ImageMemory
+ * 1.12 Draws by recording into a RenderList
+ * 1.13 Sprites can be drawn by the software renderer
  */
 
 #pragma once
 
 #include <vector>
+#include <list>
+#include <map>
 #include <memory>
 #include <string>
 
+#include "RenderList.h"
+
 namespace cse335 {
 
 /**
@@ -33,11 +45,17 @@ namespace cse335 {
         /// Default number of steps when drawing a circle
         static const int DefaultCircleSteps = 32;
 
-        void DrawColorPolygon(std::shared_ptr<wxGraphicsContext> graphics, double x, double y, double r);
-        void DrawImagePolygon(std::shared_ptr<wxGraphicsContext> graphics, double x, double y, double r);
+        /// Number of opacity and level combinations sprites are kept for
+        static const size_t MaxOpacitySprites = 8;
+
+        /// Most mipmap levels kept for the sprite, including the full size
+        static const int MaxSpriteLevels = 6;
 
-        /// Graphics path to use to draw
-        wxGraphicsPath mPath;
+        void RecordColorPolygon(RenderList &list, double x, double y, double r);
+        void RecordImagePolygon(RenderList &list, double x, double y, double r);
+
+        /// Path to use to draw
+        std::shared_ptr<RenderList::Path> mPath;
 
         /// The points that make up the polygon
         std::vector<wxPoint2DDouble> mPoints;
@@ -59,11 +77,39 @@ namespace cse335 {
         /// The basic texture image we load
         std::unique_ptr<wxImage> mImage;
 
-        /// The graphics bitmap we actually draw
-        wxGraphicsBitmap mGraphicsBitmap;
+        /// File the image is decoded from when first needed
+        std::wstring mImageFilename;
+
+        /// The sprite baked at one opacity and mipmap level
+        struct OpacityEntry
+        {
+            /// Bitmap for drawing in a graphics context, if one was made
+            wxGraphicsBitmap mBitmap;
+
+            /// Pixels for the software renderer, if they were made
+            std::shared_ptr<const RenderImage> mImage;
+
+            /// Position of this entry in mOpacityOrder
+            std::list<int>::iterator mOrder;
+        };
+
+        /// Sprites for the opacity and mipmap levels used recently, by key
+        std::map<int, OpacityEntry> mOpacitySprites;
+
+        /// Keys of mOpacitySprites, most recently used first
+        std::list<int> mOpacityOrder;
+
+        /// The image with the polygon outline baked into its alpha channel
+        wxImage mSprite;
+
+        /// Mipmap levels of the sprite, each half the size of the one before
+        std::vector<wxImage> mSpriteLevels;
 
-        /// The image clip region
-        wxRegion mImageClipRegion;
+        /// Size of the sprite in pixels, kept when the pixels are released
+        wxSize mSpriteSize;
+
+        /// Number of mipmap levels, kept when the pixels are released
+        int mSpriteLevelCount = 0;
 
         /// What is the top left point for the clip region?
         wxPoint2DDouble mImageClipRegionTopLeft;
@@ -77,8 +123,8 @@ namespace cse335 {
         /// Opacity of the polygon - value range to 0 to 1
         double mOpacity = 1.0;
 
-        /// Forces the bitmap to be reloaded
-        bool mBitmapDirty = true;
+        /// Forces the polygon outline to be baked into the sprite again
+        bool mMaskDirty = true;
 
 #ifdef POLYGON_DEFAULT_INVERTEDY
         /// Is the Y axis inverted (positive Y is up)?
@@ -88,13 +134,26 @@ namespace cse335 {
         bool mInvertedY = false;
 #endif
 
+        bool LoadImage();
+        void BakeSprite();
+        void BuildSpriteLevels();
+        void ReleasePixels();
+        void RecordMemory();
+        int SpriteLevel(double scale);
+        wxGraphicsBitmap SpriteBitmap(std::shared_ptr<wxGraphicsContext> graphics, int opacityLevel);
+        std::shared_ptr<const RenderImage> SpriteImage(double scale, int opacityLevel);
+        wxGraphicsBitmap OpacityBitmap(std::shared_ptr<wxGraphicsContext> graphics, int spriteLevel, int opacityLevel);
+        wxImage OpacitySprite(int spriteLevel, int opacityLevel);
+        OpacityEntry &UseOpacityEntry(int key);
+        void ClearOpacitySprites();
+
         bool Assert(bool condition, wxString msg, const wxString& url = wxEmptyString);
 
         //<editor-fold desc="Code to support the deferred assertion message box" defaultstate="collapsed">
         /**
          * Class to display an error message dialog box after a delay
          */
-        class DelayedMessage : public wxTimer {
+        class DelayedMessage : public wxTimer, public std::enable_shared_from_this<DelayedMessage> {
         private:
             void Notify() override;
 
@@ -140,6 +199,8 @@ namespace cse335 {
 
         void DrawPolygon(std::shared_ptr<wxGraphicsContext> graphics, double x, double y, double rotation);
 
+        void RecordPolygon(RenderList &list, double x, double y, double rotation);
+
         virtual void SetOpacity(double opacity);
 
         int GetImageWidth();
@@ -40,10 +40,10 @@ void Pulley::Update(double elapsed)
 }
 
 /**
- * Draw our polygons for the pulley
- * @param graphics The graphics context to draw on
+ * Record drawing our polygons for the pulley
+ * @param list Render list to record into
  */
-void Pulley::Draw(std::shared_ptr<wxGraphicsContext> graphics)
+void Pulley::Record(RenderList &list)
 {
     // Draw connection lines to other pulleys connected to this pulley
     for(auto pulley : mConnections)
@@ -59,14 +59,14 @@ void Pulley::Draw(std::shared_ptr<wxGraphicsContext> graphics)
 
         if(mRotation !=0)
         {
-            // Create a wxGraphicsPath
-            wxGraphicsPath path = graphics->CreatePath();
+            // Create a path
+            auto path = std::make_shared<RenderList::Path>();
 
             // Move to the first starting point
-            path.MoveToPoint(mPulleyPos.x - alphaY1, mPulleyPos.y + alphaX1);
+            path->MoveToPoint(mPulleyPos.x - alphaY1, mPulleyPos.y + alphaX1);
 
             // Add first curve
-            path.AddCurveToPoint(
+            path->AddCurveToPoint(
                 (mPulleyPos.x - alphaY1 + pulley->GetPosition().x - alphaY2) / mRocking,
                 (mPulleyPos.y + alphaX1 + pulley->GetPosition().y + alphaX2) / mRocking,
                 (pulley->GetPosition().x - alphaY2 + mPulleyPos.x + alphaY1) / mRocking,
@@ -75,10 +75,10 @@ void Pulley::Draw(std::shared_ptr<wxGraphicsContext> graphics)
             );
 
             // Move to the second starting point
-            path.MoveToPoint(mPulleyPos.x + alphaY1, mPulleyPos.y - alphaX1);
+            path->MoveToPoint(mPulleyPos.x + alphaY1, mPulleyPos.y - alphaX1);
 
             // Add second curve
-            path.AddCurveToPoint(
+            path->AddCurveToPoint(
                 (mPulleyPos.x + alphaY1 + pulley->GetPosition().x + alphaY2) / mRocking,
                 (mPulleyPos.y - alphaX1 + pulley->GetPosition().y - alphaX2) / mRocking,
                 (pulley->GetPosition().x + alphaY2 + mPulleyPos.x + alphaY1) / mRocking,
@@ -87,8 +87,8 @@ void Pulley::Draw(std::shared_ptr<wxGraphicsContext> graphics)
             );
 
             // Set the pen and draw the path
-            graphics->SetPen(wxPen(wxColor(0, 0, 0), 2));
-            graphics->DrawPath(path);
+            list.SetPen(wxPen(wxColor(0, 0, 0), 2));
+            list.DrawPath(path);
 
 
             if(mRocking <BeltRockMax && mIncrement)
@@ -112,16 +112,16 @@ void Pulley::Draw(std::shared_ptr<wxGraphicsContext> graphics)
         }
         else
         {
-            graphics->SetPen(wxPen(wxColor(0, 0, 0), 2));
-            graphics->StrokeLine(mPulleyPos.x - alphaY1, mPulleyPos.y + alphaX1, pulley->GetPosition().x - alphaY2, pulley->GetPosition().y + alphaX2);
-            graphics->StrokeLine(mPulleyPos.x + alphaY1, mPulleyPos.y - alphaX1, pulley->GetPosition().x + alphaY2, pulley->GetPosition().y - alphaX2);
+            list.SetPen(wxPen(wxColor(0, 0, 0), 2));
+            list.StrokeLine(mPulleyPos.x - alphaY1, mPulleyPos.y + alphaX1, pulley->GetPosition().x - alphaY2, pulley->GetPosition().y + alphaX2);
+            list.StrokeLine(mPulleyPos.x + alphaY1, mPulleyPos.y - alphaX1, pulley->GetPosition().x + alphaY2, pulley->GetPosition().y - alphaX2);
         }
 
     }
 
     // Draw the pulley
 
-    mPolygon.DrawPolygon(graphics,mPulleyPos.x,mPulleyPos.y,mRotation);
+    mPolygon.RecordPolygon(list,mPulleyPos.x,mPulleyPos.y,mRotation);
 
 }
 
@@ -153,9 +153,6 @@ void Pulley::Rotate(double rotation, double speed)
 
 
     }
-
-    mSource.SetRotation(rotation, speed);
-    mSource.UpdateSinks();
 }
 
 /**
@@ -196,3 +193,23 @@ void Pulley::SetDriver(Pulley *pulley)
 {
     mDriver = pulley;
 }
+
+/**
+ * Save the simulation state of the pulley
+ * @param state State to save to
+ */
+void Pulley::SaveState(MachineState &state)
+{
+    state.SaveValue(mRotation);
+    state.SaveValue(mPreviousRotion);
+}
+
+/**
+ * Restore the simulation state of the pulley
+ * @param reader Reader for the state to restore from
+ */
+void Pulley::RestoreState(MachineState::Reader &reader)
+{
+    mRotation = reader.NextValue();
+    mPreviousRotion = reader.NextValue();
+}
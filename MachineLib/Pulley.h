@@ -61,7 +61,14 @@ public:
     void Drive(std::shared_ptr<Pulley> pulley);
 
     void Update(double elapsed) override;
-    void Draw(std::shared_ptr<wxGraphicsContext> graphics) override;
+
+    /**
+     * The pulley is driven through its rotation sink, so it needs no updates
+     * @return false
+     */
+    bool NeedsUpdate() override { return false; }
+
+    void Record(RenderList &list) override;
     void Rotate(double rotation, double speed) override;
     void SetPosition(double x, double y) override;
 
@@ -71,6 +78,8 @@ public:
      */
     void SetImage(std::wstring fileName) {mPolygon.SetImage(fileName);}
     void InstallPhysics(std::shared_ptr<b2World> world) override;
+    void SaveState(MachineState &state) override;
+    void RestoreState(MachineState::Reader &reader) override;
 
     /**
      * Get a pointer to the source object
@@ -78,6 +87,12 @@ public:
      */
     RotationSource *GetSource() { return &mSource; }
 
+    /**
+     * Get the source this pulley passes its rotation on to
+     * @return Pointer to RotationSource object
+     */
+    RotationSource *GetDrivenSource() override { return &mSource; }
+
     /**
      * Get the radius of the pulley
      * @return the radius of the bulley
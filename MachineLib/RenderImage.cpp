@@ -0,0 +1,80 @@
+/**
+ * @file RenderImage.cpp
+ * @author Thomas Toaz
+ */
+
+#include <algorithm>
+
+#include "RenderImage.h"
+#include "BlendKernel.h"
+
+/**
+ * Constructor, an image with every pixel transparent
+ * @param width Width in pixels
+ * @param height Height in pixels
+ */
+RenderImage::RenderImage(int width, int height) :
+    mWidth(width), mHeight(height), mPixels(size_t(width) * height * 4, 0)
+{
+}
+
+/**
+ * Set the pixels from separate colour and alpha planes
+ * @param rgb Red, green and blue of each pixel
+ * @param alpha Alpha of each pixel, or nullptr if the image is opaque
+ */
+void RenderImage::SetPlanes(const unsigned char *rgb, const unsigned char *alpha)
+{
+    size_t count = size_t(mWidth) * mHeight;
+    auto pixel = mPixels.data();
+    for(size_t i = 0; i < count; i++, pixel += 4)
+    {
+        unsigned a = alpha != nullptr ? alpha[i] : 255;
+        pixel[0] = BlendKernel::Multiply(rgb[i * 3], a);
+        pixel[1] = BlendKernel::Multiply(rgb[i * 3 + 1], a);
+        pixel[2] = BlendKernel::Multiply(rgb[i * 3 + 2], a);
+        pixel[3] = (unsigned char)a;
+    }
+}
+
+/**
+ * Get the pixels as separate colour and alpha planes
+ * @param rgb Receives the red, green and blue of each pixel
+ * @param alpha Receives the alpha of each pixel, or nullptr if not needed
+ */
+void RenderImage::GetPlanes(unsigned char *rgb, unsigned char *alpha) const
+{
+    size_t count = size_t(mWidth) * mHeight;
+    auto pixel = mPixels.data();
+    for(size_t i = 0; i < count; i++, pixel += 4)
+    {
+        unsigned a = pixel[3];
+        for(int c = 0; c < 3; c++)
+        {
+            rgb[i * 3 + c] = a == 0 ? 0 : (unsigned char)std::min(255u, (pixel[c] * 255u + a / 2) / a);
+        }
+
+        if(alpha != nullptr)
+        {
+            alpha[i] = (unsigned char)a;
+        }
+    }
+}
+
+/**
+ * Set every pixel to a colour
+ * @param colour Colour as RGBA, red in the low byte
+ */
+void RenderImage::Fill(unsigned int colour)
+{
+    unsigned a = colour >> 24;
+    unsigned char pixel[4] = {BlendKernel::Multiply(colour & 0xff, a), BlendKernel::Multiply((colour >> 8) & 0xff, a),
+                              BlendKernel::Multiply((colour >> 16) & 0xff, a), (unsigned char)a};
+    for(size_t i = 0; i < mPixels.size(); i += 4)
+    {
+        mPixels[i] = pixel[0];
+        mPixels[i + 1] = pixel[1];
+        mPixels[i + 2] = pixel[2];
+        mPixels[i + 3] = pixel[3];
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file RenderImage.h
+ * @author Thomas Toaz
+ *
+ * Pixels with premultiplied alpha that the software renderer
+ * draws into and draws from.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_RENDERIMAGE_H
+#define CANADIANEXPERIENCE_MACHINELIB_RENDERIMAGE_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Pixels with premultiplied alpha that the software renderer
+ * draws into and draws from.
+ *
+ * Each pixel is four bytes, red, green, blue and alpha, with the
+ * colour already multiplied by the alpha so blending needs no
+ * divide. Images are converted to and from the separate colour
+ * and alpha planes wxImage uses.
+ */
+class RenderImage
+{
+private:
+    /// Width in pixels
+    int mWidth = 0;
+
+    /// Height in pixels
+    int mHeight = 0;
+
+    /// The pixels, a row at a time
+    std::vector<unsigned char> mPixels;
+
+public:
+    /// Constructor, an empty image
+    RenderImage() {}
+
+    RenderImage(int width, int height);
+
+    void SetPlanes(const unsigned char *rgb, const unsigned char *alpha);
+    void GetPlanes(unsigned char *rgb, unsigned char *alpha) const;
+    void Fill(unsigned int colour);
+
+    /**
+     * Get the width
+     * @return Width in pixels
+     */
+    int GetWidth() const { return mWidth; }
+
+    /**
+     * Get the height
+     * @return Height in pixels
+     */
+    int GetHeight() const { return mHeight; }
+
+    /**
+     * Get a row of pixels
+     * @param y Row number
+     * @return The first byte of the row
+     */
+    unsigned char *GetRow(int y) { return mPixels.data() + size_t(y) * mWidth * 4; }
+
+    /**
+     * Get a row of pixels
+     * @param y Row number
+     * @return The first byte of the row
+     */
+    const unsigned char *GetRow(int y) const { return mPixels.data() + size_t(y) * mWidth * 4; }
+
+    /**
+     * Get the memory the pixels take
+     * @return Size in bytes
+     */
+    size_t GetBytes() const { return mPixels.size(); }
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_RENDERIMAGE_H
@@ -0,0 +1,728 @@
+/**
+ * @file RenderList.cpp
+ * @author Thomas Toaz
+ */
+
+#include "pch.h"
+
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#include "RenderList.h"
+#include "Renderer.h"
+#include "RenderImage.h"
+#include "TextCache.h"
+
+/// Held while a function makes the pixels of a bitmap, since
+/// those functions fill caches that are not safe across threads
+static std::mutex ImageMutex;
+
+/**
+ * Get the path as a graphics path for a context.
+ *
+ * The path is kept for the renderer of the context, so replaying
+ * the same path again does not build it again.
+ * @param graphics Graphics context the path will be drawn on
+ * @return Graphics path
+ */
+wxGraphicsPath RenderList::Path::Native(std::shared_ptr<wxGraphicsContext> graphics) const
+{
+    if(mRenderer == graphics->GetRenderer() && mNativeSize == mElements.size() && !mNative.IsNull())
+    {
+        return mNative;
+    }
+
+    mNative = graphics->CreatePath();
+    mRenderer = graphics->GetRenderer();
+    mNativeSize = mElements.size();
+    for(auto &element : mElements)
+    {
+        auto v = element.mValues;
+        switch(element.mKind)
+        {
+        case Kind::Move:
+            mNative.MoveToPoint(v[0], v[1]);
+            break;
+
+        case Kind::Line:
+            mNative.AddLineToPoint(v[0], v[1]);
+            break;
+
+        case Kind::Curve:
+            mNative.AddCurveToPoint(v[0], v[1], v[2], v[3], v[4], v[5]);
+            break;
+
+        case Kind::Close:
+            mNative.CloseSubpath();
+            break;
+        }
+    }
+
+    return mNative;
+}
+
+/**
+ * Add a command
+ * @param op What the command does
+ * @param v0 First number
+ * @param v1 Second number
+ * @param v2 Third number
+ * @param v3 Fourth number
+ * @param v4 Fifth number
+ * @param index Index into the table the command uses
+ */
+void RenderList::Add(Op op, double v0, double v1, double v2, double v3, double v4, size_t index)
+{
+    Command command;
+    command.mOp = op;
+    command.mValues[0] = v0;
+    command.mValues[1] = v1;
+    command.mValues[2] = v2;
+    command.mValues[3] = v3;
+    command.mValues[4] = v4;
+    command.mIndex = index;
+    mCommands.push_back(command);
+}
+
+/**
+ * Add a command that uses a path
+ * @param op What the command does
+ * @param path The path
+ */
+void RenderList::AddPath(Op op, std::shared_ptr<const Path> path)
+{
+    mPaths.push_back(path);
+    Add(op, 0, 0, 0, 0, 0, mPaths.size() - 1);
+}
+
+/**
+ * Remove every command so the list can be recorded again
+ */
+void RenderList::Clear()
+{
+    mCommands.clear();
+    mPens.clear();
+    mBrushes.clear();
+    mFonts.clear();
+    mPaths.clear();
+    mTexts.clear();
+    mBitmaps.clear();
+    mCallbacks.clear();
+}
+
+/**
+ * Set the pen lines are drawn with
+ * @param pen The pen
+ */
+void RenderList::SetPen(const wxPen &pen)
+{
+    mPens.push_back(Pen{pen.GetColour().GetRGBA(), pen.GetWidth(), pen.GetStyle() == wxPENSTYLE_TRANSPARENT});
+    Add(Op::SetPen, 0, 0, 0, 0, 0, mPens.size() - 1);
+}
+
+/**
+ * Set the brush shapes are filled with
+ * @param brush The brush
+ */
+void RenderList::SetBrush(const wxBrush &brush)
+{
+    mBrushes.push_back(Brush{brush.GetColour().GetRGBA(), brush.GetStyle() == wxBRUSHSTYLE_TRANSPARENT});
+    Add(Op::SetBrush, 0, 0, 0, 0, 0, mBrushes.size() - 1);
+}
+
+/**
+ * Set the font and colour text is drawn with
+ * @param font The font
+ * @param colour Text colour
+ */
+void RenderList::SetFont(const wxFont &font, const wxColour &colour)
+{
+    // Points are 1/72 inch and the software renderer takes 96 pixels an inch
+    mFonts.push_back(Font{font, font.GetPointSize() * 96.0 / 72.0, colour.GetRGBA()});
+    Add(Op::SetFont, 0, 0, 0, 0, 0, mFonts.size() - 1);
+}
+
+/**
+ * Fill a path with the current brush
+ * @param path The path
+ */
+void RenderList::FillPath(std::shared_ptr<const Path> path)
+{
+    AddPath(Op::FillPath, path);
+}
+
+/**
+ * Draw the outline of a path with the current pen
+ * @param path The path
+ */
+void RenderList::StrokePath(std::shared_ptr<const Path> path)
+{
+    AddPath(Op::StrokePath, path);
+}
+
+/**
+ * Fill a path with the current brush and draw its outline with the current pen
+ * @param path The path
+ */
+void RenderList::DrawPath(std::shared_ptr<const Path> path)
+{
+    AddPath(Op::DrawPath, path);
+}
+
+/**
+ * Draw text with the current font.
+ *
+ * The text is measured when the list is replayed, so it can be
+ * placed relative to its width without a graphics context.
+ * @param text The text
+ * @param x X location
+ * @param y Y location of the top of the text
+ * @param align Fraction of the text width that is left of x,
+ * 0 for left aligned or 0.5 for centered
+ */
+void RenderList::DrawText(const std::wstring &text, double x, double y, double align)
+{
+    mTexts.push_back(text);
+    Add(Op::DrawText, x, y, align, 0, 0, mTexts.size() - 1);
+}
+
+/**
+ * Draw a bitmap
+ * @param name Name the bitmap is written out and compared by
+ * @param source Makes the bitmap when the list is replayed.
+ * A null bitmap draws nothing.
+ * @param x Left
+ * @param y Top
+ * @param w Width
+ * @param h Height
+ */
+void RenderList::DrawBitmap(const std::wstring &name, BitmapSource source, double x, double y, double w, double h)
+{
+    DrawBitmap(name, source, nullptr, x, y, w, h);
+}
+
+/**
+ * Draw a bitmap that can also be drawn by a Renderer
+ * @param name Name the bitmap is written out and compared by
+ * @param source Makes the bitmap when the list is replayed into a
+ * graphics context. A null bitmap draws nothing.
+ * @param image Makes the pixels when the list is replayed into a
+ * Renderer. A null image draws nothing.
+ * @param x Left
+ * @param y Top
+ * @param w Width
+ * @param h Height
+ */
+void RenderList::DrawBitmap(const std::wstring &name, BitmapSource source, ImageSource image,
+        double x, double y, double w, double h)
+{
+    mBitmaps.push_back(Bitmap{name, source, image});
+    Add(Op::DrawBitmap, x, y, w, h, 0, mBitmaps.size() - 1);
+}
+
+/**
+ * Add a function that draws directly when the list is replayed.
+ *
+ * The function is called between a push and a pop of the
+ * graphics state. This lets drawing that has not been converted
+ * to commands be part of a list, but it can not be compared.
+ * @param callback The function
+ */
+void RenderList::AddCallback(Callback callback)
+{
+    mCallbacks.push_back(callback);
+    Add(Op::Callback, 0, 0, 0, 0, 0, mCallbacks.size() - 1);
+}
+
+/**
+ * Make a colour from its RGBA value
+ * @param rgba Colour as RGBA
+ * @return Colour
+ */
+static wxColour Colour(unsigned int rgba)
+{
+    wxColour colour;
+    colour.SetRGBA(rgba);
+    return colour;
+}
+
+/**
+ * Draw the commands into a graphics context.
+ *
+ * Text is drawn from the shared TextCache, so the same string in
+ * the same font is only laid out once. The font is only given to
+ * the context when a callback may draw with it.
+ * @param graphics Graphics context to draw on
+ */
+void RenderList::Replay(std::shared_ptr<wxGraphicsContext> graphics) const
+{
+    auto &textCache = TextCache::Shared();
+
+    // Font text is drawn in, and whether the context has it
+    const Font *font = nullptr;
+    bool fontSet = true;
+
+    for(auto &command : mCommands)
+    {
+        auto v = command.mValues;
+        switch(command.mOp)
+        {
+        case Op::PushState:
+            graphics->PushState();
+            break;
+
+        case Op::PopState:
+            graphics->PopState();
+            break;
+
+        case Op::Translate:
+            graphics->Translate(v[0], v[1]);
+            break;
+
+        case Op::Scale:
+            graphics->Scale(v[0], v[1]);
+            break;
+
+        case Op::Rotate:
+            graphics->Rotate(v[0]);
+            break;
+
+        case Op::SetPen:
+        {
+            auto &pen = mPens[command.mIndex];
+            graphics->SetPen(pen.mTransparent ? *wxTRANSPARENT_PEN : wxPen(Colour(pen.mColour), pen.mWidth));
+            break;
+        }
+
+        case Op::SetBrush:
+        {
+            auto &brush = mBrushes[command.mIndex];
+            graphics->SetBrush(brush.mTransparent ? *wxTRANSPARENT_BRUSH : wxBrush(Colour(brush.mColour)));
+            break;
+        }
+
+        case Op::SetFont:
+            font = &mFonts[command.mIndex];
+            fontSet = false;
+            break;
+
+        case Op::SetInterpolationQuality:
+            graphics->SetInterpolationQuality(wxInterpolationQuality(int(v[0])));
+            break;
+
+        case Op::FillPath:
+            graphics->FillPath(mPaths[command.mIndex]->Native(graphics));
+            break;
+
+        case Op::StrokePath:
+            graphics->StrokePath(mPaths[command.mIndex]->Native(graphics));
+            break;
+
+        case Op::DrawPath:
+            graphics->DrawPath(mPaths[command.mIndex]->Native(graphics));
+            break;
+
+        case Op::StrokeLine:
+            graphics->StrokeLine(v[0], v[1], v[2], v[3]);
+            break;
+
+        case Op::DrawRectangle:
+            graphics->DrawRectangle(v[0], v[1], v[2], v[3]);
+            break;
+
+        case Op::DrawEllipse:
+            graphics->DrawEllipse(v[0], v[1], v[2], v[3]);
+            break;
+
+        case Op::DrawText:
+            if(font != nullptr)
+            {
+                textCache.Draw(graphics, font->mFont, mTexts[command.mIndex], Colour(font->mColour), v[0], v[1], v[2]);
+            }
+            break;
+
+        case Op::DrawBitmap:
+        {
+            auto bitmap = mBitmaps[command.mIndex].mSource(graphics);
+            if(!bitmap.IsNull())
+            {
+                graphics->DrawBitmap(bitmap, v[0], v[1], v[2], v[3]);
+            }
+            break;
+        }
+
+        case Op::Callback:
+            if(!fontSet)
+            {
+                graphics->SetFont(font->mFont, Colour(font->mColour));
+                fontSet = true;
+            }
+
+            graphics->PushState();
+            mCallbacks[command.mIndex](graphics);
+            graphics->PopState();
+            break;
+        }
+    }
+}
+
+/**
+ * Add an ellipse to a path as four curves
+ * @param path Path to add to
+ * @param x Left of the bounding rectangle
+ * @param y Top of the bounding rectangle
+ * @param w Width
+ * @param h Height
+ */
+static void AddEllipse(RenderPath &path, double x, double y, double w, double h)
+{
+    // Distance of the control points from the ends of a quarter circle
+    const double k = 0.5522847498;
+
+    double rx = w / 2, ry = h / 2;
+    double cx = x + rx, cy = y + ry;
+    path.MoveToPoint(cx + rx, cy);
+    path.AddCurveToPoint(cx + rx, cy + ry * k, cx + rx * k, cy + ry, cx, cy + ry);
+    path.AddCurveToPoint(cx - rx * k, cy + ry, cx - rx, cy + ry * k, cx - rx, cy);
+    path.AddCurveToPoint(cx - rx, cy - ry * k, cx - rx * k, cy - ry, cx, cy - ry);
+    path.AddCurveToPoint(cx + rx * k, cy - ry, cx + rx, cy - ry * k, cx + rx, cy);
+    path.CloseSubpath();
+}
+
+/**
+ * Draw the commands with a Renderer.
+ *
+ * Lines, rectangles and ellipses become paths. Callbacks need a
+ * graphics context, so they are left out, as are bitmaps that
+ * were recorded with no function to make their pixels.
+ *
+ * A list may be replayed into renderers on several threads at
+ * once, as TileRenderer does.
+ * @param renderer Renderer to draw with
+ */
+void RenderList::Replay(Renderer &renderer) const
+{
+    for(auto &command : mCommands)
+    {
+        auto v = command.mValues;
+        switch(command.mOp)
+        {
+        case Op::PushState:
+            renderer.PushState();
+            break;
+
+        case Op::PopState:
+            renderer.PopState();
+            break;
+
+        case Op::Translate:
+            renderer.Translate(v[0], v[1]);
+            break;
+
+        case Op::Scale:
+            renderer.Scale(v[0], v[1]);
+            break;
+
+        case Op::Rotate:
+            renderer.Rotate(v[0]);
+            break;
+
+        case Op::SetPen:
+        {
+            auto &pen = mPens[command.mIndex];
+            renderer.SetPen(pen.mTransparent ? 0 : pen.mColour, pen.mWidth);
+            break;
+        }
+
+        case Op::SetBrush:
+        {
+            auto &brush = mBrushes[command.mIndex];
+            renderer.SetBrush(brush.mTransparent ? 0 : brush.mColour);
+            break;
+        }
+
+        case Op::SetFont:
+            renderer.SetFont(mFonts[command.mIndex].mHeight, mFonts[command.mIndex].mColour);
+            break;
+
+        case Op::SetInterpolationQuality:
+            renderer.SetSmooth(wxInterpolationQuality(int(v[0])) != wxINTERPOLATION_NONE);
+            break;
+
+        case Op::FillPath:
+            renderer.FillPath(*mPaths[command.mIndex]);
+            break;
+
+        case Op::StrokePath:
+            renderer.StrokePath(*mPaths[command.mIndex]);
+            break;
+
+        case Op::DrawPath:
+            renderer.FillPath(*mPaths[command.mIndex]);
+            renderer.StrokePath(*mPaths[command.mIndex]);
+            break;
+
+        case Op::StrokeLine:
+        {
+            RenderPath path;
+            path.MoveToPoint(v[0], v[1]);
+            path.AddLineToPoint(v[2], v[3]);
+            renderer.StrokePath(path);
+            break;
+        }
+
+        case Op::DrawRectangle:
+        {
+            RenderPath path;
+            path.MoveToPoint(v[0], v[1]);
+            path.AddLineToPoint(v[0] + v[2], v[1]);
+            path.AddLineToPoint(v[0] + v[2], v[1] + v[3]);
+            path.AddLineToPoint(v[0], v[1] + v[3]);
+            path.CloseSubpath();
+            renderer.FillPath(path);
+            renderer.StrokePath(path);
+            break;
+        }
+
+        case Op::DrawEllipse:
+        {
+            RenderPath path;
+            AddEllipse(path, v[0], v[1], v[2], v[3]);
+            renderer.FillPath(path);
+            renderer.StrokePath(path);
+            break;
+        }
+
+        case Op::DrawText:
+        {
+            auto &text = mTexts[command.mIndex];
+            double x = v[0];
+            if(v[2] != 0)
+            {
+                x -= renderer.GetTextWidth(text) * v[2];
+            }
+
+            renderer.DrawText(text, x, v[1]);
+            break;
+        }
+
+        case Op::DrawBitmap:
+        {
+            auto &source = mBitmaps[command.mIndex].mImage;
+            if(source != nullptr)
+            {
+                std::shared_ptr<const RenderImage> image;
+                {
+                    std::lock_guard<std::mutex> lock(ImageMutex);
+                    image = source(renderer.GetTransform().GetScale());
+                }
+
+                if(image != nullptr)
+                {
+                    renderer.DrawImage(*image, v[0], v[1], v[2], v[3]);
+                }
+            }
+            break;
+        }
+
+        case Op::Callback:
+            break;
+        }
+    }
+}
+
+/**
+ * Count the commands Replay(Renderer&) leaves out.
+ *
+ * These are callbacks and bitmaps with no function to make their
+ * pixels, which only a graphics context can draw.
+ * @return Number of commands a Renderer does not draw
+ */
+size_t RenderList::CountUnrenderable() const
+{
+    size_t count = 0;
+    for(auto &command : mCommands)
+    {
+        if(command.mOp == Op::Callback ||
+                (command.mOp == Op::DrawBitmap && mBitmaps[command.mIndex].mImage == nullptr))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Make the pixels a Renderer draws from an image
+ * @param image The image
+ * @return Pixels with premultiplied alpha
+ */
+std::shared_ptr<RenderImage> RenderList::MakeImage(const wxImage &image)
+{
+    auto pixels = std::make_shared<RenderImage>(image.GetWidth(), image.GetHeight());
+    if(image.HasMask() && !image.HasAlpha())
+    {
+        // A mask colour counts as transparent
+        wxImage alpha = image.Copy();
+        alpha.InitAlpha();
+        pixels->SetPlanes(alpha.GetData(), alpha.GetAlpha());
+    }
+    else
+    {
+        pixels->SetPlanes(image.GetData(), image.HasAlpha() ? image.GetAlpha() : nullptr);
+    }
+
+    return pixels;
+}
+
+/**
+ * Describe a command as one line of text
+ * @param i Index of the command
+ * @return Description such as translate 10 20
+ */
+std::wstring RenderList::Describe(size_t i) const
+{
+    auto &command = mCommands[i];
+    auto v = command.mValues;
+
+    std::wstringstream str;
+    switch(command.mOp)
+    {
+    case Op::PushState:
+        str << L"push";
+        break;
+
+    case Op::PopState:
+        str << L"pop";
+        break;
+
+    case Op::Translate:
+        str << L"translate " << v[0] << L" " << v[1];
+        break;
+
+    case Op::Scale:
+        str << L"scale " << v[0] << L" " << v[1];
+        break;
+
+    case Op::Rotate:
+        str << L"rotate " << v[0];
+        break;
+
+    case Op::SetPen:
+    {
+        auto &pen = mPens[command.mIndex];
+        str << L"pen ";
+        if(pen.mTransparent)
+        {
+            str << L"none";
+        }
+        else
+        {
+            str << std::hex << std::setw(8) << std::setfill(L'0') << pen.mColour << std::dec << L" " << pen.mWidth;
+        }
+        break;
+    }
+
+    case Op::SetBrush:
+    {
+        auto &brush = mBrushes[command.mIndex];
+        str << L"brush ";
+        if(brush.mTransparent)
+        {
+            str << L"none";
+        }
+        else
+        {
+            str << std::hex << std::setw(8) << std::setfill(L'0') << brush.mColour;
+        }
+        break;
+    }
+
+    case Op::SetFont:
+    {
+        auto &font = mFonts[command.mIndex];
+        str << L"font " << font.mFont.GetNativeFontInfoDesc().ToStdWstring() << L" "
+            << std::hex << std::setw(8) << std::setfill(L'0') << font.mColour;
+        break;
+    }
+
+    case Op::SetInterpolationQuality:
+        str << L"interpolation " << int(v[0]);
+        break;
+
+    case Op::FillPath:
+        str << L"fill" << mPaths[command.mIndex]->Describe();
+        break;
+
+    case Op::StrokePath:
+        str << L"stroke" << mPaths[command.mIndex]->Describe();
+        break;
+
+    case Op::DrawPath:
+        str << L"path" << mPaths[command.mIndex]->Describe();
+        break;
+
+    case Op::StrokeLine:
+        str << L"line " << v[0] << L" " << v[1] << L" " << v[2] << L" " << v[3];
+        break;
+
+    case Op::DrawRectangle:
+        str << L"rectangle " << v[0] << L" " << v[1] << L" " << v[2] << L" " << v[3];
+        break;
+
+    case Op::DrawEllipse:
+        str << L"ellipse " << v[0] << L" " << v[1] << L" " << v[2] << L" " << v[3];
+        break;
+
+    case Op::DrawText:
+        str << L"text " << v[0] << L" " << v[1] << L" " << v[2] << L" \"" << mTexts[command.mIndex] << L"\"";
+        break;
+
+    case Op::DrawBitmap:
+        str << L"bitmap " << v[0] << L" " << v[1] << L" " << v[2] << L" " << v[3] << L" \""
+            << mBitmaps[command.mIndex].mName << L"\"";
+        break;
+
+    case Op::Callback:
+        str << L"callback";
+        break;
+    }
+
+    return str.str();
+}
+
+/**
+ * Write the commands out, one line each, for debugging
+ * @param out Stream to write to
+ */
+void RenderList::Save(std::wostream &out) const
+{
+    for(size_t i = 0; i < mCommands.size(); i++)
+    {
+        out << Describe(i) << std::endl;
+    }
+}
+
+/**
+ * Find the first command where this list and another differ.
+ *
+ * Commands are compared by their descriptions, so bitmaps are
+ * compared by name and callbacks always compare equal.
+ * @param other List to compare with
+ * @return Index of the first command that differs, or -1 if the lists are the same
+ */
+int RenderList::FirstDifference(const RenderList &other) const
+{
+    size_t count = std::min(mCommands.size(), other.mCommands.size());
+    for(size_t i = 0; i < count; i++)
+    {
+        if(mCommands[i].mOp != other.mCommands[i].mOp || Describe(i) != other.Describe(i))
+        {
+            return int(i);
+        }
+    }
+
+    return mCommands.size() == other.mCommands.size() ? -1 : int(count);
+}
@@ -0,0 +1,298 @@
+/**
+ * @file RenderList.h
+ * @author Thomas Toaz
+ *
+ * A recorded list of drawing commands that can be replayed
+ * into any graphics context.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_RENDERLIST_H
+#define CANADIANEXPERIENCE_MACHINELIB_RENDERLIST_H
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "RenderPath.h"
+
+class Renderer;
+class RenderImage;
+
+/**
+ * A recorded list of drawing commands that can be replayed
+ * into any graphics context.
+ *
+ * The recording calls mirror the wxGraphicsContext calls the
+ * drawing code makes, but nothing is drawn and no graphics
+ * context is needed, so a frame can be recorded on a worker
+ * thread and replayed into the window, a bitmap or an export
+ * target without walking the scene again.
+ *
+ * Pens, brushes and paths are kept as plain values, so two
+ * recordings can be written out and compared. Bitmaps are
+ * recorded by name with a function that makes the graphics
+ * bitmap when the list is replayed, since graphics bitmaps
+ * belong to a graphics context, and optionally one that makes
+ * the pixels for a Renderer. Anything else can be recorded as a
+ * callback that draws directly.
+ *
+ * A list can also be replayed into a Renderer, such as the
+ * SoftwareRenderer, which needs no windowing system. Callbacks
+ * and bitmaps with no pixels are left out there.
+ *
+ * A list must not be replayed while the objects that recorded
+ * bitmaps or callbacks into it are being recorded again or
+ * have been destroyed.
+ */
+class RenderList
+{
+public:
+    /// Function that makes a bitmap for the context it is replayed into
+    typedef std::function<wxGraphicsBitmap(std::shared_ptr<wxGraphicsContext> graphics)> BitmapSource;
+
+    /// Function that draws directly into the context it is replayed into
+    typedef std::function<void(std::shared_ptr<wxGraphicsContext> graphics)> Callback;
+
+    /// Function that makes the pixels of a bitmap for the software renderer,
+    /// given how many device pixels each unit of the bitmap rectangle covers
+    typedef std::function<std::shared_ptr<const RenderImage>(double scale)> ImageSource;
+
+    /**
+     * A path made of lines and curves, kept as plain values,
+     * that can also be drawn on a graphics context.
+     */
+    class Path : public RenderPath
+    {
+    private:
+        /// Native path made for mRenderer
+        mutable wxGraphicsPath mNative;
+
+        /// Renderer mNative was made by
+        mutable wxGraphicsRenderer *mRenderer = nullptr;
+
+        /// Number of elements in mNative
+        mutable size_t mNativeSize = 0;
+
+    public:
+        using RenderPath::MoveToPoint;
+        using RenderPath::AddLineToPoint;
+
+        /**
+         * Begin a new subpath at a point
+         * @param point The point
+         */
+        void MoveToPoint(const wxPoint2DDouble &point) { MoveToPoint(point.m_x, point.m_y); }
+
+        /**
+         * Add a line to a point
+         * @param point The point
+         */
+        void AddLineToPoint(const wxPoint2DDouble &point) { AddLineToPoint(point.m_x, point.m_y); }
+
+        wxGraphicsPath Native(std::shared_ptr<wxGraphicsContext> graphics) const;
+    };
+
+private:
+    /// Kinds of command
+    enum class Op
+    {
+        PushState, PopState, Translate, Scale, Rotate,
+        SetPen, SetBrush, SetFont, SetInterpolationQuality,
+        FillPath, StrokePath, DrawPath, StrokeLine, DrawRectangle, DrawEllipse,
+        DrawText, DrawBitmap, Callback
+    };
+
+    /// One recorded command
+    struct Command
+    {
+        /// What the command does
+        Op mOp;
+
+        /// Numbers the command takes, such as a position and size
+        double mValues[5] = {0, 0, 0, 0, 0};
+
+        /// Index into the table the command uses, if it uses one
+        size_t mIndex = 0;
+    };
+
+    /// A pen, as its colour and width
+    struct Pen
+    {
+        /// Colour as RGBA
+        unsigned int mColour;
+
+        /// Width in pixels
+        int mWidth;
+
+        /// Does the pen draw nothing?
+        bool mTransparent;
+    };
+
+    /// A brush, as its colour
+    struct Brush
+    {
+        /// Colour as RGBA
+        unsigned int mColour;
+
+        /// Does the brush fill nothing?
+        bool mTransparent;
+    };
+
+    /// A font and the colour text is drawn in
+    struct Font
+    {
+        /// The font
+        wxFont mFont;
+
+        /// Height of a line of text in user units
+        double mHeight;
+
+        /// Colour as RGBA
+        unsigned int mColour;
+    };
+
+    /// A bitmap and its name
+    struct Bitmap
+    {
+        /// Name, usually the file the pixels came from
+        std::wstring mName;
+
+        /// Makes the bitmap
+        BitmapSource mSource;
+
+        /// Makes the pixels, if the bitmap can be drawn by the software renderer
+        ImageSource mImage;
+    };
+
+    /// The commands in the order they were recorded
+    std::vector<Command> mCommands;
+
+    /// Pens used by SetPen commands
+    std::vector<Pen> mPens;
+
+    /// Brushes used by SetBrush commands
+    std::vector<Brush> mBrushes;
+
+    /// Fonts used by SetFont commands
+    std::vector<Font> mFonts;
+
+    /// Paths used by path commands
+    std::vector<std::shared_ptr<const Path>> mPaths;
+
+    /// Strings used by DrawText commands
+    std::vector<std::wstring> mTexts;
+
+    /// Bitmaps used by DrawBitmap commands
+    std::vector<Bitmap> mBitmaps;
+
+    /// Functions used by Callback commands
+    std::vector<Callback> mCallbacks;
+
+    void Add(Op op, double v0 = 0, double v1 = 0, double v2 = 0, double v3 = 0, double v4 = 0, size_t index = 0);
+    void AddPath(Op op, std::shared_ptr<const Path> path);
+
+public:
+    /// Constructor
+    RenderList() {}
+
+    /// Copy constructor (disabled)
+    RenderList(const RenderList &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const RenderList &) = delete;
+
+    void Clear();
+
+    /**
+     * Get the number of commands recorded
+     * @return Number of commands
+     */
+    size_t GetSize() const { return mCommands.size(); }
+
+    /// Save the current transform and attributes
+    void PushState() { Add(Op::PushState); }
+
+    /// Restore the transform and attributes saved by PushState
+    void PopState() { Add(Op::PopState); }
+
+    /**
+     * Translate the coordinate system
+     * @param dx X distance
+     * @param dy Y distance
+     */
+    void Translate(double dx, double dy) { Add(Op::Translate, dx, dy); }
+
+    /**
+     * Scale the coordinate system
+     * @param xScale X scale
+     * @param yScale Y scale
+     */
+    void Scale(double xScale, double yScale) { Add(Op::Scale, xScale, yScale); }
+
+    /**
+     * Rotate the coordinate system
+     * @param angle Angle in radians
+     */
+    void Rotate(double angle) { Add(Op::Rotate, angle); }
+
+    void SetPen(const wxPen &pen);
+    void SetBrush(const wxBrush &brush);
+    void SetFont(const wxFont &font, const wxColour &colour);
+
+    /**
+     * Set how bitmaps are filtered when they are scaled
+     * @param quality Interpolation quality
+     */
+    void SetInterpolationQuality(wxInterpolationQuality quality) { Add(Op::SetInterpolationQuality, quality); }
+
+    void FillPath(std::shared_ptr<const Path> path);
+    void StrokePath(std::shared_ptr<const Path> path);
+    void DrawPath(std::shared_ptr<const Path> path);
+
+    /**
+     * Draw a line with the current pen
+     * @param x1 Start X
+     * @param y1 Start Y
+     * @param x2 End X
+     * @param y2 End Y
+     */
+    void StrokeLine(double x1, double y1, double x2, double y2) { Add(Op::StrokeLine, x1, y1, x2, y2); }
+
+    /**
+     * Draw a rectangle with the current pen and brush
+     * @param x Left
+     * @param y Top
+     * @param w Width
+     * @param h Height
+     */
+    void DrawRectangle(double x, double y, double w, double h) { Add(Op::DrawRectangle, x, y, w, h); }
+
+    /**
+     * Draw an ellipse with the current pen and brush
+     * @param x Left of the bounding rectangle
+     * @param y Top of the bounding rectangle
+     * @param w Width
+     * @param h Height
+     */
+    void DrawEllipse(double x, double y, double w, double h) { Add(Op::DrawEllipse, x, y, w, h); }
+
+    void DrawText(const std::wstring &text, double x, double y, double align = 0);
+    void DrawBitmap(const std::wstring &name, BitmapSource source, double x, double y, double w, double h);
+    void DrawBitmap(const std::wstring &name, BitmapSource source, ImageSource image,
+            double x, double y, double w, double h);
+    void AddCallback(Callback callback);
+
+    void Replay(std::shared_ptr<wxGraphicsContext> graphics) const;
+    void Replay(Renderer &renderer) const;
+    size_t CountUnrenderable() const;
+
+    static std::shared_ptr<RenderImage> MakeImage(const wxImage &image);
+
+    std::wstring Describe(size_t i) const;
+    void Save(std::wostream &out) const;
+    int FirstDifference(const RenderList &other) const;
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_RENDERLIST_H
@@ -0,0 +1,125 @@
+/**
+ * @file RenderMatrix.h
+ * @author Thomas Toaz
+ *
+ * Affine transform from user to device coordinates.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_RENDERMATRIX_H
+#define CANADIANEXPERIENCE_MACHINELIB_RENDERMATRIX_H
+
+#include <cmath>
+
+/**
+ * Affine transform from user to device coordinates.
+ *
+ * The values are in the order wxAffineMatrix2D uses, so a point
+ * x, y goes to a * x + c * y + tx, b * x + d * y + ty. Translate,
+ * Scale and Rotate change the transform the way the calls of the
+ * same name on a graphics context do, applying to user
+ * coordinates before the transform that is already there.
+ */
+class RenderMatrix
+{
+public:
+    /// X scale
+    double mA = 1;
+
+    /// Y shear
+    double mB = 0;
+
+    /// X shear
+    double mC = 0;
+
+    /// Y scale
+    double mD = 1;
+
+    /// X translation
+    double mTx = 0;
+
+    /// Y translation
+    double mTy = 0;
+
+    /**
+     * Translate the user coordinate system
+     * @param dx X distance
+     * @param dy Y distance
+     */
+    void Translate(double dx, double dy)
+    {
+        mTx += mA * dx + mC * dy;
+        mTy += mB * dx + mD * dy;
+    }
+
+    /**
+     * Scale the user coordinate system
+     * @param xScale X scale
+     * @param yScale Y scale
+     */
+    void Scale(double xScale, double yScale)
+    {
+        mA *= xScale;
+        mB *= xScale;
+        mC *= yScale;
+        mD *= yScale;
+    }
+
+    /**
+     * Rotate the user coordinate system
+     * @param angle Angle in radians
+     */
+    void Rotate(double angle)
+    {
+        double cs = std::cos(angle);
+        double sn = std::sin(angle);
+        double a = mA * cs + mC * sn;
+        double b = mB * cs + mD * sn;
+        mC = mC * cs - mA * sn;
+        mD = mD * cs - mB * sn;
+        mA = a;
+        mB = b;
+    }
+
+    /**
+     * Transform a point from user to device coordinates
+     * @param x X in user coordinates
+     * @param y Y in user coordinates
+     * @param dx Receives X in device coordinates
+     * @param dy Receives Y in device coordinates
+     */
+    void Apply(double x, double y, double &dx, double &dy) const
+    {
+        dx = mA * x + mC * y + mTx;
+        dy = mB * x + mD * y + mTy;
+    }
+
+    /**
+     * Get how many device pixels a user unit covers, on average
+     * @return Square root of the area scale
+     */
+    double GetScale() const { return std::sqrt(std::abs(mA * mD - mB * mC)); }
+
+    /**
+     * Get the transform from device back to user coordinates
+     * @param inverse Receives the inverse transform
+     * @return false if the transform can not be inverted
+     */
+    bool Invert(RenderMatrix &inverse) const
+    {
+        double det = mA * mD - mB * mC;
+        if(det == 0)
+        {
+            return false;
+        }
+
+        inverse.mA = mD / det;
+        inverse.mB = -mB / det;
+        inverse.mC = -mC / det;
+        inverse.mD = mA / det;
+        inverse.mTx = (mC * mTy - mD * mTx) / det;
+        inverse.mTy = (mB * mTx - mA * mTy) / det;
+        return true;
+    }
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_RENDERMATRIX_H
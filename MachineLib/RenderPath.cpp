@@ -0,0 +1,228 @@
+/**
+ * @file RenderPath.cpp
+ * @author Thomas Toaz
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "RenderPath.h"
+
+/// Most lines a curve is flattened into
+const int MaxCurveSegments = 100;
+
+/**
+ * Begin a new subpath at a point
+ * @param x X location
+ * @param y Y location
+ */
+void RenderPath::MoveToPoint(double x, double y)
+{
+    mElements.push_back(Element{Kind::Move, {x, y, 0, 0, 0, 0}});
+}
+
+/**
+ * Add a line to a point
+ * @param x X location
+ * @param y Y location
+ */
+void RenderPath::AddLineToPoint(double x, double y)
+{
+    mElements.push_back(Element{Kind::Line, {x, y, 0, 0, 0, 0}});
+}
+
+/**
+ * Add a cubic Bezier curve to a point
+ * @param cx1 First control point X
+ * @param cy1 First control point Y
+ * @param cx2 Second control point X
+ * @param cy2 Second control point Y
+ * @param x End X
+ * @param y End Y
+ */
+void RenderPath::AddCurveToPoint(double cx1, double cy1, double cx2, double cy2, double x, double y)
+{
+    mElements.push_back(Element{Kind::Curve, {cx1, cy1, cx2, cy2, x, y}});
+}
+
+/**
+ * Close the current subpath with a line to its start
+ */
+void RenderPath::CloseSubpath()
+{
+    mElements.push_back(Element{Kind::Close, {0, 0, 0, 0, 0, 0}});
+}
+
+/**
+ * Is a point inside the path?
+ *
+ * This uses the odd-even rule, as wxGraphicsPath::Contains does,
+ * with every subpath closed. Curves are treated as a line to
+ * their end points.
+ * @param x X location
+ * @param y Y location
+ * @return true if the point is inside
+ */
+bool RenderPath::Contains(double x, double y) const
+{
+    bool inside = false;
+    Point start{0, 0}, current{0, 0};
+
+    // Count the edge from a to b if it crosses the ray to the right of x, y
+    auto edge = [&inside, x, y](Point a, Point b) {
+        if((a.mY > y) != (b.mY > y) &&
+            x < a.mX + (y - a.mY) * (b.mX - a.mX) / (b.mY - a.mY))
+        {
+            inside = !inside;
+        }
+    };
+
+    for(auto &element : mElements)
+    {
+        switch(element.mKind)
+        {
+        case Kind::Move:
+            edge(current, start);
+            start = current = Point{element.mValues[0], element.mValues[1]};
+            break;
+
+        case Kind::Line:
+            edge(current, Point{element.mValues[0], element.mValues[1]});
+            current = Point{element.mValues[0], element.mValues[1]};
+            break;
+
+        case Kind::Curve:
+            edge(current, Point{element.mValues[4], element.mValues[5]});
+            current = Point{element.mValues[4], element.mValues[5]};
+            break;
+
+        case Kind::Close:
+            edge(current, start);
+            current = start;
+            break;
+        }
+    }
+
+    edge(current, start);
+    return inside;
+}
+
+/**
+ * Describe the path in the form of an SVG path
+ * @return Description such as M 0 0 L 10 0 Z
+ */
+std::wstring RenderPath::Describe() const
+{
+    std::wstringstream str;
+    for(auto &element : mElements)
+    {
+        auto v = element.mValues;
+        switch(element.mKind)
+        {
+        case Kind::Move:
+            str << L" M " << v[0] << L" " << v[1];
+            break;
+
+        case Kind::Line:
+            str << L" L " << v[0] << L" " << v[1];
+            break;
+
+        case Kind::Curve:
+            str << L" C " << v[0] << L" " << v[1] << L" " << v[2] << L" " << v[3] << L" " << v[4] << L" " << v[5];
+            break;
+
+        case Kind::Close:
+            str << L" Z";
+            break;
+        }
+    }
+
+    return str.str();
+}
+
+/**
+ * Flatten the path into lines in device coordinates.
+ *
+ * Each curve is split into enough lines that none is further
+ * than the tolerance from the curve, judged by how far the
+ * control points bend away from a straight line.
+ * @param matrix Transform from path to device coordinates
+ * @param tolerance Largest distance from a curve in device pixels
+ * @param polylines Receives a polyline for each subpath
+ */
+void RenderPath::Flatten(const RenderMatrix &matrix, double tolerance, std::vector<Polyline> &polylines) const
+{
+    polylines.clear();
+    Point start{0, 0}, current{0, 0};
+
+    auto point = [&matrix](double x, double y) {
+        Point p;
+        matrix.Apply(x, y, p.mX, p.mY);
+        return p;
+    };
+
+    // Polyline the next line is added to, starting one if needed
+    auto polyline = [&polylines, &current]() -> Polyline & {
+        if(polylines.empty() || polylines.back().mClosed)
+        {
+            polylines.push_back(Polyline());
+            polylines.back().mPoints.push_back(current);
+        }
+
+        return polylines.back();
+    };
+
+    for(auto &element : mElements)
+    {
+        auto v = element.mValues;
+        switch(element.mKind)
+        {
+        case Kind::Move:
+            start = current = point(v[0], v[1]);
+            polylines.push_back(Polyline());
+            polylines.back().mPoints.push_back(current);
+            break;
+
+        case Kind::Line:
+            current = point(v[0], v[1]);
+            polyline().mPoints.push_back(current);
+            break;
+
+        case Kind::Curve:
+        {
+            auto &line = polyline();
+            Point p0 = current;
+            Point p1 = point(v[0], v[1]);
+            Point p2 = point(v[2], v[3]);
+            Point p3 = point(v[4], v[5]);
+
+            double bend = 0.75 * std::max(
+                    std::hypot(p0.mX - 2 * p1.mX + p2.mX, p0.mY - 2 * p1.mY + p2.mY),
+                    std::hypot(p1.mX - 2 * p2.mX + p3.mX, p1.mY - 2 * p2.mY + p3.mY));
+            int segments = std::clamp(int(std::ceil(std::sqrt(bend / tolerance))), 1, MaxCurveSegments);
+
+            for(int i = 1; i <= segments; i++)
+            {
+                double t = double(i) / segments;
+                double s = 1 - t;
+                double a = s * s * s, b = 3 * s * s * t, c = 3 * s * t * t, d = t * t * t;
+                line.mPoints.push_back(Point{a * p0.mX + b * p1.mX + c * p2.mX + d * p3.mX,
+                                             a * p0.mY + b * p1.mY + c * p2.mY + d * p3.mY});
+            }
+
+            current = p3;
+            break;
+        }
+
+        case Kind::Close:
+            if(!polylines.empty() && !polylines.back().mClosed)
+            {
+                polylines.back().mClosed = true;
+            }
+
+            current = start;
+            break;
+        }
+    }
+}
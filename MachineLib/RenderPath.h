@@ -0,0 +1,79 @@
+/**
+ * @file RenderPath.h
+ * @author Thomas Toaz
+ *
+ * A path made of lines and curves, kept as plain values.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_RENDERPATH_H
+#define CANADIANEXPERIENCE_MACHINELIB_RENDERPATH_H
+
+#include <string>
+#include <vector>
+
+#include "RenderMatrix.h"
+
+/**
+ * A path made of lines and curves, kept as plain values.
+ *
+ * This does not depend on wxWidgets, so a path can be drawn by
+ * the software renderer as well as turned into a graphics path.
+ */
+class RenderPath
+{
+public:
+    /// A point of a flattened path
+    struct Point
+    {
+        /// X location
+        double mX;
+
+        /// Y location
+        double mY;
+    };
+
+    /// A subpath flattened into lines
+    struct Polyline
+    {
+        /// The points in order
+        std::vector<Point> mPoints;
+
+        /// Does the subpath end with a line back to its start?
+        bool mClosed = false;
+    };
+
+protected:
+    /// Kinds of path element
+    enum class Kind {Move, Line, Curve, Close};
+
+    /// One element of the path
+    struct Element
+    {
+        /// What the element does
+        Kind mKind;
+
+        /// End point last, after any control points
+        double mValues[6];
+    };
+
+    /// The elements in the order they were added
+    std::vector<Element> mElements;
+
+public:
+    void MoveToPoint(double x, double y);
+    void AddLineToPoint(double x, double y);
+    void AddCurveToPoint(double cx1, double cy1, double cx2, double cy2, double x, double y);
+    void CloseSubpath();
+
+    /**
+     * Is the path empty?
+     * @return true if nothing has been added
+     */
+    bool IsEmpty() const { return mElements.empty(); }
+
+    bool Contains(double x, double y) const;
+    std::wstring Describe() const;
+    void Flatten(const RenderMatrix &matrix, double tolerance, std::vector<Polyline> &polylines) const;
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_RENDERPATH_H
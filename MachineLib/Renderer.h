@@ -0,0 +1,131 @@
+/**
+ * @file Renderer.h
+ * @author Thomas Toaz
+ *
+ * Interface to something that draws the operations a render list records.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_RENDERER_H
+#define CANADIANEXPERIENCE_MACHINELIB_RENDERER_H
+
+#include <string>
+
+#include "RenderMatrix.h"
+
+class RenderPath;
+class RenderImage;
+
+/**
+ * Interface to something that draws the operations a render list records.
+ *
+ * This is the small set of operations the drawing code uses:
+ * a transform and attribute stack, filled and stroked paths,
+ * images and text. It does not depend on wxWidgets, so drawing
+ * through it needs no windowing system.
+ *
+ * Colours are RGBA with red in the low byte, as wxColour::GetRGBA
+ * gives them. A colour with no alpha draws nothing.
+ */
+class Renderer
+{
+public:
+    /// Destructor
+    virtual ~Renderer() {}
+
+    /// Save the current transform and attributes
+    virtual void PushState() = 0;
+
+    /// Restore the transform and attributes saved by PushState
+    virtual void PopState() = 0;
+
+    /**
+     * Translate the coordinate system
+     * @param dx X distance
+     * @param dy Y distance
+     */
+    virtual void Translate(double dx, double dy) = 0;
+
+    /**
+     * Scale the coordinate system
+     * @param xScale X scale
+     * @param yScale Y scale
+     */
+    virtual void Scale(double xScale, double yScale) = 0;
+
+    /**
+     * Rotate the coordinate system
+     * @param angle Angle in radians
+     */
+    virtual void Rotate(double angle) = 0;
+
+    /**
+     * Get the current transform
+     * @return Transform from user to device coordinates
+     */
+    virtual const RenderMatrix &GetTransform() const = 0;
+
+    /**
+     * Set the pen lines are drawn with
+     * @param colour Colour as RGBA
+     * @param width Width in user units
+     */
+    virtual void SetPen(unsigned int colour, double width) = 0;
+
+    /**
+     * Set the brush shapes are filled with
+     * @param colour Colour as RGBA
+     */
+    virtual void SetBrush(unsigned int colour) = 0;
+
+    /**
+     * Set the font text is drawn with
+     * @param height Height of a line of text in user units
+     * @param colour Colour as RGBA
+     */
+    virtual void SetFont(double height, unsigned int colour) = 0;
+
+    /**
+     * Set whether scaled images are filtered
+     * @param smooth true to filter, false to take the nearest pixel
+     */
+    virtual void SetSmooth(bool smooth) = 0;
+
+    /**
+     * Fill a path with the current brush
+     * @param path The path
+     */
+    virtual void FillPath(const RenderPath &path) = 0;
+
+    /**
+     * Draw the lines of a path with the current pen
+     * @param path The path
+     */
+    virtual void StrokePath(const RenderPath &path) = 0;
+
+    /**
+     * Draw an image scaled to a rectangle
+     * @param image The image
+     * @param x Left
+     * @param y Top
+     * @param width Width
+     * @param height Height
+     */
+    virtual void DrawImage(const RenderImage &image, double x, double y, double width, double height) = 0;
+
+    /**
+     * Get how wide text is in the current font
+     * @param text The text
+     * @return Width in user units
+     */
+    virtual double GetTextWidth(const std::wstring &text) = 0;
+
+    /**
+     * Draw text in the current font
+     * @param text The text
+     * @param x Left
+     * @param y Top
+     */
+    virtual void DrawText(const std::wstring &text, double x, double y) = 0;
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_RENDERER_H
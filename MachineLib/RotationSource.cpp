@@ -3,27 +3,123 @@
  * @author Thomas Toaz
  */
 
-#include "pch.h"
+#include <algorithm>
+
 #include "RotationSource.h"
 #include "IRotationSink.h"
 
 /**
  * Attached a rotational sink to this source
  * @param sink
+ * @param ratio Multiplier applied to the rotation and speed passed to the sink
  */
-void RotationSource::AddSink(std::shared_ptr<IRotationSink> sink)
+void RotationSource::AddSink(std::shared_ptr<IRotationSink> sink, double ratio)
 {
-    mSinks.push_back(sink);
-//    sink->SetRotationSource(this);
+    mSinks.push_back(Link{sink, ratio});
+    mRevision++;
 }
 
 /// Update all rotational sinks associated with this source
 void RotationSource::UpdateSinks()
 {
-    for(auto sink : mSinks)
+    if(!IsCompiled())
+    {
+        Compile();
+    }
+
+    for(auto &stage : mTrain)
+    {
+        stage.sink->Rotate(mRotation * stage.ratio, mSpeed * stage.ratio);
+    }
+}
+
+/**
+ * Is the compiled train up to date?
+ *
+ * The train is out of date once a sink has been added to any
+ * source in it, including sources further down the train.
+ * @return true if the train has been compiled since the last change
+ */
+bool RotationSource::IsCompiled() const
+{
+    if(mCompiled.empty())
+    {
+        return false;
+    }
+
+    for(auto &compiled : mCompiled)
+    {
+        if(compiled.source->mRevision != compiled.revision)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Compile the drive train into a list of sinks in drive order.
+ *
+ * A sink always comes after the sink that drives it. A sink
+ * reached by more than one path appears once, at the ratio of
+ * the first path to it. UpdateSinks compiles the train the first
+ * time it is called and again whenever a sink has been added
+ * anywhere in it.
+ * @return false if the train has a cycle. The link that closes
+ * the cycle is left out of the train.
+ */
+bool RotationSource::Compile()
+{
+    mTrain.clear();
+    mCompiled.clear();
+    std::vector<RotationSource *> path;
+    std::unordered_set<IRotationSink *> visited;
+    return CompileFrom(this, 1.0, path, visited);
+}
+
+/**
+ * Append the sinks of a source and everything they drive to the train
+ * @param source Source to append the sinks of
+ * @param ratio Multiplier from this source to that source
+ * @param path Sources being compiled, used to detect a cycle
+ * @param visited Sinks already in the train
+ * @return false if a cycle was found
+ */
+bool RotationSource::CompileFrom(RotationSource *source, double ratio, std::vector<RotationSource *> &path,
+        std::unordered_set<IRotationSink *> &visited)
+{
+    path.push_back(source);
+    mCompiled.push_back(Compiled{source, source->mRevision});
+
+    bool acyclic = true;
+    for(auto &link : source->mSinks)
     {
-        sink->Rotate(mRotation,mSpeed);
+        auto driven = link.sink->GetDrivenSource();
+        if(driven != nullptr && std::find(path.begin(), path.end(), driven) != path.end())
+        {
+            // This link closes a cycle
+            acyclic = false;
+            continue;
+        }
+
+        if(!visited.insert(link.sink.get()).second)
+        {
+            // Already driven through another path
+            continue;
+        }
+
+        auto stageRatio = ratio * link.ratio;
+        mTrain.push_back(Stage{link.sink.get(), stageRatio});
+
+        if(driven != nullptr && !CompileFrom(driven, stageRatio, path, visited))
+        {
+            acyclic = false;
+        }
     }
+
+    path.pop_back();
+    return acyclic;
 }
 
 /**
@@ -8,23 +8,76 @@
 #ifndef CANADIANEXPERIENCE_MACHINELIB_ROTATIONSOURCE_H
 #define CANADIANEXPERIENCE_MACHINELIB_ROTATIONSOURCE_H
 
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
 class IRotationSink;
 
 /**
  * Rotational source class for machine objects that can transfer rotation to other objects
+ *
+ * The sinks attached to this source, the sinks those drive and
+ * so on form a drive train. The train is compiled into a list in
+ * drive order the first time the sinks are updated, so an update
+ * is a single pass over that list rather than a recursion through
+ * every sink. Adding a sink to any source in the train compiles
+ * it again at the next update.
  */
 class RotationSource
 {
 private:
     /// Rotation of the source
-    double mRotation;
+    double mRotation = 0;
 
     /// Speed of rotation
-    double mSpeed;
+    double mSpeed = 0;
+
+    /// A sink directly attached to this source
+    struct Link
+    {
+        /// The sink
+        std::shared_ptr<IRotationSink> sink;
+
+        /// Rotation and speed multiplier from this source to the sink
+        double ratio;
+    };
 
     /// Rotational Sinks attached to this source
-    std::vector<std::shared_ptr<IRotationSink>> mSinks;
+    std::vector<Link> mSinks;
+
+    /// Incremented each time a sink is added to this source
+    unsigned mRevision = 0;
+
+    /// A sink anywhere in the drive train
+    struct Stage
+    {
+        /// The sink
+        IRotationSink *sink;
 
+        /// Rotation and speed multiplier from this source to the sink
+        double ratio;
+    };
+
+    /// A source in the drive train when it was compiled
+    struct Compiled
+    {
+        /// The source
+        const RotationSource *source;
+
+        /// Revision of the source when the train was compiled
+        unsigned revision;
+    };
+
+    /// The compiled drive train in drive order
+    std::vector<Stage> mTrain;
+
+    /// Every source the compiled train was built from, empty until compiled
+    std::vector<Compiled> mCompiled;
+
+    bool IsCompiled() const;
+    bool CompileFrom(RotationSource *source, double ratio, std::vector<RotationSource *> &path,
+            std::unordered_set<IRotationSink *> &visited);
 
 public:
     ///Constructor
@@ -36,10 +89,17 @@ public:
     /// Assignment operator (disabled)
     void operator=(const RotationSource &) = delete;
 
-    void AddSink(std::shared_ptr<IRotationSink>  sink);
+    void AddSink(std::shared_ptr<IRotationSink>  sink, double ratio = 1.0);
     void UpdateSinks();
+    bool Compile();
 
     void SetRotation(double rotation, double speed);
+
+    /**
+     * Get the number of sinks in the compiled drive train
+     * @return Number of sinks, counting sinks driven by other sinks
+     */
+    size_t GetTrainSize() const { return mTrain.size(); }
 };
 
 #endif //CANADIANEXPERIENCE_MACHINELIB_ROTATIONSOURCE_H
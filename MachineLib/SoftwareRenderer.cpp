@@ -0,0 +1,728 @@
+/**
+ * @file SoftwareRenderer.cpp
+ * @author Thomas Toaz
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "SoftwareRenderer.h"
+#include "RenderImage.h"
+#include "BlendKernel.h"
+
+/// Largest distance from a curve to the lines it is drawn with, in device pixels
+const double FlattenTolerance = 0.25;
+
+/// Fewest sides of the polygons that round the joins and ends of lines
+const int MinRoundSides = 8;
+
+/// Most sides of the polygons that round the joins and ends of lines
+const int MaxRoundSides = 32;
+
+/**
+ * Grow measured bounds to include a rectangle
+ * @param measured Bounds to grow
+ * @param left Left pixel
+ * @param top Top pixel
+ * @param right Pixel after the right
+ * @param bottom Pixel after the bottom
+ */
+static void Include(SoftwareRenderer::Bounds &measured, int left, int top, int right, int bottom)
+{
+    if(measured.mLeft >= measured.mRight || measured.mTop >= measured.mBottom)
+    {
+        measured = SoftwareRenderer::Bounds{left, top, right, bottom};
+        return;
+    }
+
+    measured.mLeft = std::min(measured.mLeft, left);
+    measured.mTop = std::min(measured.mTop, top);
+    measured.mRight = std::max(measured.mRight, right);
+    measured.mBottom = std::max(measured.mBottom, bottom);
+}
+
+/**
+ * Draw a transformed rectangle of source pixels into a target.
+ *
+ * Each target pixel whose centre lands in the rectangle is mapped
+ * back through the inverse transform and sampled. Pixels within a
+ * pixel of the edge are faded by how far inside they are, so the
+ * edges are anti-aliased at any angle.
+ * @param target Image drawn into
+ * @param clip Pixels of the target that may be drawn
+ * @param measured Bounds to grow instead of drawing, or nullptr to draw
+ * @param span Buffer for a row of pixels
+ * @param matrix Transform from source pixels to target pixels
+ * @param width Source width in pixels
+ * @param height Source height in pixels
+ * @param sample Function that writes the premultiplied pixel at a
+ * source location, faded by an edge coverage from 0 to 256
+ */
+template<class Sample>
+static void Blit(RenderImage &target, const SoftwareRenderer::Bounds &clip, SoftwareRenderer::Bounds *measured,
+        std::vector<unsigned char> &span, const RenderMatrix &matrix, int width, int height, Sample sample)
+{
+    RenderMatrix inverse;
+    if(width <= 0 || height <= 0 || !matrix.Invert(inverse))
+    {
+        return;
+    }
+
+    // Device bounds of the rectangle, a pixel larger for the soft edge
+    double left = 1e30, top = 1e30, right = -1e30, bottom = -1e30;
+    for(int corner = 0; corner < 4; corner++)
+    {
+        double x, y;
+        matrix.Apply(corner & 1 ? width : 0, corner & 2 ? height : 0, x, y);
+        left = std::min(left, x);
+        right = std::max(right, x);
+        top = std::min(top, y);
+        bottom = std::max(bottom, y);
+    }
+
+    int x0 = std::max(clip.mLeft, int(std::floor(left)) - 1);
+    int x1 = std::min(clip.mRight, int(std::ceil(right)) + 1);
+    int y0 = std::max(clip.mTop, int(std::floor(top)) - 1);
+    int y1 = std::min(clip.mBottom, int(std::ceil(bottom)) + 1);
+    if(x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+
+    if(measured != nullptr)
+    {
+        Include(*measured, x0, y0, x1, y1);
+        return;
+    }
+
+    // Device pixels each source pixel covers, to turn distances into coverage
+    double scale = matrix.GetScale();
+
+    span.resize(size_t(x1 - x0) * 4);
+    for(int y = y0; y < y1; y++)
+    {
+        double u, v;
+        inverse.Apply(x0 + 0.5, y + 0.5, u, v);
+        for(int x = x0; x < x1; x++, u += inverse.mA, v += inverse.mB)
+        {
+            auto pixel = span.data() + size_t(x - x0) * 4;
+            double inside = std::min(std::min(u, width - u), std::min(v, height - v)) * scale + 0.5;
+            if(inside <= 0)
+            {
+                pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+                continue;
+            }
+
+            sample(u, v, inside >= 1 ? 256 : int(inside * 256), pixel);
+        }
+
+        BlendKernel::BlendPixels(target.GetRow(y) + size_t(x0) * 4, span.data(), x1 - x0);
+    }
+}
+
+/**
+ * Constructor
+ * @param target Image to draw into
+ * @param glyphs Glyphs to draw text from
+ */
+SoftwareRenderer::SoftwareRenderer(RenderImage &target, GlyphAtlas &glyphs) : mTarget(target), mGlyphs(glyphs)
+{
+    mClip = Bounds{0, 0, target.GetWidth(), target.GetHeight()};
+}
+
+/**
+ * Limit drawing to a rectangle of the target
+ * @param clip Pixels that may be drawn
+ */
+void SoftwareRenderer::SetClip(const Bounds &clip)
+{
+    mClip.mLeft = std::max(0, clip.mLeft);
+    mClip.mTop = std::max(0, clip.mTop);
+    mClip.mRight = std::min(mTarget.GetWidth(), clip.mRight);
+    mClip.mBottom = std::min(mTarget.GetHeight(), clip.mBottom);
+}
+
+/**
+ * Measure drawing instead of drawing it.
+ *
+ * Each drawing call adds the bounds of the pixels it would
+ * change inside the clip rectangle, empty if it would change
+ * none, so the position of the bounds is the number of the call.
+ * @param measured Receives the bounds, or nullptr to draw
+ */
+void SoftwareRenderer::SetMeasured(std::vector<Bounds> *measured)
+{
+    mMeasured = measured;
+}
+
+/**
+ * Draw only some of the drawing calls.
+ *
+ * Calls are numbered from 0 in the order they are made, as
+ * SetMeasured numbers them. The rest change only the state.
+ * @param drawn Numbers of the calls to draw in increasing order, or nullptr for all
+ */
+void SoftwareRenderer::SetDrawn(const std::vector<int> *drawn)
+{
+    mDrawn = drawn;
+    mNextDrawn = 0;
+}
+
+/**
+ * Count a drawing call and decide whether it is skipped
+ * @return true if the call is not drawn
+ */
+bool SoftwareRenderer::Skip()
+{
+    int call = mCalls++;
+    if(mMeasured != nullptr)
+    {
+        mMeasured->emplace_back();
+        return false;
+    }
+
+    if(mDrawn == nullptr)
+    {
+        return false;
+    }
+
+    while(mNextDrawn < mDrawn->size() && (*mDrawn)[mNextDrawn] < call)
+    {
+        mNextDrawn++;
+    }
+
+    return mNextDrawn == mDrawn->size() || (*mDrawn)[mNextDrawn] != call;
+}
+
+/**
+ * Save the current transform and attributes
+ */
+void SoftwareRenderer::PushState()
+{
+    mStates.push_back(mState);
+}
+
+/**
+ * Restore the transform and attributes saved by PushState
+ */
+void SoftwareRenderer::PopState()
+{
+    if(!mStates.empty())
+    {
+        mState = mStates.back();
+        mStates.pop_back();
+    }
+}
+
+/**
+ * Translate the coordinate system
+ * @param dx X distance
+ * @param dy Y distance
+ */
+void SoftwareRenderer::Translate(double dx, double dy)
+{
+    mState.mMatrix.Translate(dx, dy);
+}
+
+/**
+ * Scale the coordinate system
+ * @param xScale X scale
+ * @param yScale Y scale
+ */
+void SoftwareRenderer::Scale(double xScale, double yScale)
+{
+    mState.mMatrix.Scale(xScale, yScale);
+}
+
+/**
+ * Rotate the coordinate system
+ * @param angle Angle in radians
+ */
+void SoftwareRenderer::Rotate(double angle)
+{
+    mState.mMatrix.Rotate(angle);
+}
+
+/**
+ * Set the pen lines are drawn with
+ * @param colour Colour as RGBA
+ * @param width Width in user units
+ */
+void SoftwareRenderer::SetPen(unsigned int colour, double width)
+{
+    mState.mPenColour = colour;
+    mState.mPenWidth = width;
+}
+
+/**
+ * Set the brush shapes are filled with
+ * @param colour Colour as RGBA
+ */
+void SoftwareRenderer::SetBrush(unsigned int colour)
+{
+    mState.mBrushColour = colour;
+}
+
+/**
+ * Set the font text is drawn with
+ * @param height Height of a line of text in user units
+ * @param colour Colour as RGBA
+ */
+void SoftwareRenderer::SetFont(double height, unsigned int colour)
+{
+    mState.mFontHeight = height;
+    mState.mFontColour = colour;
+}
+
+/**
+ * Set whether scaled images are filtered
+ * @param smooth true for bilinear sampling, false for the nearest pixel
+ */
+void SoftwareRenderer::SetSmooth(bool smooth)
+{
+    mState.mSmooth = smooth;
+}
+
+/**
+ * Fill a path with the current brush
+ * @param path The path
+ */
+void SoftwareRenderer::FillPath(const RenderPath &path)
+{
+    if(Skip() || (mState.mBrushColour >> 24) == 0)
+    {
+        return;
+    }
+
+    std::vector<RenderPath::Polyline> polylines;
+    path.Flatten(mState.mMatrix, FlattenTolerance, polylines);
+    Fill(polylines, mState.mBrushColour);
+}
+
+/**
+ * Draw the lines of a path with the current pen.
+ *
+ * Each line becomes a rectangle as wide as the pen, and each
+ * point a polygon as round as the pen, all filled together. A
+ * pen thinner than a device pixel is drawn a pixel wide.
+ * @param path The path
+ */
+void SoftwareRenderer::StrokePath(const RenderPath &path)
+{
+    double scale = mState.mMatrix.GetScale();
+    if(Skip() || (mState.mPenColour >> 24) == 0 || scale == 0)
+    {
+        return;
+    }
+
+    std::vector<RenderPath::Polyline> lines;
+    path.Flatten(RenderMatrix(), FlattenTolerance / scale, lines);
+
+    double half = std::max(mState.mPenWidth, 1 / scale) / 2;
+    int sides = std::clamp(int(half * scale * 2), MinRoundSides, MaxRoundSides);
+
+    std::vector<RenderPath::Polyline> outline;
+    auto add = [this, &outline](std::initializer_list<RenderPath::Point> points) {
+        RenderPath::Polyline polyline;
+        double area = 0;
+        for(auto point : points)
+        {
+            RenderPath::Point device;
+            mState.mMatrix.Apply(point.mX, point.mY, device.mX, device.mY);
+            if(!polyline.mPoints.empty())
+            {
+                area += polyline.mPoints.back().mX * device.mY - device.mX * polyline.mPoints.back().mY;
+            }
+
+            polyline.mPoints.push_back(device);
+        }
+
+        // Every piece turns the same way, so overlaps do not cancel
+        area += polyline.mPoints.back().mX * polyline.mPoints.front().mY -
+                polyline.mPoints.front().mX * polyline.mPoints.back().mY;
+        if(area < 0)
+        {
+            std::reverse(polyline.mPoints.begin(), polyline.mPoints.end());
+        }
+
+        outline.push_back(polyline);
+    };
+
+    for(auto &line : lines)
+    {
+        auto points = line.mPoints;
+        if(line.mClosed && !points.empty())
+        {
+            points.push_back(points.front());
+        }
+
+        for(size_t i = 0; i < points.size(); i++)
+        {
+            auto a = points[i];
+
+            // Round join or end
+            RenderPath::Polyline round;
+            for(int side = 0; side < sides; side++)
+            {
+                double angle = side * 2 * M_PI / sides;
+                RenderPath::Point point{a.mX + half * std::cos(angle), a.mY + half * std::sin(angle)};
+                mState.mMatrix.Apply(point.mX, point.mY, point.mX, point.mY);
+                round.mPoints.push_back(point);
+            }
+
+            if(mState.mMatrix.mA * mState.mMatrix.mD - mState.mMatrix.mB * mState.mMatrix.mC < 0)
+            {
+                std::reverse(round.mPoints.begin(), round.mPoints.end());
+            }
+
+            outline.push_back(round);
+
+            if(i + 1 < points.size())
+            {
+                auto b = points[i + 1];
+                double length = std::hypot(b.mX - a.mX, b.mY - a.mY);
+                if(length > 0)
+                {
+                    double nx = (a.mY - b.mY) / length * half;
+                    double ny = (b.mX - a.mX) / length * half;
+                    add({{a.mX + nx, a.mY + ny}, {b.mX + nx, b.mY + ny}, {b.mX - nx, b.mY - ny}, {a.mX - nx, a.mY - ny}});
+                }
+            }
+        }
+    }
+
+    Fill(outline, mState.mPenColour);
+}
+
+/**
+ * Draw an image scaled to a rectangle
+ * @param image The image
+ * @param x Left
+ * @param y Top
+ * @param width Width
+ * @param height Height
+ */
+void SoftwareRenderer::DrawImage(const RenderImage &image, double x, double y, double width, double height)
+{
+    int imageWidth = image.GetWidth();
+    int imageHeight = image.GetHeight();
+    if(Skip() || imageWidth <= 0 || imageHeight <= 0 || width == 0 || height == 0)
+    {
+        return;
+    }
+
+    RenderMatrix matrix = mState.mMatrix;
+    matrix.Translate(x, y);
+    matrix.Scale(width / imageWidth, height / imageHeight);
+
+    bool smooth = mState.mSmooth;
+    Blit(mTarget, mClip, mMeasured != nullptr ? &mMeasured->back() : nullptr, mSpan, matrix, imageWidth, imageHeight,
+         [&image, imageWidth, imageHeight, smooth](double u, double v, int edge, unsigned char *pixel) {
+        if(!smooth)
+        {
+            auto source = image.GetRow(std::min(int(v), imageHeight - 1)) + size_t(std::min(int(u), imageWidth - 1)) * 4;
+            for(int c = 0; c < 4; c++)
+            {
+                pixel[c] = (unsigned char)((source[c] * edge) >> 8);
+            }
+            return;
+        }
+
+        double fu = u - 0.5, fv = v - 0.5;
+        int u0 = int(std::floor(fu)), v0 = int(std::floor(fv));
+        int wu = int((fu - u0) * 256), wv = int((fv - v0) * 256);
+        int ua = std::clamp(u0, 0, imageWidth - 1) * 4, ub = std::clamp(u0 + 1, 0, imageWidth - 1) * 4;
+        auto top = image.GetRow(std::clamp(v0, 0, imageHeight - 1));
+        auto bottom = image.GetRow(std::clamp(v0 + 1, 0, imageHeight - 1));
+        for(int c = 0; c < 4; c++)
+        {
+            int upper = top[ua + c] * (256 - wu) + top[ub + c] * wu;
+            int lower = bottom[ua + c] * (256 - wu) + bottom[ub + c] * wu;
+            int value = (upper * (256 - wv) + lower * wv + 32768) >> 16;
+            pixel[c] = (unsigned char)((value * edge) >> 8);
+        }
+    });
+}
+
+/**
+ * Get the pixel height glyphs are drawn at with the current font and transform
+ * @return Height in device pixels
+ */
+int SoftwareRenderer::GlyphHeight() const
+{
+    return std::clamp(int(std::lround(mState.mFontHeight * mState.mMatrix.GetScale())), 1, GlyphAtlas::MaxHeight);
+}
+
+/**
+ * Get how wide text is in the current font
+ * @param text The text
+ * @return Width in user units
+ */
+double SoftwareRenderer::GetTextWidth(const std::wstring &text)
+{
+    if(mState.mFontHeight <= 0)
+    {
+        return 0;
+    }
+
+    int height = GlyphHeight();
+    double width = 0;
+    for(auto code : text)
+    {
+        width += mGlyphs.Find(code, height).mAdvance;
+    }
+
+    return width * mState.mFontHeight / height;
+}
+
+/**
+ * Draw text in the current font.
+ *
+ * Glyphs are rasterized at the size they cover in device pixels,
+ * so text that is not rotated is drawn pixel for pixel.
+ * @param text The text
+ * @param x Left
+ * @param y Top
+ */
+void SoftwareRenderer::DrawText(const std::wstring &text, double x, double y)
+{
+    unsigned int colour = mState.mFontColour;
+    if(Skip() || mState.mFontHeight <= 0 || (colour >> 24) == 0)
+    {
+        return;
+    }
+
+    int height = GlyphHeight();
+    double units = mState.mFontHeight / height;
+    unsigned alpha = colour >> 24;
+    unsigned char premultiplied[4] = {BlendKernel::Multiply(colour & 0xff, alpha),
+                                      BlendKernel::Multiply((colour >> 8) & 0xff, alpha),
+                                      BlendKernel::Multiply((colour >> 16) & 0xff, alpha), (unsigned char)alpha};
+
+    for(auto code : text)
+    {
+        // Copied, since finding the next glyph may move this one
+        auto glyph = mGlyphs.Find(code, height);
+        if(glyph.mWidth > 0)
+        {
+            RenderMatrix matrix = mState.mMatrix;
+            matrix.Translate(x, y);
+            matrix.Scale(units, units);
+
+            auto page = mGlyphs.GetPage() + size_t(glyph.mY) * GlyphAtlas::PageSize + glyph.mX;
+            int width = glyph.mWidth, rows = glyph.mHeight;
+            Blit(mTarget, mClip, mMeasured != nullptr ? &mMeasured->back() : nullptr, mSpan, matrix, width, rows,
+                 [page, width, rows, &premultiplied](double u, double v, int edge, unsigned char *pixel) {
+                double fu = u - 0.5, fv = v - 0.5;
+                int u0 = int(std::floor(fu)), v0 = int(std::floor(fv));
+                int wu = int((fu - u0) * 256), wv = int((fv - v0) * 256);
+                int ua = std::clamp(u0, 0, width - 1), ub = std::clamp(u0 + 1, 0, width - 1);
+                auto top = page + size_t(std::clamp(v0, 0, rows - 1)) * GlyphAtlas::PageSize;
+                auto bottom = page + size_t(std::clamp(v0 + 1, 0, rows - 1)) * GlyphAtlas::PageSize;
+                int upper = top[ua] * (256 - wu) + top[ub] * wu;
+                int lower = bottom[ua] * (256 - wu) + bottom[ub] * wu;
+                int coverage = (((upper * (256 - wv) + lower * wv + 32768) >> 16) * edge) >> 8;
+                for(int c = 0; c < 4; c++)
+                {
+                    pixel[c] = BlendKernel::Multiply(premultiplied[c], coverage);
+                }
+            });
+        }
+
+        x += glyph.mAdvance * units;
+    }
+}
+
+/**
+ * Fill polygons in device coordinates with a colour.
+ *
+ * The area each edge covers is added into a cell for each pixel
+ * of the bounds, and the running sum along a row is the coverage
+ * of each pixel. Overlapping polygons that turn the same way are
+ * filled once.
+ * @param polylines Polygons in device coordinates, each taken as closed
+ * @param colour Colour as RGBA
+ */
+void SoftwareRenderer::Fill(const std::vector<RenderPath::Polyline> &polylines, unsigned int colour)
+{
+    double minX = 1e30, minY = 1e30, maxX = -1e30, maxY = -1e30;
+    for(auto &polyline : polylines)
+    {
+        for(auto &point : polyline.mPoints)
+        {
+            minX = std::min(minX, point.mX);
+            maxX = std::max(maxX, point.mX);
+            minY = std::min(minY, point.mY);
+            maxY = std::max(maxY, point.mY);
+        }
+    }
+
+    int left = std::max(mClip.mLeft, int(std::floor(minX)));
+    int right = std::min(mClip.mRight, int(std::ceil(maxX)));
+    int top = std::max(mClip.mTop, int(std::floor(minY)));
+    int bottom = std::min(mClip.mBottom, int(std::ceil(maxY)));
+    if(left >= right || top >= bottom)
+    {
+        return;
+    }
+
+    if(mMeasured != nullptr)
+    {
+        Include(mMeasured->back(), left, top, right, bottom);
+        return;
+    }
+
+    int width = right - left;
+    int height = bottom - top;
+    mCells.assign(size_t(width + 2) * height, 0);
+
+    for(auto &polyline : polylines)
+    {
+        auto &points = polyline.mPoints;
+        for(size_t i = 0; i < points.size(); i++)
+        {
+            auto a = points[i];
+            auto b = points[(i + 1) % points.size()];
+            a.mX -= left;
+            a.mY -= top;
+            b.mX -= left;
+            b.mY -= top;
+
+            // Split where the edge leaves the bounds at the sides. A
+            // piece beyond a side covers the same rows at that side.
+            double splits[4] = {0, 1, 1, 1};
+            int count = 1;
+            for(double side : {0.0, double(width)})
+            {
+                if((a.mX < side) != (b.mX < side))
+                {
+                    splits[count++] = (side - a.mX) / (b.mX - a.mX);
+                }
+            }
+
+            if(count == 3 && splits[1] > splits[2])
+            {
+                std::swap(splits[1], splits[2]);
+            }
+
+            auto at = [a, b, width](double t) {
+                return RenderPath::Point{std::clamp(a.mX + (b.mX - a.mX) * t, 0.0, double(width)),
+                                         a.mY + (b.mY - a.mY) * t};
+            };
+
+            for(int s = 0; s < count; s++)
+            {
+                AddEdge(at(splits[s]), at(splits[s + 1]), width, height);
+            }
+        }
+    }
+
+    mCoverage.resize(width);
+    for(int y = 0; y < height; y++)
+    {
+        auto cells = mCells.data() + size_t(y) * (width + 2);
+        float sum = 0;
+        for(int x = 0; x < width; x++)
+        {
+            sum += cells[x];
+            mCoverage[x] = (unsigned char)(std::min(1.0f, std::abs(sum)) * 255 + 0.5f);
+        }
+
+        BlendKernel::BlendSolid(mTarget.GetRow(top + y) + size_t(left) * 4, mCoverage.data(), width, colour);
+    }
+}
+
+/**
+ * Add the area an edge covers to the cells.
+ *
+ * Each row the edge crosses gets the signed area to the right of
+ * the edge in the pixels it passes through, and the rest of its
+ * height in the pixel after, so summing along the row gives the
+ * coverage.
+ * @param p0 Start of the edge, X from 0 to width
+ * @param p1 End of the edge, X from 0 to width
+ * @param width Width of the cells in pixels
+ * @param height Height of the cells in pixels
+ */
+void SoftwareRenderer::AddEdge(RenderPath::Point p0, RenderPath::Point p1, int width, int height)
+{
+    if(p0.mY == p1.mY)
+    {
+        return;
+    }
+
+    double direction = 1;
+    if(p0.mY > p1.mY)
+    {
+        std::swap(p0, p1);
+        direction = -1;
+    }
+
+    if(p1.mY <= 0 || p0.mY >= height)
+    {
+        return;
+    }
+
+    // Rounding may take X a little past the cells, so it is clamped
+    double dxdy = (p1.mX - p0.mX) / (p1.mY - p0.mY);
+    double x = p0.mX;
+    double y0 = p0.mY;
+    if(y0 < 0)
+    {
+        x = std::clamp(x - y0 * dxdy, 0.0, double(width));
+        y0 = 0;
+    }
+
+    double y1 = std::min(p1.mY, double(height));
+    int stride = width + 2;
+    for(int y = int(y0); y < int(std::ceil(y1)); y++)
+    {
+        double dy = std::min(double(y + 1), y1) - std::max(double(y), y0);
+        double next = std::clamp(x + dxdy * dy, 0.0, double(width));
+        double d = dy * direction;
+        double xa = std::min(x, next);
+        double xb = std::max(x, next);
+        auto row = mCells.data() + size_t(y) * stride;
+
+        double xaFloor = std::floor(xa);
+        int xai = int(xaFloor);
+        double xbCeil = std::ceil(xb);
+        int xbi = int(xbCeil);
+        if(xbi <= xai + 1)
+        {
+            // The edge stays in one pixel of this row
+            double middle = 0.5 * (x + next) - xaFloor;
+            row[xai] += float(d - d * middle);
+            row[xai + 1] += float(d * middle);
+        }
+        else
+        {
+            double s = 1 / (xb - xa);
+            double xaFraction = xa - xaFloor;
+            double first = 0.5 * s * (1 - xaFraction) * (1 - xaFraction);
+            double xbFraction = xb - xbCeil + 1;
+            double last = 0.5 * s * xbFraction * xbFraction;
+            row[xai] += float(d * first);
+            if(xbi == xai + 2)
+            {
+                row[xai + 1] += float(d * (1 - first - last));
+            }
+            else
+            {
+                double second = s * (1.5 - xaFraction);
+                row[xai + 1] += float(d * (second - first));
+                for(int xi = xai + 2; xi < xbi - 1; xi++)
+                {
+                    row[xi] += float(d * s);
+                }
+
+                double before = second + (xbi - xai - 3) * s;
+                row[xbi - 1] += float(d * (1 - before - last));
+            }
+
+            row[xbi] += float(d * last);
+        }
+
+        x = next;
+    }
+}
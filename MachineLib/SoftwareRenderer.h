@@ -0,0 +1,158 @@
+/**
+ * @file SoftwareRenderer.h
+ * @author Thomas Toaz
+ *
+ * Renderer that rasterizes into a RenderImage without any graphics system.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_SOFTWARERENDERER_H
+#define CANADIANEXPERIENCE_MACHINELIB_SOFTWARERENDERER_H
+
+#include <vector>
+
+#include "Renderer.h"
+#include "RenderPath.h"
+#include "GlyphAtlas.h"
+
+class RenderImage;
+
+/**
+ * Renderer that rasterizes into a RenderImage without any graphics system.
+ *
+ * Paths are filled with anti-aliasing by accumulating the exact
+ * area each edge covers in each pixel. Lines are drawn as filled
+ * outlines with round joins and ends. Images are drawn through
+ * the inverse transform with bilinear sampling and soft edges,
+ * and text is drawn the same way from the glyphs in a GlyphAtlas.
+ * Every span is blended with BlendKernel.
+ *
+ * As with a wxGraphicsContext, there is no pen, brush or font
+ * until one is set.
+ *
+ * Drawing can be limited to a clip rectangle and to chosen drawing
+ * calls, and the renderer can measure the pixels each call covers
+ * instead of drawing, so a frame can be drawn a tile at a time.
+ */
+class SoftwareRenderer : public Renderer
+{
+public:
+    /// Rectangle of device pixels, right and bottom excluded
+    struct Bounds
+    {
+        /// Left pixel
+        int mLeft = 0;
+
+        /// Top pixel
+        int mTop = 0;
+
+        /// Pixel after the right
+        int mRight = 0;
+
+        /// Pixel after the bottom
+        int mBottom = 0;
+    };
+
+private:
+    /// Transform and attributes saved by PushState
+    struct State
+    {
+        /// Transform from user to device coordinates
+        RenderMatrix mMatrix;
+
+        /// Pen colour as RGBA
+        unsigned int mPenColour = 0;
+
+        /// Pen width in user units
+        double mPenWidth = 1;
+
+        /// Brush colour as RGBA
+        unsigned int mBrushColour = 0;
+
+        /// Height of a line of text in user units
+        double mFontHeight = 0;
+
+        /// Text colour as RGBA
+        unsigned int mFontColour = 0;
+
+        /// Are scaled images filtered?
+        bool mSmooth = true;
+    };
+
+    /// Image drawn into
+    RenderImage &mTarget;
+
+    /// Glyphs text is drawn from
+    GlyphAtlas &mGlyphs;
+
+    /// The current transform and attributes
+    State mState;
+
+    /// States saved by PushState
+    std::vector<State> mStates;
+
+    /// Pixels that may be drawn
+    Bounds mClip;
+
+    /// Receives the bounds of each drawing call instead of drawing, or nullptr
+    std::vector<Bounds> *mMeasured = nullptr;
+
+    /// Drawing calls that are drawn, in order, or nullptr for all
+    const std::vector<int> *mDrawn = nullptr;
+
+    /// Position in mDrawn of the next call that is drawn
+    size_t mNextDrawn = 0;
+
+    /// Number of drawing calls so far
+    int mCalls = 0;
+
+    /// Area covered in each cell of the shape being filled
+    std::vector<float> mCells;
+
+    /// Coverage of a row of the shape being filled
+    std::vector<unsigned char> mCoverage;
+
+    /// Pixels of a row of the image being drawn
+    std::vector<unsigned char> mSpan;
+
+    void Fill(const std::vector<RenderPath::Polyline> &polylines, unsigned int colour);
+    void AddEdge(RenderPath::Point p0, RenderPath::Point p1, int width, int height);
+    int GlyphHeight() const;
+    bool Skip();
+
+public:
+    explicit SoftwareRenderer(RenderImage &target, GlyphAtlas &glyphs = GlyphAtlas::Shared());
+
+    /// Copy constructor (disabled)
+    SoftwareRenderer(const SoftwareRenderer &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const SoftwareRenderer &) = delete;
+
+    void SetClip(const Bounds &clip);
+    void SetMeasured(std::vector<Bounds> *measured);
+    void SetDrawn(const std::vector<int> *drawn);
+
+    void PushState() override;
+    void PopState() override;
+    void Translate(double dx, double dy) override;
+    void Scale(double xScale, double yScale) override;
+    void Rotate(double angle) override;
+
+    /**
+     * Get the current transform
+     * @return Transform from user to device coordinates
+     */
+    const RenderMatrix &GetTransform() const override { return mState.mMatrix; }
+
+    void SetPen(unsigned int colour, double width) override;
+    void SetBrush(unsigned int colour) override;
+    void SetFont(double height, unsigned int colour) override;
+    void SetSmooth(bool smooth) override;
+    void FillPath(const RenderPath &path) override;
+    void StrokePath(const RenderPath &path) override;
+    void DrawImage(const RenderImage &image, double x, double y, double width, double height) override;
+    double GetTextWidth(const std::wstring &text) override;
+    void DrawText(const std::wstring &text, double x, double y) override;
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_SOFTWARERENDERER_H
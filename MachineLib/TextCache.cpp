@@ -0,0 +1,227 @@
+/**
+ * @file TextCache.cpp
+ * @author Thomas Toaz
+ */
+
+#include "pch.h"
+
+#include <cmath>
+
+#include "TextCache.h"
+
+/// Steps per device pixel that scales are rounded to, so a
+/// scale that drifts a little still finds the same run
+const double ScaleSteps = 8;
+
+/// Smallest scale runs are drawn at
+const double MinScale = 1 / ScaleSteps;
+
+/**
+ * Constructor
+ * @param capacity Number of runs kept
+ */
+TextCache::TextCache(size_t capacity) : mCapacity(std::max(size_t(1), capacity))
+{
+}
+
+/**
+ * Get the cache shared by all drawing code
+ * @return The shared cache
+ */
+TextCache &TextCache::Shared()
+{
+    static TextCache cache;
+    return cache;
+}
+
+/**
+ * Draw text into a new run.
+ *
+ * The text is drawn white on black with the font scaled to the
+ * device scale, and the brightest channel of each pixel becomes
+ * its alpha, so anti-aliased edges stay smooth.
+ * @param font Font
+ * @param text The text
+ * @param colour Text colour
+ * @param scale Device pixels per user unit
+ * @return The run
+ */
+std::shared_ptr<TextCache::Run> TextCache::MakeRun(const wxFont &font, const std::wstring &text,
+        const wxColour &colour, double scale)
+{
+    auto run = std::make_shared<Run>();
+    run->mScale = scale;
+
+    auto scaled = font.Scaled(float(scale));
+
+    // Measure with the same kind of context the text is drawn with
+    double width = 0, height = 0;
+    {
+        wxImage measure(1, 1);
+        auto graphics = std::unique_ptr<wxGraphicsContext>(wxGraphicsContext::Create(measure));
+        graphics->SetFont(scaled, *wxWHITE);
+        graphics->GetTextExtent(text, &width, &height);
+    }
+
+    run->mWidth = width / scale;
+    run->mHeight = height / scale;
+
+    int pixelWidth = std::max(1, int(std::ceil(width)));
+    int pixelHeight = std::max(1, int(std::ceil(height)));
+    wxImage image(pixelWidth, pixelHeight);
+    {
+        auto graphics = std::unique_ptr<wxGraphicsContext>(wxGraphicsContext::Create(image));
+        graphics->SetFont(scaled, *wxWHITE);
+        graphics->DrawText(text, 0, 0);
+    }
+
+    image.InitAlpha();
+    auto rgb = image.GetData();
+    auto alpha = image.GetAlpha();
+    for(int i = 0; i < pixelWidth * pixelHeight; i++, rgb += 3)
+    {
+        int coverage = std::max(std::max(rgb[0], rgb[1]), rgb[2]);
+        alpha[i] = (unsigned char)((coverage * colour.Alpha() + 127) / 255);
+        rgb[0] = colour.Red();
+        rgb[1] = colour.Green();
+        rgb[2] = colour.Blue();
+    }
+
+    run->mImage = image;
+    return run;
+}
+
+/**
+ * Find the run for text, drawing it if it is not cached.
+ *
+ * A found run becomes the most recently used.
+ * @param font Font
+ * @param text The text
+ * @param colour Text colour
+ * @param scale Device pixels per user unit the text is drawn at
+ * @return The run
+ */
+std::shared_ptr<TextCache::Run> TextCache::Find(const wxFont &font, const std::wstring &text,
+        const wxColour &colour, double scale)
+{
+    scale = std::max(MinScale, std::round(scale * ScaleSteps) / ScaleSteps);
+
+    auto key = font.GetNativeFontInfoDesc().ToStdWstring() + L'\n' + std::to_wstring(colour.GetRGBA()) + L'\n' +
+            std::to_wstring(int(scale * ScaleSteps)) + L'\n' + text;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto found = mRuns.find(key);
+        if(found != mRuns.end())
+        {
+            mOrder.splice(mOrder.begin(), mOrder, found->second.mOrder);
+            return found->second.mRun;
+        }
+    }
+
+    // Drawn without the lock, since it may take a while
+    auto run = MakeRun(font, text, colour, scale);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto found = mRuns.find(key);
+    if(found != mRuns.end())
+    {
+        // Another thread drew it first
+        mOrder.splice(mOrder.begin(), mOrder, found->second.mOrder);
+        return found->second.mRun;
+    }
+
+    mOrder.push_front(key);
+    mRuns[key] = Entry{run, mOrder.begin()};
+    while(mRuns.size() > mCapacity)
+    {
+        mRuns.erase(mOrder.back());
+        mOrder.pop_back();
+    }
+
+    return run;
+}
+
+/**
+ * Draw text from its run.
+ *
+ * The run is drawn at the scale of the context's transform, so
+ * the text is as sharp as if it were drawn directly.
+ * @param graphics Graphics context to draw on
+ * @param font Font
+ * @param text The text
+ * @param colour Text colour
+ * @param x Left of the text, before alignment
+ * @param y Top of the text
+ * @param align Fraction of the text width x is from the left, 0.5 to center
+ */
+void TextCache::Draw(std::shared_ptr<wxGraphicsContext> graphics, const wxFont &font, const std::wstring &text,
+        const wxColour &colour, double x, double y, double align)
+{
+    if(text.empty() || !font.IsOk())
+    {
+        return;
+    }
+
+    double a, b, c, d, tx, ty;
+    graphics->GetTransform().Get(&a, &b, &c, &d, &tx, &ty);
+    auto run = Find(font, text, colour, std::sqrt(std::abs(a * d - b * c)));
+
+    wxGraphicsBitmap bitmap;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto renderer = graphics->GetRenderer();
+        for(auto &made : run->mBitmaps)
+        {
+            if(made.first == renderer)
+            {
+                bitmap = made.second;
+                break;
+            }
+        }
+
+        if(bitmap.IsNull())
+        {
+            bitmap = graphics->CreateBitmapFromImage(run->mImage);
+            run->mBitmaps.emplace_back(renderer, bitmap);
+        }
+    }
+
+    graphics->DrawBitmap(bitmap, x - run->mWidth * align, y,
+            run->mImage.GetWidth() / run->mScale, run->mImage.GetHeight() / run->mScale);
+}
+
+/**
+ * Set how many runs are kept, dropping the least recently used
+ * @param capacity Number of runs
+ */
+void TextCache::SetCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCapacity = std::max(size_t(1), capacity);
+    while(mRuns.size() > mCapacity)
+    {
+        mRuns.erase(mOrder.back());
+        mOrder.pop_back();
+    }
+}
+
+/**
+ * Remove every run
+ */
+void TextCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRuns.clear();
+    mOrder.clear();
+}
+
+/**
+ * Get the number of runs in the cache
+ * @return Number of runs
+ */
+size_t TextCache::GetCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mRuns.size();
+}
@@ -0,0 +1,109 @@
+/**
+ * @file TextCache.h
+ * @author Thomas Toaz
+ *
+ * Least recently used cache of text drawn into bitmaps.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_TEXTCACHE_H
+#define CANADIANEXPERIENCE_MACHINELIB_TEXTCACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Least recently used cache of text drawn into bitmaps.
+ *
+ * Drawing text in a graphics context lays out and rasterizes the
+ * glyphs every time, which is slow for labels that are drawn on
+ * every frame but seldom change. Here a string is drawn once into
+ * a bitmap for its font, colour and device scale, a run of glyphs,
+ * and after that drawing it only draws the bitmap.
+ *
+ * Runs are kept for the most recently drawn strings, up to the
+ * capacity. Lookups may come from any thread. A graphics bitmap
+ * belongs to the renderer that created it, so each run keeps one
+ * for every renderer it has been drawn with.
+ */
+class TextCache
+{
+public:
+    /// Default number of runs kept
+    static const size_t DefaultCapacity = 256;
+
+    /// Text drawn into a bitmap
+    struct Run
+    {
+        /// The glyphs in the text colour, with alpha
+        wxImage mImage;
+
+        /// Graphics bitmaps of the image, one for each renderer it was drawn with
+        std::vector<std::pair<wxGraphicsRenderer *, wxGraphicsBitmap>> mBitmaps;
+
+        /// Device pixels per user unit the run was drawn at
+        double mScale = 1;
+
+        /// Width of the text in user units
+        double mWidth = 0;
+
+        /// Height of the text in user units
+        double mHeight = 0;
+    };
+
+private:
+    /// A cached run
+    struct Entry
+    {
+        /// The run
+        std::shared_ptr<Run> mRun;
+
+        /// Position of this run in mOrder
+        std::list<std::wstring>::iterator mOrder;
+    };
+
+    /// Runs by font, colour, scale and string
+    std::unordered_map<std::wstring, Entry> mRuns;
+
+    /// Keys of the runs, most recently used first
+    std::list<std::wstring> mOrder;
+
+    /// Number of runs kept
+    size_t mCapacity;
+
+    /// Protects everything above
+    mutable std::mutex mMutex;
+
+    static std::shared_ptr<Run> MakeRun(const wxFont &font, const std::wstring &text, const wxColour &colour, double scale);
+
+public:
+    explicit TextCache(size_t capacity = DefaultCapacity);
+
+    /// Copy constructor (disabled)
+    TextCache(const TextCache &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const TextCache &) = delete;
+
+    static TextCache &Shared();
+
+    std::shared_ptr<Run> Find(const wxFont &font, const std::wstring &text, const wxColour &colour, double scale = 1);
+    void Draw(std::shared_ptr<wxGraphicsContext> graphics, const wxFont &font, const std::wstring &text,
+            const wxColour &colour, double x, double y, double align = 0);
+    void SetCapacity(size_t capacity);
+    void Clear();
+
+    /**
+     * Get the number of runs kept
+     * @return Number of runs
+     */
+    size_t GetCapacity() const { return mCapacity; }
+
+    size_t GetCount() const;
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_TEXTCACHE_H
@@ -0,0 +1,106 @@
+/**
+ * @file TileRenderer.cpp
+ * @author Thomas Toaz
+ */
+
+#include <algorithm>
+#include <atomic>
+
+#include "TileRenderer.h"
+#include "SoftwareRenderer.h"
+#include "RenderImage.h"
+
+/**
+ * Constructor
+ * @param numThreads Number of threads tiles are drawn on
+ * @param tileSize Width and height of a tile in pixels
+ */
+TileRenderer::TileRenderer(unsigned numThreads, int tileSize) :
+    mNumThreads(std::max(1u, numThreads)), mTileSize(std::max(1, tileSize))
+{
+    for(unsigned i = 0; i < mNumThreads; i++)
+    {
+        mGlyphs.push_back(std::make_unique<GlyphAtlas>());
+    }
+}
+
+/**
+ * Draw a frame into an image.
+ *
+ * The calling thread draws tiles too, so one thread draws the
+ * whole frame with no other threads started.
+ * @param image Image to draw into
+ * @param draw Function that draws the frame
+ */
+void TileRenderer::Render(RenderImage &image, const Draw &draw)
+{
+    int columns = (image.GetWidth() + mTileSize - 1) / mTileSize;
+    int rows = (image.GetHeight() + mTileSize - 1) / mTileSize;
+    if(columns <= 0 || rows <= 0)
+    {
+        return;
+    }
+
+    // Measure each drawing call and put it in the bins it touches
+    std::vector<SoftwareRenderer::Bounds> measured;
+    {
+        SoftwareRenderer measure(image, *mGlyphs[0]);
+        measure.SetMeasured(&measured);
+        draw(measure);
+    }
+
+    std::vector<std::vector<int>> bins(size_t(columns) * rows);
+    for(int call = 0; call < int(measured.size()); call++)
+    {
+        auto &bounds = measured[call];
+        if(bounds.mLeft >= bounds.mRight || bounds.mTop >= bounds.mBottom)
+        {
+            continue;
+        }
+
+        for(int row = bounds.mTop / mTileSize; row <= (bounds.mBottom - 1) / mTileSize; row++)
+        {
+            for(int column = bounds.mLeft / mTileSize; column <= (bounds.mRight - 1) / mTileSize; column++)
+            {
+                bins[size_t(row) * columns + column].push_back(call);
+            }
+        }
+    }
+
+    std::vector<int> tiles;
+    for(int tile = 0; tile < int(bins.size()); tile++)
+    {
+        if(!bins[tile].empty())
+        {
+            tiles.push_back(tile);
+        }
+    }
+
+    std::atomic<size_t> next{0};
+    auto work = [&](GlyphAtlas &glyphs) {
+        for(auto i = next++; i < tiles.size(); i = next++)
+        {
+            int tile = tiles[i];
+            int left = tile % columns * mTileSize;
+            int top = tile / columns * mTileSize;
+
+            SoftwareRenderer renderer(image, glyphs);
+            renderer.SetClip(SoftwareRenderer::Bounds{left, top, left + mTileSize, top + mTileSize});
+            renderer.SetDrawn(&bins[tile]);
+            draw(renderer);
+        }
+    };
+
+    auto numThreads = std::min(size_t(mNumThreads), tiles.size());
+    std::vector<std::thread> threads;
+    for(size_t i = 1; i < numThreads; i++)
+    {
+        threads.emplace_back(work, std::ref(*mGlyphs[i]));
+    }
+
+    work(*mGlyphs[0]);
+    for(auto &thread : threads)
+    {
+        thread.join();
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * @file TileRenderer.h
+ * @author Thomas Toaz
+ *
+ * Draws a frame with software renderers, a tile at a time on several threads.
+ */
+
+#ifndef CANADIANEXPERIENCE_MACHINELIB_TILERENDERER_H
+#define CANADIANEXPERIENCE_MACHINELIB_TILERENDERER_H
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "GlyphAtlas.h"
+
+class Renderer;
+class RenderImage;
+
+/**
+ * Draws a frame with software renderers, a tile at a time on several threads.
+ *
+ * The drawing is first measured once, which gives the pixels each
+ * drawing call covers, and each call is put in the bin of every
+ * tile it touches. The tiles are then drawn on the threads, each
+ * with its own renderer clipped to the tile that draws only the
+ * calls in its bin. Tiles do not share pixels, so they are drawn
+ * straight into the image with no stitching pass, and the image is
+ * the same as one drawn by a single renderer.
+ *
+ * Each thread has its own glyph atlas, since an atlas may only be
+ * used by one thread at a time.
+ */
+class TileRenderer
+{
+public:
+    /// Default width and height of a tile in pixels
+    static const int DefaultTileSize = 256;
+
+    /**
+     * Function that draws the frame.
+     *
+     * It is called once to measure and once for each tile, and
+     * must make the same calls each time. It may be called on
+     * several threads at once.
+     */
+    typedef std::function<void(Renderer &renderer)> Draw;
+
+private:
+    /// Number of threads tiles are drawn on
+    unsigned mNumThreads;
+
+    /// Width and height of a tile in pixels
+    int mTileSize;
+
+    /// Glyph atlas for each thread
+    std::vector<std::unique_ptr<GlyphAtlas>> mGlyphs;
+
+public:
+    explicit TileRenderer(unsigned numThreads = std::thread::hardware_concurrency(), int tileSize = DefaultTileSize);
+
+    /// Copy constructor (disabled)
+    TileRenderer(const TileRenderer &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const TileRenderer &) = delete;
+
+    void Render(RenderImage &image, const Draw &draw);
+
+    /**
+     * Get the number of threads tiles are drawn on
+     * @return Number of threads
+     */
+    unsigned GetNumThreads() const { return mNumThreads; }
+
+    /**
+     * Get the width and height of a tile
+     * @return Tile size in pixels
+     */
+    int GetTileSize() const { return mTileSize; }
+};
+
+#endif //CANADIANEXPERIENCE_MACHINELIB_TILERENDERER_H
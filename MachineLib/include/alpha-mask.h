@@ -0,0 +1,14 @@
+/**
+ * @file alpha-mask.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the opacity mask of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_ALPHA_MASK_H
+#define MACHINELIB_ALPHA_MASK_H
+
+#include "../AlphaMask.h"
+
+#endif //MACHINELIB_ALPHA_MASK_H
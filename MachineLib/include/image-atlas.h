@@ -0,0 +1,14 @@
+/**
+ * @file image-atlas.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the shared image atlas of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_IMAGE_ATLAS_H
+#define MACHINELIB_IMAGE_ATLAS_H
+
+#include "../ImageAtlas.h"
+
+#endif //MACHINELIB_IMAGE_ATLAS_H
@@ -0,0 +1,14 @@
+/**
+ * @file image-memory.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the record of image memory of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_IMAGE_MEMORY_H
+#define MACHINELIB_IMAGE_MEMORY_H
+
+#include "../ImageMemory.h"
+
+#endif //MACHINELIB_IMAGE_MEMORY_H
@@ -0,0 +1,14 @@
+/**
+ * @file machine-system-actual.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the actual machine system of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_MACHINE_SYSTEM_ACTUAL_H
+#define MACHINELIB_MACHINE_SYSTEM_ACTUAL_H
+
+#include "../MachineSystemActual.h"
+
+#endif //MACHINELIB_MACHINE_SYSTEM_ACTUAL_H
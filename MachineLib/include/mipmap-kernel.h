@@ -0,0 +1,14 @@
+/**
+ * @file mipmap-kernel.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the mipmap kernels of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_MIPMAP_KERNEL_H
+#define MACHINELIB_MIPMAP_KERNEL_H
+
+#include "../MipmapKernel.h"
+
+#endif //MACHINELIB_MIPMAP_KERNEL_H
@@ -0,0 +1,14 @@
+/**
+ * @file render-image.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the render image of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_RENDER_IMAGE_H
+#define MACHINELIB_RENDER_IMAGE_H
+
+#include "../RenderImage.h"
+
+#endif //MACHINELIB_RENDER_IMAGE_H
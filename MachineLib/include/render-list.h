@@ -0,0 +1,14 @@
+/**
+ * @file render-list.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the render list of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_RENDER_LIST_H
+#define MACHINELIB_RENDER_LIST_H
+
+#include "../RenderList.h"
+
+#endif //MACHINELIB_RENDER_LIST_H
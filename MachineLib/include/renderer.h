@@ -0,0 +1,14 @@
+/**
+ * @file renderer.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the renderer interface of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_RENDERER_H
+#define MACHINELIB_RENDERER_H
+
+#include "../Renderer.h"
+
+#endif //MACHINELIB_RENDERER_H
@@ -0,0 +1,14 @@
+/**
+ * @file software-renderer.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the software renderer of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_SOFTWARE_RENDERER_H
+#define MACHINELIB_SOFTWARE_RENDERER_H
+
+#include "../SoftwareRenderer.h"
+
+#endif //MACHINELIB_SOFTWARE_RENDERER_H
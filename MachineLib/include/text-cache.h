@@ -0,0 +1,14 @@
+/**
+ * @file text-cache.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the text cache of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_TEXT_CACHE_H
+#define MACHINELIB_TEXT_CACHE_H
+
+#include "../TextCache.h"
+
+#endif //MACHINELIB_TEXT_CACHE_H
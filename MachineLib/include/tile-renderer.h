@@ -0,0 +1,14 @@
+/**
+ * @file tile-renderer.h
+ * @author Thomas Toaz
+ *
+ * Header that makes the tile renderer of the
+ * machines library available to the application.
+ */
+
+#ifndef MACHINELIB_TILE_RENDERER_H
+#define MACHINELIB_TILE_RENDERER_H
+
+#include "../TileRenderer.h"
+
+#endif //MACHINELIB_TILE_RENDERER_H
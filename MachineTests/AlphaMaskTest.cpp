@@ -0,0 +1,32 @@
+/**
+ * @file AlphaMaskTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include "gtest/gtest.h"
+
+#include <AlphaMask.h>
+
+TEST(AlphaMaskTest, IsOpaque)
+{
+    // 10x2 so a row spans two bytes of bits
+    unsigned char alpha[20] = {};
+    alpha[0] = 0x80;
+    alpha[3] = 0x7f;
+    alpha[9] = 255;
+    alpha[12] = 200;
+
+    AlphaMask mask(10, 2, alpha);
+    ASSERT_EQ(4u, mask.GetBytes());
+    ASSERT_TRUE(mask.IsOpaque(0, 0));
+    ASSERT_FALSE(mask.IsOpaque(3, 0));
+    ASSERT_TRUE(mask.IsOpaque(9, 0));
+    ASSERT_TRUE(mask.IsOpaque(2, 1));
+    ASSERT_FALSE(mask.IsOpaque(1, 1));
+    ASSERT_FALSE(mask.IsOpaque(10, 0));
+    ASSERT_FALSE(mask.IsOpaque(0, -1));
+
+    // No alpha channel is opaque everywhere
+    AlphaMask opaque(10, 2, nullptr);
+    ASSERT_TRUE(opaque.IsOpaque(9, 1));
+}
@@ -0,0 +1,38 @@
+/**
+ * @file BlendKernelTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include "gtest/gtest.h"
+
+#include <BlendKernel.h>
+
+#include <cstring>
+
+TEST(BlendKernelTest, BlendSolid)
+{
+    // 16 pixels, so both the vector path and the scalar tail run
+    unsigned char whole[64];
+    unsigned char pieces[64];
+    unsigned char coverage[16];
+    for (int i = 0; i < 64; i++)
+    {
+        whole[i] = pieces[i] = (unsigned char)(i * 37);
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        coverage[i] = (unsigned char)(i * 17);
+    }
+
+    // Blending a span in pieces gives the same pixels as all at once
+    BlendKernel::BlendSolid(whole, coverage, 16, 0x80204080);
+    BlendKernel::BlendSolid(pieces, coverage, 3, 0x80204080);
+    BlendKernel::BlendSolid(pieces + 12, coverage + 3, 13, 0x80204080);
+    ASSERT_EQ(0, memcmp(whole, pieces, sizeof(whole)));
+
+    ASSERT_EQ(0, BlendKernel::Multiply(0, 255));
+    ASSERT_EQ(255, BlendKernel::Multiply(255, 255));
+    ASSERT_EQ(128, BlendKernel::Multiply(128, 255));
+    ASSERT_EQ(64, BlendKernel::Multiply(128, 128));
+}
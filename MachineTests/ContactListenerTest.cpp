@@ -0,0 +1,155 @@
+/**
+ * @file ContactListenerTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include "gtest/gtest.h"
+
+#include <ContactListener.h>
+
+#include <b2_body.h>
+#include <b2_circle_shape.h>
+#include <b2_contact.h>
+#include <b2_polygon_shape.h>
+#include <b2_world.h>
+
+/// Listener that counts what it was told
+class CountingListener : public b2ContactListener
+{
+public:
+    /// Number of begin contact calls
+    int mBegins = 0;
+
+    /// Number of pre-solve calls
+    int mPreSolves = 0;
+
+    void BeginContact(b2Contact *contact) override { mBegins++; }
+    void PreSolve(b2Contact *contact, const b2Manifold *oldManifold) override { mPreSolves++; }
+};
+
+/// A ball above a floor, with a listener on the ball
+class FallingBall
+{
+public:
+    /// The physics world
+    b2World mWorld{b2Vec2(0.0f, -9.8f)};
+
+    /// The contact listener installed in the world
+    ContactListener mContacts;
+
+    /// Listener installed for the ball
+    CountingListener mBallListener;
+
+    /// The falling ball
+    b2Body *mBall;
+
+    /**
+     * Constructor
+     * @param batched Should begin contact events be batched?
+     */
+    FallingBall(bool batched)
+    {
+        mContacts.SetBatched(batched);
+        mWorld.SetContactListener(&mContacts);
+
+        b2BodyDef floorDef;
+        auto floor = mWorld.CreateBody(&floorDef);
+        b2PolygonShape box;
+        box.SetAsBox(10, 0.5f);
+        floor->CreateFixture(&box, 0);
+
+        b2BodyDef ballDef;
+        ballDef.type = b2_dynamicBody;
+        ballDef.position.Set(0, 2);
+        mBall = mWorld.CreateBody(&ballDef);
+        b2CircleShape circle;
+        circle.m_radius = 0.25f;
+        mBall->CreateFixture(&circle, 1);
+
+        mContacts.Add(mBall, &mBallListener);
+    }
+
+    /**
+     * Step the world and finish the step
+     */
+    void Step()
+    {
+        mWorld.Step(1.0f / 30, 6, 2);
+        mContacts.EndStep(&mWorld);
+    }
+};
+
+TEST(ContactListenerTest, Dispatch)
+{
+    FallingBall world(false);
+
+    int steps = 0;
+    while (world.mBallListener.mBegins == 0 && steps < 100)
+    {
+        world.Step();
+        steps++;
+    }
+
+    // The ball landed and its listener, found through the body user data, was told
+    ASSERT_EQ(1, world.mBallListener.mBegins);
+    ASSERT_EQ(1, world.mContacts.GetStatistics().mBegins);
+    ASSERT_EQ(1, world.mContacts.GetStatistics().mContacts);
+
+    // Only the ball has a listener, so only its calls are dispatched
+    auto &statistics = world.mContacts.GetStatistics();
+    ASSERT_EQ(statistics.mBegins + statistics.mPreSolves, statistics.mDispatched);
+}
+
+TEST(ContactListenerTest, Batched)
+{
+    FallingBall immediate(false);
+    FallingBall batched(true);
+
+    // Batched delivery tells the listeners the same things in the same steps
+    for (int step = 0; step < 60; step++)
+    {
+        immediate.Step();
+        batched.Step();
+
+        ASSERT_EQ(immediate.mBallListener.mBegins, batched.mBallListener.mBegins) << "Step " << step;
+        ASSERT_EQ(immediate.mBallListener.mPreSolves, batched.mBallListener.mPreSolves) << "Step " << step;
+
+        auto &a = immediate.mContacts.GetStatistics();
+        auto &b = batched.mContacts.GetStatistics();
+        ASSERT_EQ(a.mBegins, b.mBegins);
+        ASSERT_EQ(a.mEnds, b.mEnds);
+        ASSERT_EQ(a.mDispatched, b.mDispatched);
+        ASSERT_EQ(a.mContacts, b.mContacts);
+
+        ASSERT_EQ(immediate.mBall->GetPosition().y, batched.mBall->GetPosition().y);
+    }
+
+    // The ball did land
+    ASSERT_LT(0, batched.mBallListener.mBegins);
+}
+
+TEST(ContactListenerTest, DestroyedBody)
+{
+    FallingBall world(true);
+
+    // Step without finishing until the ball has a held begin event
+    bool touching = false;
+    for (int step = 0; step < 100 && !touching; step++)
+    {
+        world.mWorld.Step(1.0f / 30, 6, 2);
+        auto edge = world.mBall->GetContactList();
+        touching = edge != nullptr && edge->contact->IsTouching();
+    }
+
+    ASSERT_TRUE(touching);
+
+    // Destroying the ball destroys its contact, so the held event is dropped
+    world.mWorld.DestroyBody(world.mBall);
+    world.mContacts.EndStep(&world.mWorld);
+    ASSERT_EQ(0, world.mBallListener.mBegins);
+    ASSERT_EQ(1, world.mContacts.GetStatistics().mBegins);
+    ASSERT_EQ(1, world.mContacts.GetStatistics().mEnds);
+
+    // Only the pre-solves, which are never held, reached the listener
+    ASSERT_EQ(world.mBallListener.mPreSolves, world.mContacts.GetStatistics().mDispatched);
+}
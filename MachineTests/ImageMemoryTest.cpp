@@ -0,0 +1,33 @@
+/**
+ * @file ImageMemoryTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include "gtest/gtest.h"
+
+#include <ImageMemory.h>
+
+TEST(ImageMemoryTest, Record)
+{
+    ImageMemory memory;
+    int owner1, owner2, owner3;
+
+    ASSERT_EQ(40u, ImageMemory::ImageBytes(5, 2, true));
+    ASSERT_EQ(30u, ImageMemory::ImageBytes(5, 2, false));
+
+    memory.Record(&owner1, L"a.png", 100);
+    memory.Record(&owner2, L"b.png", 300);
+    memory.Record(&owner3, L"a.png", 250);
+    ASSERT_EQ(650u, memory.GetTotalBytes());
+
+    // Owners of the same asset are added together
+    auto report = memory.GetReport();
+    ASSERT_EQ(2u, report.size());
+    ASSERT_EQ(L"a.png", report[0].mAsset);
+    ASSERT_EQ(350u, report[0].mBytes);
+
+    // Recording again replaces what an owner held
+    memory.Record(&owner3, L"a.png", 0);
+    memory.Forget(&owner2);
+    ASSERT_EQ(100u, memory.GetTotalBytes());
+}
@@ -0,0 +1,36 @@
+/**
+ * @file MachineFactory3Test.cpp
+ * @author Thomas Toaz
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <MachineSystemActual.h>
+#include <MachineState.h>
+#include <MachineFactory3.h>
+
+TEST(MachineFactory3Test, StressParameters)
+{
+    MachineSystemActual machine(L".");
+
+    MachineFactory3::Parameters parameters;
+    parameters.mBalls = 10;
+    parameters.mPulleys = 5;
+    parameters.mHamsters = 2;
+    parameters.mConveyors = 3;
+    machine.SetStressParameters(parameters);
+
+    machine.SetMachineNumber(3);
+    ASSERT_EQ(3, machine.GetMachineNumber());
+    machine.SetMachineFrame(30);
+
+    // Floor, two walls, 2 hamster cages, 3 conveyors, 10 balls and a goal with two bodies
+    ASSERT_EQ(20u, machine.GetMachineState()->GetBodies().size());
+
+    // New parameters rebuild the machine
+    parameters.mBalls = 20;
+    machine.SetStressParameters(parameters);
+    ASSERT_FALSE(machine.IsActive());
+    ASSERT_EQ(30u, machine.GetMachineState()->GetBodies().size());
+}
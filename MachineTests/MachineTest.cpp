@@ -8,6 +8,13 @@
 
 #include <MachineSystemFactory.h>
 #include <IMachineSystem.h>
+#include <MachineState.h>
+#include <MachineSystemActual.h>
+#include <PhysicsShape.h>
+#include <Machine.h>
+#include <Component.h>
+
+#include <b2_world.h>
 
 TEST(MachineTest, Constructor)
 {
@@ -61,4 +68,181 @@ TEST(MachineTest, MachineNumber)
     // Ensure we can go back to machine number 1
     machine->SetMachineNumber(1);
     ASSERT_EQ(1, machine->GetMachineNumber());
-}
\ No newline at end of file
+}
+
+TEST(MachineTest, MachineState)
+{
+    MachineSystemFactory factory(L".");
+    auto machine1 = std::dynamic_pointer_cast<MachineSystemActual>(factory.CreateMachineSystem());
+    auto machine2 = std::dynamic_pointer_cast<MachineSystemActual>(factory.CreateMachineSystem());
+    ASSERT_NE(nullptr, machine1);
+    ASSERT_NE(nullptr, machine2);
+
+    machine1->SetMachineNumber(1);
+    machine1->SetFrameRate(30);
+    machine1->SetMachineFrame(50);
+
+    auto state = machine1->GetMachineState();
+    ASSERT_NE(nullptr, state);
+    ASSERT_EQ(1, state->GetMachineNumber());
+    ASSERT_EQ(50, state->GetFrame());
+
+    // A state for another machine number is ignored
+    machine2->SetMachineNumber(2);
+    machine2->SetFrameRate(30);
+    machine2->SetMachineState(*state);
+    ASSERT_EQ(2, machine2->GetMachineNumber());
+    ASSERT_NEAR(0, machine2->GetMachineTime(), 0.001);
+
+    // Restoring shows the saved frame
+    machine2->SetMachineNumber(1);
+    machine2->SetMachineState(*state);
+    ASSERT_NEAR(50.0 / 30.0, machine2->GetMachineTime(), 0.001);
+
+    // A restored machine simulates again from the start to reach
+    // another frame, so it matches one that never stopped exactly
+    machine1->SetMachineFrame(60);
+    machine2->SetMachineFrame(60);
+
+    // Keep the states alive while their bodies are compared
+    auto state1 = machine1->GetMachineState();
+    auto state2 = machine2->GetMachineState();
+    auto &bodies1 = state1->GetBodies();
+    auto &bodies2 = state2->GetBodies();
+    ASSERT_EQ(bodies1.size(), bodies2.size());
+    for (size_t i = 0; i < bodies1.size(); i++)
+    {
+        ASSERT_EQ(bodies1[i].x, bodies2[i].x);
+        ASSERT_EQ(bodies1[i].y, bodies2[i].y);
+        ASSERT_EQ(bodies1[i].angle, bodies2[i].angle);
+    }
+}
+
+TEST(MachineTest, Activate)
+{
+    MachineSystemActual machine(L".");
+
+    // Nothing is built until the machine is needed
+    ASSERT_FALSE(machine.IsActive());
+    machine.SetMachineNumber(2);
+    ASSERT_EQ(2, machine.GetMachineNumber());
+    machine.SetMachineFrame(-1);
+    ASSERT_FALSE(machine.IsActive());
+
+    machine.SetMachineFrame(10);
+    ASSERT_TRUE(machine.IsActive());
+    ASSERT_NEAR(10.0 / 30.0, machine.GetMachineTime(), 0.001);
+
+    // A new machine number discards the built machine
+    machine.SetMachineNumber(1);
+    ASSERT_FALSE(machine.IsActive());
+    machine.Activate();
+    ASSERT_TRUE(machine.IsActive());
+    ASSERT_EQ(1, machine.GetMachineNumber());
+}
+
+/// Component made only of a PhysicsShape, with nothing to draw
+class TestShapeComponent : public Component
+{
+public:
+    /// Shape of the component
+    PhysicsShape mShape;
+
+    void Record(RenderList &list) override {}
+    bool NeedsUpdate() override { return false; }
+    void InstallPhysics(std::shared_ptr<b2World> world) override { mShape.InstallPhysics(world); }
+    void SaveState(MachineState &state) override { state.SaveBody(mShape.GetBody()); }
+    void RestoreState(MachineState::Reader &reader) override { reader.RestoreBody(mShape.GetBody()); }
+};
+
+TEST(MachineTest, HeadlessMachine)
+{
+    // A machine of shapes steps and saves state with no images
+    Machine machine(7);
+
+    auto floor = std::make_shared<TestShapeComponent>();
+    floor->mShape.SetPolygon({{-50, 0}, {50, 0}, {50, 5}, {-50, 5}});
+    machine.AddComponent(floor);
+
+    auto ball = std::make_shared<TestShapeComponent>();
+    ball->mShape.SetCircle(5);
+    ball->mShape.SetInitialPosition(0, 100);
+    ball->mShape.SetDynamic();
+    machine.AddComponent(ball);
+
+    machine.Reset();
+    for (int i = 0; i < 10; i++)
+    {
+        machine.Update(1.0 / 30);
+    }
+
+    auto state = machine.SaveState(10);
+    double y = ball->mShape.GetPosition().y;
+    ASSERT_LT(y, 100);
+
+    // Restoring goes back to the saved state
+    machine.Update(1.0 / 30);
+    ASSERT_LT(ball->mShape.GetPosition().y, y);
+    machine.RestoreState(*state);
+    ASSERT_NEAR(y, ball->mShape.GetPosition().y, 0.001);
+}
+
+/// Shape component that needs updating only while its body is awake
+class TestSleepingComponent : public TestShapeComponent
+{
+public:
+    /// Number of times Update was called
+    int mUpdates = 0;
+
+    void Update(double elapsed) override { mUpdates++; }
+    bool NeedsUpdate() override { return true; }
+    bool IsAsleep() override { return !mShape.GetBody()->IsAwake(); }
+};
+
+TEST(MachineTest, Settled)
+{
+    Machine machine(7);
+
+    auto floor = std::make_shared<TestShapeComponent>();
+    floor->mShape.SetPolygon({{-50, 0}, {50, 0}, {50, 5}, {-50, 5}});
+    machine.AddComponent(floor);
+
+    auto ball = std::make_shared<TestSleepingComponent>();
+    ball->mShape.SetCircle(5);
+    ball->mShape.SetInitialPosition(0, 20);
+    ball->mShape.SetDynamic();
+    machine.AddComponent(ball);
+
+    machine.Reset();
+    machine.Update(1.0 / 30);
+    ASSERT_FALSE(machine.IsSettled());
+
+    // The ball lands and Box2D puts it to sleep
+    int frames = 1;
+    for ( ; frames < 600 && !machine.IsSettled(); frames++)
+    {
+        machine.Update(1.0 / 30);
+    }
+
+    ASSERT_TRUE(machine.IsSettled());
+    ASSERT_FALSE(ball->mShape.GetBody()->IsAwake());
+
+    // A sleeping component is not updated, and a settled world is not stepped
+    int updates = ball->mUpdates;
+    double y = ball->mShape.GetPosition().y;
+    for (int i = 0; i < 10; i++)
+    {
+        machine.Update(1.0 / 30);
+    }
+
+    ASSERT_EQ(updates, ball->mUpdates);
+    ASSERT_TRUE(machine.IsSettled());
+    ASSERT_EQ(y, ball->mShape.GetPosition().y);
+    ASSERT_EQ(0, machine.GetProfile().step);
+
+    // Waking the body wakes the component and the world
+    ball->mShape.GetBody()->SetAwake(true);
+    machine.Update(1.0 / 30);
+    ASSERT_EQ(updates + 1, ball->mUpdates);
+    ASSERT_FALSE(machine.IsSettled());
+}
@@ -0,0 +1,116 @@
+/**
+ * @file MachineTraceTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include "pch.h"
+#include "gtest/gtest.h"
+
+#include <MachineSystemActual.h>
+#include <MachineState.h>
+#include <MachineTrace.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+/// Number of frames in a golden trace
+const int TraceFrames = 300;
+
+/**
+ * Run a machine from frame 0 and record the state hash of every frame
+ * @param machineNumber Machine to run
+ * @return The trace
+ */
+static MachineTrace RunTrace(int machineNumber)
+{
+    MachineSystemActual machine(L".");
+    machine.SetMachineNumber(machineNumber);
+
+    MachineTrace trace(machineNumber);
+    for (int frame = 0; frame < TraceFrames; frame++)
+    {
+        machine.SetMachineFrame(frame);
+        trace.Add(*machine.GetMachineState());
+    }
+
+    return trace;
+}
+
+/**
+ * Name of the platform golden traces are recorded for.
+ *
+ * The hashes are of bit-exact floats, which differ between
+ * compilers and instruction sets, so each platform has its own.
+ * @return Platform name, like linux-gcc11-x86_64
+ */
+static std::string GoldenPlatform()
+{
+#if defined(_WIN32)
+    std::string platform = "windows";
+#elif defined(__APPLE__)
+    std::string platform = "macos";
+#else
+    std::string platform = "linux";
+#endif
+
+#if defined(__clang__)
+    platform += "-clang" + std::to_string(__clang_major__);
+#elif defined(__GNUC__)
+    platform += "-gcc" + std::to_string(__GNUC__);
+#elif defined(_MSC_VER)
+    platform += "-msvc" + std::to_string(_MSC_VER);
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+    platform += "-x86_64";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    platform += "-arm64";
+#endif
+
+    return platform;
+}
+
+TEST(MachineTraceTest, Repeatable)
+{
+    // The same build must always simulate the same way
+    for (int machineNumber = 1; machineNumber <= 2; machineNumber++)
+    {
+        ASSERT_EQ(-1, RunTrace(machineNumber).FirstDivergence(RunTrace(machineNumber)))
+            << "Machine " << machineNumber;
+    }
+}
+
+TEST(MachineTraceTest, GoldenTrace)
+{
+    // Set MACHINE_TRACE_RECORD to record the golden traces instead of checking them
+    bool record = std::getenv("MACHINE_TRACE_RECORD") != nullptr;
+    if (record)
+    {
+        std::filesystem::create_directories(GOLDEN_TRACE_DIR);
+    }
+
+    for (int machineNumber = 1; machineNumber <= 2; machineNumber++)
+    {
+        auto filename = std::string(GOLDEN_TRACE_DIR) + "/machine" + std::to_string(machineNumber) +
+            "-" + GoldenPlatform() + ".trace";
+        if (!record && !std::filesystem::exists(filename))
+        {
+            GTEST_SKIP() << "No golden trace " << filename
+                << ", run with MACHINE_TRACE_RECORD set to record it";
+        }
+
+        auto trace = RunTrace(machineNumber);
+        if (record)
+        {
+            ASSERT_TRUE(trace.Save(filename));
+            continue;
+        }
+
+        MachineTrace golden;
+        ASSERT_TRUE(golden.Load(filename)) << "Unreadable golden trace " << filename;
+
+        ASSERT_EQ(-1, trace.FirstDivergence(golden)) << "First frame where machine " << machineNumber
+            << " diverges from " << filename;
+    }
+}
@@ -0,0 +1,145 @@
+/**
+ * @file MipmapKernelTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include "gtest/gtest.h"
+
+#include <MipmapKernel.h>
+#include <RenderImage.h>
+#include <RenderPath.h>
+#include <SoftwareRenderer.h>
+#include <TileRenderer.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+TEST(MipmapKernelTest, Downsample)
+{
+    // 40x3 RGB, so the rows are long enough for the vector path
+    const int width = 40;
+    const int height = 3;
+    std::vector<unsigned char> src(width * height * 3);
+    for (size_t i = 0; i < src.size(); i++)
+    {
+        src[i] = (unsigned char)(i * 37 % 251);
+    }
+
+    ASSERT_EQ(20, MipmapKernel::HalfSize(width));
+    ASSERT_EQ(1, MipmapKernel::HalfSize(height));
+    ASSERT_EQ(1, MipmapKernel::HalfSize(1));
+
+    std::vector<unsigned char> dst(20 * 1 * 3);
+    MipmapKernel::Downsample(src.data(), width, height, 3, dst.data());
+
+    // Each value is the rounded average of the 2x2 block under it
+    for (int x = 0; x < 20; x++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            int sum = src[(x * 2) * 3 + c] + src[(x * 2 + 1) * 3 + c] +
+                src[(width + x * 2) * 3 + c] + src[(width + x * 2 + 1) * 3 + c];
+            ASSERT_EQ((sum + 2) / 4, dst[x * 3 + c]);
+        }
+    }
+
+    // The level closest to the drawn size
+    ASSERT_EQ(0, MipmapKernel::SelectLevel(1.0, 4));
+    ASSERT_EQ(0, MipmapKernel::SelectLevel(0.9, 4));
+    ASSERT_EQ(1, MipmapKernel::SelectLevel(0.6, 4));
+    ASSERT_EQ(2, MipmapKernel::SelectLevel(0.25, 4));
+    ASSERT_EQ(3, MipmapKernel::SelectLevel(0.01, 4));
+    ASSERT_EQ(0, MipmapKernel::SelectLevel(4.0, 4));
+}
+
+TEST(MipmapKernelTest, DownsampleBox)
+{
+    // 4 channels and 3 channels, 3x3 blocks with a partial block dropped
+    const int factor = 3;
+    const int width = 26;
+    const int height = 7;
+    for (int channels : {4, 3})
+    {
+        std::vector<unsigned char> src(width * height * channels);
+        for (size_t i = 0; i < src.size(); i++)
+        {
+            src[i] = (unsigned char)(i * 53 % 251);
+        }
+
+        std::vector<unsigned char> dst(8 * 2 * channels);
+        MipmapKernel::DownsampleBox(src.data(), width, height, channels, factor, dst.data());
+
+        // Each value is the rounded average of the block under it
+        for (int y = 0; y < 2; y++)
+        {
+            for (int x = 0; x < 8; x++)
+            {
+                for (int c = 0; c < channels; c++)
+                {
+                    int sum = 0;
+                    for (int j = 0; j < factor; j++)
+                    {
+                        for (int i = 0; i < factor; i++)
+                        {
+                            sum += src[((y * factor + j) * width + x * factor + i) * channels + c];
+                        }
+                    }
+
+                    ASSERT_EQ((sum + 4) / 9, dst[(y * 8 + x) * channels + c]);
+                }
+            }
+        }
+    }
+
+    // Drawing and reducing a strip at a time gives the whole frame
+    auto draw = [](Renderer &renderer) {
+        RenderPath path;
+        path.MoveToPoint(3, 2);
+        path.AddCurveToPoint(30, -5, 45, 20, 20, 28);
+        path.AddLineToPoint(1, 15);
+        path.CloseSubpath();
+        renderer.SetBrush(0xc0408020);
+        renderer.FillPath(path);
+        renderer.SetPen(0xff000000, 1.5);
+        renderer.StrokePath(path);
+    };
+
+    const int frameWidth = 40;
+    const int frameHeight = 30;
+    const int stripRows = 8;
+    const int supersample = 2;
+
+    RenderImage whole(frameWidth * supersample, frameHeight * supersample);
+    whole.Fill(0xffffffff);
+    SoftwareRenderer renderer(whole);
+    renderer.Scale(supersample, supersample);
+    draw(renderer);
+
+    RenderImage reduced(frameWidth, frameHeight);
+    MipmapKernel::DownsampleBox(whole.GetRow(0), whole.GetWidth(), whole.GetHeight(), 4, supersample,
+            reduced.GetRow(0));
+
+    TileRenderer tiles(2, 16);
+    for (int top = 0; top < frameHeight; top += stripRows)
+    {
+        int rows = std::min(stripRows, frameHeight - top);
+        RenderImage strip(frameWidth * supersample, rows * supersample);
+        strip.Fill(0xffffffff);
+        tiles.Render(strip, [&draw, top](Renderer &renderer) {
+            renderer.Translate(0, -top * supersample);
+            renderer.Scale(supersample, supersample);
+            draw(renderer);
+        });
+
+        RenderImage stripReduced(frameWidth, rows);
+        MipmapKernel::DownsampleBox(strip.GetRow(0), strip.GetWidth(), strip.GetHeight(), 4, supersample,
+                stripReduced.GetRow(0));
+        for (int y = 0; y < rows; y++)
+        {
+            for (int i = 0; i < frameWidth * 4; i++)
+            {
+                ASSERT_LE(std::abs(reduced.GetRow(top + y)[i] - stripReduced.GetRow(y)[i]), 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/**
+ * @file PhysicsShapeTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include "gtest/gtest.h"
+
+#include <PhysicsShape.h>
+
+#include <memory>
+#include <b2_world.h>
+
+TEST(PhysicsShapeTest, InstallPhysics)
+{
+    auto world = std::make_shared<b2World>(b2Vec2(0.0f, -9.8f));
+
+    PhysicsShape shape;
+    shape.SetPolygon({{-10, 0}, {10, 0}, {10, 5}, {-10, 5}});
+    shape.SetInitialPosition(100, 50);
+    shape.SetInitialRotation(0.25);
+    shape.InstallPhysics(world);
+
+    // A static shape stays where it was placed
+    ASSERT_NE(nullptr, shape.GetBody());
+    ASSERT_NEAR(100, shape.GetPosition().x, 0.001);
+    ASSERT_NEAR(50, shape.GetPosition().y, 0.001);
+    ASSERT_NEAR(0.25, shape.GetRotation(), 0.001);
+
+    world->Step(1.0f / 30, 8, 3);
+    ASSERT_NEAR(50, shape.GetPosition().y, 0.001);
+
+    // A dynamic shape falls
+    PhysicsShape ball;
+    ball.SetCircle(5);
+    ball.SetInitialPosition(0, 200);
+    ball.SetDynamic();
+    ball.InstallPhysics(world);
+
+    for (int i = 0; i < 10; i++)
+    {
+        world->Step(1.0f / 30, 8, 3);
+    }
+
+    ASSERT_LT(ball.GetPosition().y, 200);
+}
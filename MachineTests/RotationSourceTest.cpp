@@ -0,0 +1,92 @@
+/**
+ * @file RotationSourceTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include "gtest/gtest.h"
+
+#include <RotationSource.h>
+#include <IRotationSink.h>
+
+#include <memory>
+
+/// Rotation sink that records what it was given and can drive more sinks
+class TestRotationSink : public IRotationSink
+{
+public:
+    /// Source this sink drives
+    RotationSource mSource;
+
+    /// Last rotation received
+    double mRotation = 0;
+
+    /// Last speed received
+    double mSpeed = 0;
+
+    /// Number of times Rotate was called
+    int mCalls = 0;
+
+    void Rotate(double rotation, double speed) override { mRotation = rotation; mSpeed = speed; mCalls++; }
+    RotationSource *GetDrivenSource() override { return &mSource; }
+};
+
+TEST(RotationSourceTest, Train)
+{
+    auto sink1 = std::make_shared<TestRotationSink>();
+    auto sink2 = std::make_shared<TestRotationSink>();
+    auto sink3 = std::make_shared<TestRotationSink>();
+
+    RotationSource source;
+    source.AddSink(sink1);
+    sink1->mSource.AddSink(sink2, 2);
+    sink2->mSource.AddSink(sink3, 0.5);
+
+    ASSERT_TRUE(source.Compile());
+    ASSERT_EQ(3u, source.GetTrainSize());
+
+    // Ratios multiply along the train
+    source.SetRotation(0.25, 1);
+    source.UpdateSinks();
+    ASSERT_NEAR(0.25, sink1->mRotation, 0.0001);
+    ASSERT_NEAR(0.5, sink2->mRotation, 0.0001);
+    ASSERT_NEAR(2, sink2->mSpeed, 0.0001);
+    ASSERT_NEAR(0.25, sink3->mRotation, 0.0001);
+
+    // A cycle is detected and followed only once
+    sink3->mSource.AddSink(sink1);
+    ASSERT_FALSE(source.Compile());
+    source.UpdateSinks();
+    ASSERT_EQ(2, sink1->mCalls);
+    ASSERT_EQ(2, sink3->mCalls);
+}
+
+TEST(RotationSourceTest, Changes)
+{
+    auto sink1 = std::make_shared<TestRotationSink>();
+    auto sink2 = std::make_shared<TestRotationSink>();
+    auto sink3 = std::make_shared<TestRotationSink>();
+    auto sink4 = std::make_shared<TestRotationSink>();
+
+    RotationSource source;
+    source.AddSink(sink1);
+    source.SetRotation(0.25, 1);
+    source.UpdateSinks();
+    ASSERT_EQ(1u, source.GetTrainSize());
+
+    // A sink added further down the train is driven at the next update
+    sink1->mSource.AddSink(sink2, 2);
+    source.UpdateSinks();
+    ASSERT_EQ(2u, source.GetTrainSize());
+    ASSERT_EQ(1, sink2->mCalls);
+    ASSERT_NEAR(0.5, sink2->mRotation, 0.0001);
+
+    // A sink reached by two paths is driven once
+    source.AddSink(sink3);
+    sink2->mSource.AddSink(sink4);
+    sink3->mSource.AddSink(sink4);
+    ASSERT_TRUE(source.Compile());
+    ASSERT_EQ(4u, source.GetTrainSize());
+    source.UpdateSinks();
+    ASSERT_EQ(1, sink4->mCalls);
+    ASSERT_NEAR(0.5, sink4->mRotation, 0.0001);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file SoftwareRendererTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include "gtest/gtest.h"
+
+#include <RenderImage.h>
+#include <RenderPath.h>
+#include <SoftwareRenderer.h>
+
+TEST(SoftwareRendererTest, Draw)
+{
+    RenderImage image(40, 30);
+    image.Fill(0xffffffff);
+    SoftwareRenderer renderer(image);
+
+    // Pixel as RGBA with red in the low byte
+    auto pixel = [&image](int x, int y) {
+        auto p = image.GetRow(y) + x * 4;
+        return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+    };
+
+    // No brush until one is set
+    RenderPath square;
+    square.MoveToPoint(5, 5);
+    square.AddLineToPoint(15, 5);
+    square.AddLineToPoint(15, 15);
+    square.AddLineToPoint(5, 15);
+    square.CloseSubpath();
+    renderer.FillPath(square);
+    ASSERT_EQ(0xffffffffu, pixel(10, 10));
+
+    renderer.SetBrush(0xff0000ff);
+    renderer.FillPath(square);
+    ASSERT_EQ(0xff0000ffu, pixel(10, 10));
+    ASSERT_EQ(0xffffffffu, pixel(4, 10));
+    ASSERT_EQ(0xffffffffu, pixel(15, 10));
+
+    // An edge through the middle of a pixel covers half of it
+    RenderPath half;
+    half.MoveToPoint(20, 5.5);
+    half.AddLineToPoint(30, 5.5);
+    half.AddLineToPoint(30, 10);
+    half.AddLineToPoint(20, 10);
+    half.CloseSubpath();
+    renderer.SetBrush(0xff000000);
+    renderer.FillPath(half);
+    ASSERT_EQ(0xff7f7f7fu, pixel(25, 5));
+    ASSERT_EQ(0xff000000u, pixel(25, 7));
+
+    // A line 2 wide covers a pixel each side of it
+    RenderPath line;
+    line.MoveToPoint(5.5, 20);
+    line.AddLineToPoint(30.5, 20);
+    renderer.SetPen(0xff00ff00, 2);
+    renderer.StrokePath(line);
+    ASSERT_EQ(0xff00ff00u, pixel(10, 19));
+    ASSERT_EQ(0xff00ff00u, pixel(10, 20));
+    ASSERT_EQ(0xffffffffu, pixel(10, 22));
+
+    // A 2x2 image scaled up through a transform
+    unsigned char rgb[] = {255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 255};
+    RenderImage source(2, 2);
+    source.SetPlanes(rgb, nullptr);
+    renderer.PushState();
+    renderer.Translate(0, 22);
+    renderer.DrawImage(source, 0, 0, 8, 8);
+    renderer.PopState();
+    ASSERT_EQ(0xff0000ffu, pixel(1, 23));
+    ASSERT_EQ(0xffffffffu, pixel(6, 28));
+
+    // PopState restores the transform
+    double x, y;
+    renderer.GetTransform().Apply(1, 2, x, y);
+    ASSERT_DOUBLE_EQ(1, x);
+    ASSERT_DOUBLE_EQ(2, y);
+
+    // The built-in font is 6 pixels across at 8 high
+    renderer.SetFont(8, 0xff000000);
+    ASSERT_DOUBLE_EQ(12, renderer.GetTextWidth(L"12"));
+}
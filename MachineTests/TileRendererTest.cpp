@@ -0,0 +1,96 @@
+/**
+ * @file TileRendererTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include "gtest/gtest.h"
+
+#include <RenderImage.h>
+#include <RenderPath.h>
+#include <SoftwareRenderer.h>
+#include <TileRenderer.h>
+
+#include <cstdlib>
+
+TEST(TileRendererTest, Render)
+{
+    unsigned char rgb[] = {255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 255};
+    RenderImage source(2, 2);
+    source.SetPlanes(rgb, nullptr);
+
+    // Shapes, lines, images and text, rotated across tile edges
+    auto draw = [&source](Renderer &renderer) {
+        for (int i = 0; i < 12; i++)
+        {
+            renderer.PushState();
+            renderer.Translate(10 + i * 9, 8 + i * 5);
+            renderer.Rotate(i * 0.5);
+
+            RenderPath path;
+            path.MoveToPoint(0, 0);
+            path.AddCurveToPoint(20, -15, 40, 15, 30, 30);
+            path.AddLineToPoint(-10, 20);
+            path.CloseSubpath();
+            renderer.SetBrush(0x80000000u | (i * 0x151515));
+            renderer.FillPath(path);
+            renderer.SetPen(0xff0000ffu, 1 + i % 3);
+            renderer.StrokePath(path);
+            renderer.DrawImage(source, -5, -5, 17, 11);
+            renderer.SetFont(9, 0xff000000u);
+            renderer.DrawText(L"Tile 48", 0, 0);
+            renderer.PopState();
+        }
+    };
+
+    RenderImage single(120, 80);
+    single.Fill(0xffffffff);
+    SoftwareRenderer renderer(single);
+    draw(renderer);
+
+    // Small tiles, so every call crosses several
+    RenderImage tiled(120, 80);
+    tiled.Fill(0xffffffff);
+    TileRenderer tiles(3, 16);
+    tiles.Render(tiled, draw);
+
+    // The tiles add up the same coverage, up to float rounding
+    auto a = single.GetRow(0);
+    auto b = tiled.GetRow(0);
+    for (size_t i = 0; i < single.GetBytes(); i++)
+    {
+        ASSERT_LE(std::abs(a[i] - b[i]), 1) << "Byte " << i;
+    }
+
+    // Measuring gives the pixels each call covers, in call order
+    RenderImage image(40, 30);
+    SoftwareRenderer measure(image);
+    std::vector<SoftwareRenderer::Bounds> measured;
+    measure.SetMeasured(&measured);
+
+    RenderPath square;
+    square.MoveToPoint(5, 5);
+    square.AddLineToPoint(15, 5);
+    square.AddLineToPoint(15, 15.5);
+    square.AddLineToPoint(5, 15.5);
+    square.CloseSubpath();
+    measure.FillPath(square);
+    measure.SetBrush(0xff000000);
+    measure.FillPath(square);
+    ASSERT_EQ(2u, measured.size());
+    ASSERT_EQ(0, measured[0].mRight);
+    ASSERT_EQ(5, measured[1].mLeft);
+    ASSERT_EQ(5, measured[1].mTop);
+    ASSERT_EQ(15, measured[1].mRight);
+    ASSERT_EQ(16, measured[1].mBottom);
+
+    // Only the calls listed are drawn
+    image.Fill(0xffffffff);
+    SoftwareRenderer some(image);
+    std::vector<int> drawn = {1};
+    some.SetDrawn(&drawn);
+    some.SetBrush(0xff000000);
+    some.FillPath(square);
+    ASSERT_EQ(255, image.GetRow(10)[10 * 4]);
+    some.FillPath(square);
+    ASSERT_EQ(0, image.GetRow(10)[10 * 4]);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file FrameCacheTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+
+#include <FrameCache.h>
+
+/// Bytes in a 100x100 frame stored at full scale
+const size_t FrameBytes = 100 * 100 * 3;
+
+TEST(FrameCacheTest, AddFind)
+{
+    FrameCache cache;
+    cache.SetScale(0.5);
+
+    ASSERT_FALSE(cache.Find(7).IsOk());
+
+    cache.Add(7, wxImage(100, 80));
+    auto image = cache.Find(7);
+    ASSERT_TRUE(image.IsOk());
+    ASSERT_EQ(50, image.GetWidth());
+    ASSERT_EQ(40, image.GetHeight());
+    ASSERT_EQ(50u * 40u * 3u, cache.GetMemoryUsed());
+}
+
+TEST(FrameCacheTest, Eviction)
+{
+    FrameCache cache(FrameBytes * 3);
+    cache.SetScale(1);
+
+    cache.Add(1, wxImage(100, 100));
+    cache.Add(2, wxImage(100, 100));
+    cache.Add(3, wxImage(100, 100));
+    ASSERT_EQ(3, cache.GetNumFrames());
+
+    // Using frame 1 makes frame 2 the least recently used
+    ASSERT_TRUE(cache.Find(1).IsOk());
+    cache.Add(4, wxImage(100, 100));
+    ASSERT_EQ(3, cache.GetNumFrames());
+    ASSERT_FALSE(cache.Find(2).IsOk());
+    ASSERT_TRUE(cache.Find(1).IsOk());
+    ASSERT_TRUE(cache.Find(3).IsOk());
+    ASSERT_TRUE(cache.Find(4).IsOk());
+
+    // A smaller budget evicts down to it
+    cache.SetBudget(FrameBytes);
+    ASSERT_EQ(1, cache.GetNumFrames());
+    ASSERT_TRUE(cache.Find(4).IsOk());
+    ASSERT_EQ(FrameBytes, cache.GetMemoryUsed());
+}
+
+TEST(FrameCacheTest, Invalidate)
+{
+    FrameCache cache;
+    cache.SetScale(1);
+
+    for (int frame = 0; frame < 10; frame++)
+    {
+        cache.Add(frame, wxImage(10, 10));
+    }
+
+    cache.Invalidate(3, 6);
+    ASSERT_EQ(6, cache.GetNumFrames());
+    ASSERT_TRUE(cache.Find(2).IsOk());
+    ASSERT_FALSE(cache.Find(3).IsOk());
+    ASSERT_FALSE(cache.Find(6).IsOk());
+    ASSERT_TRUE(cache.Find(7).IsOk());
+
+    cache.Clear();
+    ASSERT_EQ(0, cache.GetNumFrames());
+    ASSERT_EQ(0u, cache.GetMemoryUsed());
+}
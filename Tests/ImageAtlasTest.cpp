@@ -0,0 +1,60 @@
+/**
+ * @file ImageAtlasTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+
+#include <image-atlas.h>
+#include <filesystem>
+
+/**
+ * Write a solid colour image to a directory
+ * @param directory Directory to write to
+ * @param name File name
+ * @param size Image size in pixels
+ * @param red Red value of every pixel
+ */
+static void WriteImage(const std::wstring &directory, const std::wstring &name, wxSize size, unsigned char red)
+{
+    wxImage image(size);
+    image.SetRGB(wxRect(size), red, 10, 20);
+    image.SaveFile(directory + L"/" + name, wxBITMAP_TYPE_PNG);
+}
+
+TEST(ImageAtlasTest, Build)
+{
+    auto directory = (std::filesystem::temp_directory_path() / "atlas-test").wstring();
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory + L"/images");
+
+    WriteImage(directory + L"/images", L"a.png", wxSize(40, 30), 100);
+    WriteImage(directory + L"/images", L"b.png", wxSize(20, 50), 200);
+    WriteImage(directory + L"/images", L"big.png", wxSize(300, 10), 50);
+
+    // Images larger than the largest packed size stay out of the atlas
+    ImageAtlas atlas(256, 128);
+    ASSERT_TRUE(atlas.Build(directory + L"/images", directory + L"/cache"));
+    ASSERT_EQ(2u, atlas.GetImageCount());
+    ASSERT_EQ(1u, atlas.GetPageCount());
+    ASSERT_FALSE(atlas.Contains(directory + L"/images/big.png"));
+    ASSERT_FALSE(atlas.GetImage(directory + L"/images/big.png").IsOk());
+
+    auto image = atlas.GetImage(directory + L"/images/b.png");
+    ASSERT_TRUE(image.IsOk());
+    ASSERT_EQ(20, image.GetWidth());
+    ASSERT_EQ(50, image.GetHeight());
+    ASSERT_EQ(200, image.GetRed(19, 49));
+
+    // A second atlas is built from the cache
+    ImageAtlas cached(256, 128);
+    ASSERT_TRUE(cached.Build(directory + L"/images", directory + L"/cache"));
+    ASSERT_EQ(2u, cached.GetImageCount());
+    image = cached.GetImage(directory + L"/images/a.png");
+    ASSERT_TRUE(image.IsOk());
+    ASSERT_EQ(40, image.GetWidth());
+    ASSERT_EQ(100, image.GetRed(0, 0));
+
+    std::filesystem::remove_all(directory);
+}
@@ -18,6 +18,17 @@ public:
     bool mUpdated = false;
 };
 
+class PictureObserverChangesMock : public PictureObserver
+{
+public:
+    PictureObserverChangesMock() : PictureObserver() {}
+
+    void UpdateObserver() override { mChanges = AllChanges; }
+    void UpdateObserverChanges(int changes) override { mChanges = changes; }
+
+    int mChanges = 0;
+};
+
 TEST(PictureObserverTest, Construct) {
     PictureObserverMock observer;
 }
@@ -90,4 +101,29 @@ TEST(PictureObserverTest, DestroyedObservers)
     picture->UpdateObservers();
 
     ASSERT_TRUE(observer1.mUpdated);
-}
\ No newline at end of file
+}
+
+TEST(PictureObserverTest, Changes)
+{
+    auto picture = std::make_shared<Picture>();
+
+    PictureObserverChangesMock observer;
+    observer.SetPicture(picture);
+
+    // No argument means everything may have changed
+    picture->UpdateObservers();
+    ASSERT_EQ(PictureObserver::AllChanges, observer.mChanges);
+
+    picture->UpdateObservers(PictureObserver::Scene);
+    ASSERT_EQ(PictureObserver::Scene, observer.mChanges);
+
+    // Setting the animation time is a time change
+    picture->SetAnimationTime(1.0);
+    ASSERT_EQ(PictureObserver::Time, observer.mChanges);
+
+    // Observers that only override UpdateObserver() are still told
+    PictureObserverMock simple;
+    simple.SetPicture(picture);
+    picture->UpdateObservers(PictureObserver::TimelineProperties);
+    ASSERT_TRUE(simple.mUpdated);
+}
@@ -7,6 +7,8 @@
 #include "gtest/gtest.h"
 #include <Picture.h>
 #include <Actor.h>
+#include <MachineAdapter.h>
+#include <wx/filename.h>
 
 using namespace std;
 
@@ -80,4 +82,42 @@ TEST(PictureTest, GetTimeline)
 
     Timeline *timeline = picture.GetTimeline();
     ASSERT_NE(nullptr, timeline);
-}
\ No newline at end of file
+}
+
+TEST(PictureTest, Machines)
+{
+    Picture picture;
+    ASSERT_TRUE(picture.GetMachines().empty());
+
+    // More machines than the original two
+    for (int i = 0; i < 3; i++)
+    {
+        auto machine = make_shared<MachineAdapter>(L"Machine", L".");
+        machine->SetMachineNumber(i % 2 + 1);
+        machine->SetFrameOffset(10 * i + 5);
+        picture.AddMachine(machine);
+    }
+
+    ASSERT_EQ(3u, picture.GetMachines().size());
+
+    auto filename = wxFileName::CreateTempFileName(L"anim");
+    picture.Save(filename);
+
+    // Each machine gets its own settings back
+    Picture loaded;
+    for (int i = 0; i < 3; i++)
+    {
+        loaded.AddMachine(make_shared<MachineAdapter>(L"Machine", L"."));
+    }
+
+    loaded.Load(filename);
+    wxRemoveFile(filename);
+
+    auto &machines = loaded.GetMachines();
+    ASSERT_EQ(1, machines[0]->GetMachineNumber());
+    ASSERT_EQ(2, machines[1]->GetMachineNumber());
+    ASSERT_EQ(1, machines[2]->GetMachineNumber());
+    ASSERT_NEAR(5, machines[0]->GetFrameOffset(), 0.001);
+    ASSERT_NEAR(15, machines[1]->GetFrameOffset(), 0.001);
+    ASSERT_NEAR(25, machines[2]->GetFrameOffset(), 0.001);
+}
@@ -0,0 +1,124 @@
+/**
+ * @file RenderListTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+
+#include <render-list.h>
+#include <sstream>
+
+TEST(RenderListTest, PathContains)
+{
+    RenderList::Path path;
+    ASSERT_TRUE(path.IsEmpty());
+
+    path.MoveToPoint(0, 0);
+    path.AddLineToPoint(100, 0);
+    path.AddLineToPoint(100, 50);
+    path.AddLineToPoint(0, 50);
+    path.CloseSubpath();
+    ASSERT_FALSE(path.IsEmpty());
+
+    ASSERT_TRUE(path.Contains(10, 10));
+    ASSERT_TRUE(path.Contains(99, 49));
+    ASSERT_FALSE(path.Contains(-1, 10));
+    ASSERT_FALSE(path.Contains(50, 60));
+
+    ASSERT_EQ(L" M 0 0 L 100 0 L 100 50 L 0 50 Z", path.Describe());
+}
+
+TEST(RenderListTest, Describe)
+{
+    auto path = std::make_shared<RenderList::Path>();
+    path->MoveToPoint(0, 0);
+    path->AddLineToPoint(10, 0);
+    path->CloseSubpath();
+
+    RenderList list;
+    list.PushState();
+    list.Translate(10, 20);
+    list.SetPen(*wxTRANSPARENT_PEN);
+    list.SetBrush(wxBrush(wxColour(255, 0, 0)));
+    list.FillPath(path);
+    list.DrawText(L"Score", 5, 6);
+    list.PopState();
+
+    ASSERT_EQ(7u, list.GetSize());
+    ASSERT_EQ(L"translate 10 20", list.Describe(1));
+    ASSERT_EQ(L"pen none", list.Describe(2));
+    ASSERT_EQ(L"fill M 0 0 L 10 0 Z", list.Describe(4));
+    ASSERT_EQ(L"text 5 6 0 \"Score\"", list.Describe(5));
+
+    std::wstringstream str;
+    list.Save(str);
+    ASSERT_EQ(L"push\ntranslate 10 20\n", str.str().substr(0, 21));
+
+    list.Clear();
+    ASSERT_EQ(0u, list.GetSize());
+}
+
+TEST(RenderListTest, FirstDifference)
+{
+    RenderList a;
+    RenderList b;
+    ASSERT_EQ(-1, a.FirstDifference(b));
+
+    a.Translate(1, 2);
+    a.DrawRectangle(0, 0, 10, 10);
+    b.Translate(1, 2);
+    b.DrawRectangle(0, 0, 10, 11);
+    ASSERT_EQ(1, a.FirstDifference(b));
+
+    b.Clear();
+    b.Translate(1, 2);
+    ASSERT_EQ(1, a.FirstDifference(b));
+
+    b.DrawRectangle(0, 0, 10, 10);
+    ASSERT_EQ(-1, a.FirstDifference(b));
+}
+
+TEST(RenderListTest, Replay)
+{
+    RenderList list;
+    list.SetPen(*wxTRANSPARENT_PEN);
+    list.SetBrush(wxBrush(wxColour(0, 0, 255)));
+    list.DrawRectangle(0, 0, 10, 10);
+
+    int called = 0;
+    list.AddCallback([&called](std::shared_ptr<wxGraphicsContext>) { called++; });
+
+    // The same list replays into any number of contexts
+    for(int i = 0; i < 2; i++)
+    {
+        wxImage image(20, 20);
+        image.SetRGB(wxRect(0, 0, 20, 20), 255, 255, 255);
+        {
+            auto graphics = std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create(image));
+            list.Replay(graphics);
+        }
+
+        ASSERT_EQ(255, image.GetBlue(5, 5));
+        ASSERT_EQ(0, image.GetRed(5, 5));
+        ASSERT_EQ(255, image.GetRed(15, 15));
+    }
+
+    ASSERT_EQ(2, called);
+}
+
+TEST(RenderListTest, CountUnrenderable)
+{
+    RenderList list;
+    list.DrawRectangle(0, 0, 10, 10);
+    ASSERT_EQ(0u, list.CountUnrenderable());
+
+    // A software renderer can draw neither a callback nor a bitmap with no pixels
+    list.AddCallback([](std::shared_ptr<wxGraphicsContext>) {});
+    list.DrawBitmap(L"bitmap", [](std::shared_ptr<wxGraphicsContext>) { return wxGraphicsBitmap(); }, 0, 0, 10, 10);
+    ASSERT_EQ(2u, list.CountUnrenderable());
+
+    list.DrawBitmap(L"image", [](std::shared_ptr<wxGraphicsContext>) { return wxGraphicsBitmap(); },
+            [](double) { return std::shared_ptr<const RenderImage>(); }, 0, 0, 10, 10);
+    ASSERT_EQ(2u, list.CountUnrenderable());
+}
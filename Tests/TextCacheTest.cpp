@@ -0,0 +1,98 @@
+/**
+ * @file TextCacheTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+
+#include <text-cache.h>
+
+TEST(TextCacheTest, Find)
+{
+    TextCache cache;
+    wxFont font(wxSize(0, 15), wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+
+    auto run = cache.Find(font, L"12", *wxRED);
+    ASSERT_NE(nullptr, run);
+    ASSERT_GT(run->mWidth, 0);
+    ASSERT_GT(run->mHeight, 0);
+    ASSERT_TRUE(run->mImage.HasAlpha());
+
+    // Every pixel is the text colour, with the glyphs in the alpha
+    int covered = 0;
+    for (int y = 0; y < run->mImage.GetHeight(); y++)
+    {
+        for (int x = 0; x < run->mImage.GetWidth(); x++)
+        {
+            ASSERT_EQ(255, run->mImage.GetRed(x, y));
+            ASSERT_EQ(0, run->mImage.GetGreen(x, y));
+            covered += run->mImage.GetAlpha(x, y) > 0 ? 1 : 0;
+        }
+    }
+
+    ASSERT_GT(covered, 0);
+
+    // The same text is the same run
+    ASSERT_EQ(run, cache.Find(font, L"12", *wxRED));
+    ASSERT_EQ(1u, cache.GetCount());
+
+    // A different colour or scale is another run
+    ASSERT_NE(run, cache.Find(font, L"12", *wxBLUE));
+    auto doubled = cache.Find(font, L"12", *wxRED, 2);
+    ASSERT_NE(run, doubled);
+    ASSERT_EQ(3u, cache.GetCount());
+
+    // A larger scale has more pixels for the same size in user units
+    ASSERT_GT(doubled->mImage.GetWidth(), run->mImage.GetWidth());
+    ASSERT_NEAR(run->mWidth, doubled->mWidth, 1);
+
+    cache.Clear();
+    ASSERT_EQ(0u, cache.GetCount());
+}
+
+TEST(TextCacheTest, Evict)
+{
+    TextCache cache(2);
+    wxFont font(wxSize(0, 15), wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+
+    auto a = cache.Find(font, L"A", *wxBLACK);
+    auto b = cache.Find(font, L"B", *wxBLACK);
+
+    // Using A makes B the least recently used
+    ASSERT_EQ(a, cache.Find(font, L"A", *wxBLACK));
+    cache.Find(font, L"C", *wxBLACK);
+    ASSERT_EQ(2u, cache.GetCount());
+    ASSERT_EQ(a, cache.Find(font, L"A", *wxBLACK));
+    ASSERT_NE(b, cache.Find(font, L"B", *wxBLACK));
+
+    cache.SetCapacity(1);
+    ASSERT_EQ(1u, cache.GetCount());
+}
+
+TEST(TextCacheTest, Draw)
+{
+    wxImage image(60, 30);
+    image.SetRGB(wxRect(0, 0, 60, 30), 255, 255, 255);
+    wxFont font(wxSize(0, 15), wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    {
+        auto graphics = std::shared_ptr<wxGraphicsContext>(wxGraphicsContext::Create(image));
+        TextCache::Shared().Draw(graphics, font, L"88", *wxBLACK, 10, 5);
+    }
+
+    // The text darkens pixels to the right of its left edge only
+    int dark = 0;
+    for (int y = 0; y < 30; y++)
+    {
+        for (int x = 0; x < 60; x++)
+        {
+            if (image.GetRed(x, y) < 128)
+            {
+                ASSERT_GE(x, 9);
+                dark++;
+            }
+        }
+    }
+
+    ASSERT_GT(dark, 0);
+}
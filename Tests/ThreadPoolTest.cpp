@@ -0,0 +1,47 @@
+/**
+ * @file ThreadPoolTest.cpp
+ * @author Thomas Toaz
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <ThreadPool.h>
+
+TEST(ThreadPoolTest, RunAll)
+{
+    ThreadPool pool(3);
+
+    std::atomic<int> count{0};
+    std::vector<std::function<void()>> tasks;
+    for (int i = 0; i < 10; i++)
+    {
+        tasks.push_back([&count] { count++; });
+    }
+
+    // Every task has run when RunAll returns
+    pool.RunAll(tasks);
+    ASSERT_EQ(10, count);
+
+    pool.RunAll(tasks);
+    ASSERT_EQ(20, count);
+
+    // Nothing to do
+    pool.RunAll({});
+    ASSERT_EQ(20, count);
+}
+
+TEST(ThreadPoolTest, Submit)
+{
+    ThreadPool pool(2);
+
+    int value = 0;
+    auto future = pool.Submit([&value] { value = 123; });
+    future.get();
+    ASSERT_EQ(123, value);
+
+    // Exceptions are passed to the caller
+    auto failed = pool.Submit([] { throw std::runtime_error("failed"); });
+    ASSERT_THROW(failed.get(), std::runtime_error);
+}
@@ -83,4 +83,69 @@ TEST(TimelineTest, Add)
 
     timeline.AddChannel(&channel);
     ASSERT_EQ(&timeline, channel.GetTimeline());
-}
\ No newline at end of file
+}
+
+TEST(TimelineTest, ChannelIds)
+{
+    Timeline timeline;
+    AnimChannelAngle channel1;
+    channel1.SetName(L"Actor:One");
+    AnimChannelAngle channel2;
+    channel2.SetName(L"Actor:Two");
+
+    int id1 = timeline.AddChannel(&channel1);
+    int id2 = timeline.AddChannel(&channel2);
+    ASSERT_NE(id1, id2);
+
+    ASSERT_EQ(id1, timeline.GetChannelId(L"Actor:One"));
+    ASSERT_EQ(id2, timeline.GetChannelId(L"Actor:Two"));
+    ASSERT_EQ(-1, timeline.GetChannelId(L"Actor:Three"));
+
+    ASSERT_EQ(&channel1, timeline.GetChannel(id1));
+    ASSERT_EQ(&channel2, timeline.GetChannel(L"Actor:Two"));
+    ASSERT_EQ(nullptr, timeline.GetChannel(L"Actor:Three"));
+
+    // Adding the same channel again changes nothing
+    ASSERT_EQ(id1, timeline.AddChannel(&channel1));
+}
+
+TEST(TimelineTest, DuplicateChannelNames)
+{
+    Timeline timeline;
+    AnimChannelAngle channel1;
+    channel1.SetName(L"Machine:position");
+    AnimChannelAngle channel2;
+    channel2.SetName(L"Machine:position");
+
+    timeline.AddChannel(&channel1);
+    timeline.AddChannel(&channel2);
+
+    // The second channel is renamed so both can be found
+    ASSERT_EQ(std::wstring(L"Machine:position"), channel1.GetName());
+    ASSERT_NE(channel1.GetName(), channel2.GetName());
+    ASSERT_EQ(&channel1, timeline.GetChannel(channel1.GetName()));
+    ASSERT_EQ(&channel2, timeline.GetChannel(channel2.GetName()));
+}
+
+TEST(TimelineTest, RemoveChannel)
+{
+    Timeline timeline;
+    AnimChannelAngle channel1;
+    channel1.SetName(L"Actor:One");
+    AnimChannelAngle channel2;
+    channel2.SetName(L"Actor:Two");
+
+    int id1 = timeline.AddChannel(&channel1);
+    int id2 = timeline.AddChannel(&channel2);
+
+    timeline.RemoveChannel(&channel1);
+    ASSERT_EQ(nullptr, channel1.GetTimeline());
+    ASSERT_EQ(nullptr, timeline.GetChannel(id1));
+    ASSERT_EQ(-1, timeline.GetChannelId(L"Actor:One"));
+
+    // Ids of the remaining channels are stable
+    ASSERT_EQ(&channel2, timeline.GetChannel(id2));
+
+    // Setting the time must skip the removed channel
+    timeline.SetCurrentTime(1.5);
+}